@@ -0,0 +1,664 @@
+// archive.h
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "arena.h"
+#include "batch.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+// 끝난 게임의 열 지향 기록 보관소 (덧붙이기 전용)
+// 스레드마다 게임을 묶음 단위로 모아 블록 하나로 기록: 헤더 + 열(열마다 게임 수만큼의 바이트)
+// 좌석별 값(배정, 사망 날짜)은 4비트씩 두 좌석을 한 바이트에 넣고 좌석 쌍마다 열 하나로 둠
+// 블록은 스스로 길이를 가지므로 파일을 이어 붙여도(cat) 그대로 하나의 보관소가 됨
+
+const int ARCHIVE_MAX_SEATS = 8;
+const uint8_t ARCHIVE_NO_SEAT = 0xFF;
+const uint32_t ARCHIVE_MAGIC = 0x5241504E; // "NPAR"
+const uint16_t ARCHIVE_FORMAT = 1;
+
+enum ArchiveColumn
+{ // 블록 안 열 순서
+    ARCHIVE_DEAL,                       // 좌석 2s, 2s+1의 직업 번호 (하위/상위 4비트), 4열
+    ARCHIVE_DEATH = ARCHIVE_DEAL + 4,   // 좌석 2s, 2s+1의 사망 날짜 (0 생존, 15는 15일 이후), 4열
+    ARCHIVE_EXECUTED = ARCHIVE_DEATH + 4, // 처형된 좌석 비트
+    ARCHIVE_TAMED_DAY,                  // 늑대인간 접선 날짜 (0 접선 없음)
+    ARCHIVE_FIRST_TARGET,               // 첫날 밤 마피아의 대상 좌석 (ARCHIVE_NO_SEAT 없음)
+    ARCHIVE_WINNER,                     // 0 무승부, 1 시민, 2 마피아
+    ARCHIVE_DAYS,                       // 진행 일수 (255에서 포화)
+    ARCHIVE_COLUMN_COUNT
+};
+
+struct ArchiveBlockHeader
+{ // 32바이트, 본문은 열마다 32바이트 경계까지 0으로 채움 (SIMD 검색이 끝까지 통째로 읽도록)
+    uint32_t magic;
+    uint16_t format;
+    uint8_t players;     // 블록 안 게임의 인원 (조회 시 블록 단위로 건너뜀)
+    uint8_t reserved;
+    uint32_t count;      // 게임 수
+    uint32_t bodyBytes;  // ARCHIVE_COLUMN_COUNT * stride
+    uint64_t seed;       // 시뮬레이션 시드
+    uint64_t writtenNs;  // 기록 시각 (system_clock, epoch 이후 나노초)
+};
+static_assert(sizeof(ArchiveBlockHeader) == 32, "ArchiveBlockHeader must stay 32 bytes");
+
+inline size_t archiveStride(size_t count) { return (count + 31) & ~static_cast<size_t>(31); }
+
+struct ArchiveRecord
+{ // 진행 중인 게임의 요약 (규칙 함수가 채움)
+    uint8_t players;
+    uint8_t roles[ARCHIVE_MAX_SEATS];     // createRole 번호
+    uint8_t deathDay[ARCHIVE_MAX_SEATS];  // 0 생존
+    uint8_t executed;
+    uint8_t tamedDay;
+    uint8_t firstTarget;
+    uint8_t winner;
+    uint8_t days;
+
+    void begin(int playerCount)
+    {
+        memset(this, 0, sizeof(*this));
+        players = static_cast<uint8_t>(playerCount);
+        firstTarget = ARCHIVE_NO_SEAT;
+    }
+
+    void noteDeath(uint8_t seat, int day, bool execution)
+    {
+        if (seat >= ARCHIVE_MAX_SEATS) return;
+        deathDay[seat] = static_cast<uint8_t>(min(day, 15));
+        if (execution) executed |= static_cast<uint8_t>(1u << seat);
+    }
+};
+
+thread_local ArchiveRecord archiveDraft;
+
+class ArchiveBuffer
+{ // 스레드별 미기록 게임 (열 단위로 쌓음)
+public:
+    static const size_t BLOCK_GAMES = 1 << 16;
+
+    vector<uint8_t> columns[ARCHIVE_COLUMN_COUNT];
+    size_t count = 0;
+    uint8_t players = 0;
+
+    void append(const ArchiveRecord& r)
+    {
+        if (columns[0].empty()) {
+            ArenaBypass bypass; // 게임 아레나 밖에서 한 번만 확보
+            for (auto& column : columns) column.resize(archiveStride(BLOCK_GAMES));
+        }
+        players = r.players;
+        for (int pair = 0; pair < ARCHIVE_MAX_SEATS / 2; pair++) {
+            columns[ARCHIVE_DEAL + pair][count] = static_cast<uint8_t>(r.roles[2 * pair] | r.roles[2 * pair + 1] << 4);
+            columns[ARCHIVE_DEATH + pair][count] = static_cast<uint8_t>(r.deathDay[2 * pair] | r.deathDay[2 * pair + 1] << 4);
+        }
+        columns[ARCHIVE_EXECUTED][count] = r.executed;
+        columns[ARCHIVE_TAMED_DAY][count] = r.tamedDay;
+        columns[ARCHIVE_FIRST_TARGET][count] = r.firstTarget;
+        columns[ARCHIVE_WINNER][count] = r.winner;
+        columns[ARCHIVE_DAYS][count] = r.days;
+        count++;
+    }
+
+    bool full() const { return count == BLOCK_GAMES; }
+};
+
+thread_local ArchiveBuffer archiveBuffer;
+
+class GameArchive
+{
+private:
+    atomic<bool> enabled;
+    mutex writeMutex;
+    FILE* file;
+    uint64_t seed;
+    uint64_t gamesWritten;
+    uint64_t blocksWritten;
+    uint64_t bytesWritten;
+
+public:
+    GameArchive() : enabled(false), file(nullptr), seed(0), gamesWritten(0), blocksWritten(0), bytesWritten(0) {}
+    ~GameArchive() { stop(); }
+
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+
+    bool start(const string& path, uint64_t runSeed)
+    { // 기존 보관소 뒤에 이어 씀
+        if (file) return true;
+        file = fopen(path.c_str(), "ab");
+        if (!file) return false;
+        seed = runSeed;
+        enabled.store(true, memory_order_release);
+        return true;
+    }
+
+    void stop()
+    {
+        if (!file) return;
+        enabled.store(false, memory_order_release);
+        fclose(file);
+        file = nullptr;
+    }
+
+    void write(ArchiveBuffer& buffer)
+    { // 블록 하나를 한 번의 fwrite로 기록하고 버퍼를 비움
+        if (buffer.count == 0) return;
+        size_t stride = archiveStride(buffer.count);
+        ArchiveBlockHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = ARCHIVE_MAGIC;
+        header.format = ARCHIVE_FORMAT;
+        header.players = buffer.players;
+        header.count = static_cast<uint32_t>(buffer.count);
+        header.bodyBytes = static_cast<uint32_t>(ARCHIVE_COLUMN_COUNT * stride);
+        header.seed = seed;
+        header.writtenNs = static_cast<uint64_t>(
+            duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count());
+
+        vector<uint8_t> block;
+        {
+            ArenaBypass bypass;
+            block.assign(sizeof(header) + header.bodyBytes, 0);
+        }
+        memcpy(block.data(), &header, sizeof(header));
+        for (int c = 0; c < ARCHIVE_COLUMN_COUNT; c++) {
+            memcpy(block.data() + sizeof(header) + c * stride, buffer.columns[c].data(), buffer.count);
+        }
+
+        lock_guard<mutex> lock(writeMutex);
+        if (file) {
+            fwrite(block.data(), 1, block.size(), file);
+            gamesWritten += buffer.count;
+            blocksWritten++;
+            bytesWritten += block.size();
+        }
+        buffer.count = 0;
+    }
+
+    void printSummary(ostream& out) const
+    {
+        out << "기록 보관: " << gamesWritten << "게임, " << blocksWritten << "블록, " << bytesWritten
+            << "바이트 (게임당 " << fixed << setprecision(1)
+            << (gamesWritten ? static_cast<double>(bytesWritten) / gamesWritten : 0.0) << "바이트)\n";
+        out.unsetf(ios::fixed);
+    }
+};
+
+GameArchive gameArchive;
+
+void archiveGameFinished(uint8_t winner, int days)
+{ // 끝난 게임을 스레드 버퍼에 넣고 블록이 차면 기록
+    archiveDraft.winner = winner;
+    archiveDraft.days = static_cast<uint8_t>(min(days, 255));
+    if (archiveBuffer.count && archiveBuffer.players != archiveDraft.players) gameArchive.write(archiveBuffer);
+    archiveBuffer.append(archiveDraft);
+    if (archiveBuffer.full()) gameArchive.write(archiveBuffer);
+}
+
+void flushArchiveBuffer()
+{ // 작업 스레드가 끝나기 전에 남은 게임 기록
+    if (gameArchive.isEnabled()) gameArchive.write(archiveBuffer);
+}
+
+// 조회: 보관소를 메모리 매핑하고 블록마다 게임 축 SIMD로 조건 검사와 집계를 한꺼번에 수행
+
+enum ArchiveGrouping
+{
+    GROUP_NONE,          // 전체 (단위: 게임)
+    GROUP_ROLE,          // 직업별 (단위: 좌석)
+    GROUP_SEAT,          // 좌석별 (단위: 좌석)
+    GROUP_FIRST_TARGET   // 첫날 밤 마피아 대상의 직업별 (단위: 게임)
+};
+
+enum ArchiveStat
+{ // 그룹마다 세는 값
+    STAT_UNITS,
+    STAT_CITIZEN_WINS,
+    STAT_MAFIA_WINS,
+    STAT_TEAM_WINS,   // 좌석 단위: 그 좌석의 팀이 승리
+    STAT_FLAG,        // 전체: 접선, 직업/좌석: 생존, 첫날 대상: 첫날 밤 사망
+    STAT_COUNT
+};
+
+const int ARCHIVE_MAX_GROUPS = ROLE_TYPE_COUNT + 2; // 직업 + 대상 없음, 좌석 8개
+
+struct ArchiveQuery
+{
+    int players = 0;     // 0이면 전체
+    int winner = -1;     // -1이면 전체
+    int tamed = -1;      // -1 전체, 0 접선 없음, 1 접선
+    int minDays = 0;
+    int maxDays = 255;
+    ArchiveGrouping grouping = GROUP_NONE;
+};
+
+struct ArchiveTotals
+{
+    uint64_t scanned = 0;  // 인원 조건을 통과한 블록의 게임 수
+    uint64_t matched = 0;  // 모든 조건을 만족한 게임 수
+    uint64_t stats[ARCHIVE_MAX_GROUPS][STAT_COUNT] = {};
+};
+
+struct ArchiveBlockView
+{
+    const uint8_t* columns[ARCHIVE_COLUMN_COUNT];
+    size_t count;
+    int players;
+};
+
+int archiveGroupCount(ArchiveGrouping grouping)
+{
+    switch (grouping) {
+    case GROUP_ROLE: return ROLE_TYPE_COUNT;
+    case GROUP_SEAT: return ARCHIVE_MAX_SEATS;
+    case GROUP_FIRST_TARGET: return ROLE_TYPE_COUNT + 1;
+    default: return 1;
+    }
+}
+
+namespace archivekernel
+{
+    // 레인 값은 batchkernel처럼 참조로 넘김 (벡터를 반환하는 함수는 AVX2 밖에서 호출 규약 경고가 남)
+    template <typename V>
+    NAPOLY_LANE_INLINE void load(V& out, const uint8_t* column, size_t lane)
+    {
+        memcpy(&out, column + lane, sizeof(V));
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void notZero(V& out, const V& x) { out = ~(V)(x == V()); }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE uint64_t sum(const V& x)
+    { // 바이트 레인 합
+        uint8_t lanes[sizeof(V)];
+        memcpy(lanes, &x, sizeof(V));
+        uint64_t total = 0;
+        for (size_t i = 0; i < sizeof(V); i++) total += lanes[i];
+        return total;
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void flush(V (&acc)[ARCHIVE_MAX_GROUPS][STAT_COUNT], int groups, ArchiveTotals& totals)
+    { // 바이트 누산기를 64비트 합계로 옮기고 비움
+        for (int g = 0; g < groups; g++) {
+            for (int s = 0; s < STAT_COUNT; s++) {
+                totals.stats[g][s] += sum(acc[g][s]);
+                acc[g][s] = V();
+            }
+        }
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void count(V (&acc)[STAT_COUNT], const V& sel, const V& citizen, const V& mafia, const V& team, const V& flag)
+    { // 선택된 레인(0xFF)마다 1씩: 0xFF를 빼면 1을 더한 것과 같음
+        acc[STAT_UNITS] = acc[STAT_UNITS] - sel;
+        acc[STAT_CITIZEN_WINS] = acc[STAT_CITIZEN_WINS] - (sel & citizen);
+        acc[STAT_MAFIA_WINS] = acc[STAT_MAFIA_WINS] - (sel & mafia);
+        acc[STAT_TEAM_WINS] = acc[STAT_TEAM_WINS] - (sel & team);
+        acc[STAT_FLAG] = acc[STAT_FLAG] - (sel & flag);
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void scan(const ArchiveBlockView& block, const ArchiveQuery& query, ArchiveTotals& totals)
+    {
+        // 바이트 누산기는 반복마다 그룹당 최대 좌석 수(8)만큼 늘어나므로 31회마다 비움 (31 * 8 < 256)
+        const int FLUSH_EVERY = 31;
+        const size_t WIDTH = sizeof(V);
+        const int groups = archiveGroupCount(query.grouping);
+        const V zero = V();
+        const V ones = ~zero;
+        V one, two, lowNibble, mafiaRole, werewolfRole, noTarget, winnerKey, minDays, maxDays;
+        broadcast(one, 1);
+        broadcast(two, 2);
+        broadcast(lowNibble, 0x0F);
+        broadcast(mafiaRole, ROLE_MAFIA);
+        broadcast(werewolfRole, ROLE_WEREWOLF);
+        broadcast(noTarget, ROLE_TYPE_COUNT);
+        broadcast(winnerKey, static_cast<uint8_t>(max(query.winner, 0)));
+        broadcast(minDays, static_cast<uint8_t>(query.minDays));
+        broadcast(maxDays, static_cast<uint8_t>(query.maxDays));
+
+        uint8_t iotaBytes[sizeof(V)];
+        for (size_t i = 0; i < WIDTH; i++) iotaBytes[i] = static_cast<uint8_t>(i);
+        V iota;
+        memcpy(&iota, iotaBytes, sizeof(V));
+
+        V acc[ARCHIVE_MAX_GROUPS][STAT_COUNT];
+        for (auto& group : acc) for (auto& a : group) a = zero;
+        V matched = zero;
+
+        int pending = 0;
+        for (size_t lane = 0; lane < block.count; lane += WIDTH) {
+            V winner;
+            load(winner, block.columns[ARCHIVE_WINNER], lane);
+            V tamedDay;
+            load(tamedDay, block.columns[ARCHIVE_TAMED_DAY], lane);
+            V days;
+            load(days, block.columns[ARCHIVE_DAYS], lane);
+
+            V mask = ones;
+            size_t remaining = block.count - lane;
+            if (remaining < WIDTH) {
+                V filled;
+                broadcast(filled, static_cast<uint8_t>(remaining));
+                mask = (V)(filled > iota);
+            }
+            if (query.winner >= 0) mask = mask & (V)(winner == winnerKey);
+            V tamed;
+            notZero(tamed, tamedDay);
+            if (query.tamed == 1) mask = mask & tamed;
+            else if (query.tamed == 0) mask = mask & ~tamed;
+            if (query.minDays > 0) mask = mask & ~(V)(minDays > days);
+            if (query.maxDays < 255) mask = mask & ~(V)(days > maxDays);
+
+            V citizen = (V)(winner == one);
+            V mafia = (V)(winner == two);
+            matched = matched - mask;
+
+            if (query.grouping == GROUP_NONE) {
+                count(acc[0], mask, citizen, mafia, zero, tamed);
+            }
+            else if (query.grouping == GROUP_FIRST_TARGET) {
+                V target;
+                load(target, block.columns[ARCHIVE_FIRST_TARGET], lane);
+                V executed;
+                load(executed, block.columns[ARCHIVE_EXECUTED], lane);
+                V targetRole = noTarget, killed = zero, seatKey, seatBit;
+                for (int seat = 0; seat < block.players; seat++) {
+                    V deal;
+                    load(deal, block.columns[ARCHIVE_DEAL + seat / 2], lane);
+                    V death;
+                    load(death, block.columns[ARCHIVE_DEATH + seat / 2], lane);
+                    V role = (seat & 1) ? deal >> 4 : deal & lowNibble;
+                    V day = (seat & 1) ? death >> 4 : death & lowNibble;
+                    broadcast(seatKey, static_cast<uint8_t>(seat));
+                    broadcast(seatBit, static_cast<uint8_t>(1u << seat));
+                    V isTarget = (V)(target == seatKey);
+                    V wasExecuted;
+                    notZero(wasExecuted, (V)(executed & seatBit));
+                    targetRole = (targetRole & ~isTarget) | (role & isTarget);
+                    killed = killed | (isTarget & (V)(day == one) & ~wasExecuted);
+                }
+                for (int g = 0; g < groups; g++) {
+                    V key;
+                    broadcast(key, static_cast<uint8_t>(g));
+                    V sel = mask & (V)(targetRole == key);
+                    count(acc[g], sel, citizen, mafia, zero, killed);
+                }
+            }
+            else {
+                V roles[ARCHIVE_MAX_SEATS], won[ARCHIVE_MAX_SEATS], alive[ARCHIVE_MAX_SEATS];
+                for (int seat = 0; seat < block.players; seat++) {
+                    V deal;
+                    load(deal, block.columns[ARCHIVE_DEAL + seat / 2], lane);
+                    V death;
+                    load(death, block.columns[ARCHIVE_DEATH + seat / 2], lane);
+                    V role = (seat & 1) ? deal >> 4 : deal & lowNibble;
+                    V day = (seat & 1) ? death >> 4 : death & lowNibble;
+                    // 마피아와 접선한 늑대인간은 마피아 팀
+                    V mafiaTeam = (V)(role == mafiaRole) | ((V)(role == werewolfRole) & tamed);
+                    roles[seat] = role;
+                    won[seat] = (mafiaTeam & mafia) | (~mafiaTeam & citizen);
+                    alive[seat] = (V)(day == zero);
+                }
+                if (query.grouping == GROUP_SEAT) {
+                    for (int seat = 0; seat < block.players; seat++) {
+                        count(acc[seat], mask, citizen, mafia, won[seat], alive[seat]);
+                    }
+                }
+                else {
+                    // 직업마다 좌석을 돌며 레지스터에 모은 뒤 한 번만 누산기에 더함
+                    for (int g = 0; g < groups; g++) {
+                        V key;
+                        broadcast(key, static_cast<uint8_t>(g));
+                        V units = zero, teamWins = zero, survived = zero;
+                        for (int seat = 0; seat < block.players; seat++) {
+                            V sel = mask & (V)(roles[seat] == key);
+                            units = units - sel;
+                            teamWins = teamWins - (sel & won[seat]);
+                            survived = survived - (sel & alive[seat]);
+                        }
+                        acc[g][STAT_UNITS] = acc[g][STAT_UNITS] + units;
+                        acc[g][STAT_TEAM_WINS] = acc[g][STAT_TEAM_WINS] + teamWins;
+                        acc[g][STAT_FLAG] = acc[g][STAT_FLAG] + survived;
+                    }
+                }
+            }
+
+            if (++pending == FLUSH_EVERY) {
+                flush(acc, groups, totals);
+                totals.matched += sum(matched);
+                matched = zero;
+                pending = 0;
+            }
+        }
+        flush(acc, groups, totals);
+        totals.matched += sum(matched);
+        totals.scanned += block.count;
+    }
+
+#ifdef NAPOLY_BATCH_VECTOR
+#ifdef NAPOLY_RNG_AVX2
+    __attribute__((target("avx2"))) void scanAvx2(const ArchiveBlockView& b, const ArchiveQuery& q, ArchiveTotals& t) { scan<Lane32>(b, q, t); }
+#endif
+    void scanSse(const ArchiveBlockView& b, const ArchiveQuery& q, ArchiveTotals& t) { scan<Lane16>(b, q, t); }
+#endif
+
+    void runScan(const ArchiveBlockView& block, const ArchiveQuery& query, ArchiveTotals& totals, bool simd)
+    {
+        if (!simd) { scan<ScalarLane>(block, query, totals); return; }
+#ifdef NAPOLY_BATCH_VECTOR
+#ifdef NAPOLY_RNG_AVX2
+        if (batchkernel::useAvx2()) { scanAvx2(block, query, totals); return; }
+#endif
+        scanSse(block, query, totals);
+#else
+        scan<ScalarLane>(block, query, totals);
+#endif
+    }
+}
+
+class ArchiveMapping
+{ // 보관소 파일 전체를 읽기 전용으로 매핑 (매핑이 없는 환경에서는 통째로 읽음)
+private:
+    const uint8_t* base = nullptr;
+    size_t length = 0;
+    vector<uint8_t> fallback;
+
+public:
+    ArchiveMapping() = default;
+    ArchiveMapping(const ArchiveMapping&) = delete;
+    ArchiveMapping& operator=(const ArchiveMapping&) = delete;
+
+    ~ArchiveMapping()
+    {
+#ifndef _WIN32
+        if (base && fallback.empty()) munmap(const_cast<uint8_t*>(base), length);
+#endif
+    }
+
+    bool open(const string& path)
+    {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) { close(fd); return false; }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) { close(fd); return false; }
+            madvise(p, length, MADV_SEQUENTIAL);
+            base = static_cast<const uint8_t*>(p);
+        }
+        close(fd);
+        return true;
+#else
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return false;
+        fseek(in, 0, SEEK_END);
+        fallback.resize(static_cast<size_t>(ftell(in)));
+        fseek(in, 0, SEEK_SET);
+        length = fread(fallback.data(), 1, fallback.size(), in);
+        fclose(in);
+        base = fallback.data();
+        return true;
+#endif
+    }
+
+    const uint8_t* data() const { return base; }
+    size_t size() const { return length; }
+};
+
+template <typename Fn>
+size_t forEachArchiveBlock(const ArchiveMapping& mapping, Fn&& visit, bool& truncated)
+{ // 온전한 블록만 순서대로 전달, 잘렸거나 헤더가 맞지 않으면 그 앞에서 멈춤
+    const uint8_t* p = mapping.data();
+    const uint8_t* end = p + mapping.size();
+    size_t blocks = 0;
+    truncated = false;
+    while (p < end) {
+        ArchiveBlockHeader header;
+        if (static_cast<size_t>(end - p) < sizeof(header)) { truncated = true; break; }
+        memcpy(&header, p, sizeof(header));
+        size_t stride = archiveStride(header.count);
+        if (header.magic != ARCHIVE_MAGIC || header.format != ARCHIVE_FORMAT ||
+            header.bodyBytes != ARCHIVE_COLUMN_COUNT * stride || header.players > ARCHIVE_MAX_SEATS ||
+            static_cast<size_t>(end - p) - sizeof(header) < header.bodyBytes) {
+            truncated = true;
+            break;
+        }
+        ArchiveBlockView view;
+        const uint8_t* body = p + sizeof(header);
+        for (int c = 0; c < ARCHIVE_COLUMN_COUNT; c++) view.columns[c] = body + c * stride;
+        view.count = header.count;
+        view.players = header.players;
+        visit(view);
+        blocks++;
+        p = body + header.bodyBytes;
+    }
+    return blocks;
+}
+
+int runQueryCommand(int argc, char* argv[])
+{ // 사용법: napoly query 파일 [--players N] [--winner citizen|mafia|draw] [--tamed|--untamed] [--min-days N] [--max-days N] [--by role|seat|first-target] [--no-simd]
+    const char* usage = "사용법: napoly query 파일 [--players N] [--winner citizen|mafia|draw] [--tamed|--untamed] "
+        "[--min-days N] [--max-days N] [--by role|seat|first-target] [--no-simd]\n";
+    if (argc < 3) {
+        cout << usage;
+        return 1;
+    }
+    string path = argv[2];
+    ArchiveQuery query;
+    bool simd = true;
+    bool valid = true;
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--players" && i + 1 < argc) query.players = atoi(argv[++i]);
+        else if (arg == "--tamed") query.tamed = 1;
+        else if (arg == "--untamed") query.tamed = 0;
+        else if (arg == "--min-days" && i + 1 < argc) query.minDays = atoi(argv[++i]);
+        else if (arg == "--max-days" && i + 1 < argc) query.maxDays = atoi(argv[++i]);
+        else if (arg == "--no-simd") simd = false;
+        else if (arg == "--winner" && i + 1 < argc) {
+            string w = argv[++i];
+            if (w == "draw") query.winner = 0;
+            else if (w == "citizen") query.winner = 1;
+            else if (w == "mafia") query.winner = 2;
+            else valid = false;
+        }
+        else if (arg == "--by" && i + 1 < argc) {
+            string by = argv[++i];
+            if (by == "role") query.grouping = GROUP_ROLE;
+            else if (by == "seat") query.grouping = GROUP_SEAT;
+            else if (by == "first-target") query.grouping = GROUP_FIRST_TARGET;
+            else valid = false;
+        }
+        else valid = false;
+    }
+    query.minDays = max(0, min(query.minDays, 255));
+    query.maxDays = max(0, min(query.maxDays, 255));
+    if (!valid) {
+        cout << usage;
+        return 1;
+    }
+
+    ArchiveMapping mapping;
+    if (!mapping.open(path)) {
+        cout << "보관소 파일을 열 수 없습니다: " << path << "\n";
+        return 1;
+    }
+
+    auto begin = steady_clock::now();
+    ArchiveTotals totals;
+    uint64_t games = 0;
+    bool truncated = false;
+    size_t blocks = forEachArchiveBlock(mapping, [&](const ArchiveBlockView& block) {
+        games += block.count;
+        if (query.players && block.players != query.players) return; // 블록 단위로 건너뜀
+        archivekernel::runScan(block, query, totals, simd);
+        }, truncated);
+    double seconds = duration<double>(steady_clock::now() - begin).count();
+
+    cout << "=== 기록 조회: " << path << " (" << blocks << "블록, " << games << "게임, "
+        << fixed << setprecision(2) << mapping.size() / 1e9 << "GB) ===\n";
+    if (truncated) cout << "(마지막 블록이 잘려 이후는 무시함)\n";
+    cout << "해당 게임: " << totals.matched << " / " << totals.scanned << ", 검색 " << setprecision(3) << seconds
+        << "초 (" << setprecision(1) << games / max(seconds, 1e-9) / 1e6 << "M games/s, "
+        << (simd ? batchkernel::backendName() : "scalar") << ")\n";
+
+    auto rate = [](uint64_t part, uint64_t whole) { return whole ? 100.0 * part / whole : 0.0; };
+    const auto& s = totals.stats;
+    cout << setprecision(2);
+    switch (query.grouping) {
+    case GROUP_NONE:
+        cout << "시민 팀 승리 " << rate(s[0][STAT_CITIZEN_WINS], s[0][STAT_UNITS]) << "%, 마피아 팀 승리 "
+            << rate(s[0][STAT_MAFIA_WINS], s[0][STAT_UNITS]) << "%, 접선 " << rate(s[0][STAT_FLAG], s[0][STAT_UNITS]) << "%\n";
+        break;
+    case GROUP_ROLE:
+    case GROUP_SEAT:
+        cout << (query.grouping == GROUP_ROLE ? "직업" : "좌석") << "\t인원\t팀 승률\t생존율\n";
+        for (int g = 0; g < archiveGroupCount(query.grouping); g++) {
+            if (!s[g][STAT_UNITS]) continue;
+            if (query.grouping == GROUP_ROLE) cout << roleTypeName(g);
+            else cout << g + 1 << "번";
+            cout << "\t" << s[g][STAT_UNITS] << "\t" << rate(s[g][STAT_TEAM_WINS], s[g][STAT_UNITS]) << "%\t"
+                << rate(s[g][STAT_FLAG], s[g][STAT_UNITS]) << "%\n";
+        }
+        break;
+    case GROUP_FIRST_TARGET:
+        cout << "첫날 밤 대상\t게임\t시민 팀 승리\t마피아 팀 승리\t첫날 밤 사망\n";
+        for (int g = 0; g < archiveGroupCount(query.grouping); g++) {
+            if (!s[g][STAT_UNITS]) continue;
+            cout << (g < ROLE_TYPE_COUNT ? roleTypeName(g) : "없음") << "\t" << s[g][STAT_UNITS] << "\t"
+                << rate(s[g][STAT_CITIZEN_WINS], s[g][STAT_UNITS]) << "%\t"
+                << rate(s[g][STAT_MAFIA_WINS], s[g][STAT_UNITS]) << "%\t"
+                << rate(s[g][STAT_FLAG], s[g][STAT_UNITS]) << "%\n";
+        }
+        break;
+    }
+    cout.unsetf(ios::fixed);
+    return 0;
+}
+
+#endif // ARCHIVE_H
@@ -0,0 +1,282 @@
+// arena.h
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// 게임 한 판 동안의 모든 할당을 받는 아레나
+// 전역 operator new/delete를 교체하여 스레드에 활성 아레나가 있으면 거기서 잘라 주고,
+// 없으면 malloc으로 보냄. 아레나 해제는 개별 free 없이 커서를 처음으로 되돌리는 한 번의 리셋
+// (정렬 지정 new(align_val_t)는 교체하지 않으므로 항상 힙)
+
+class GameArena;
+
+struct alignas(16) AllocHeader
+{ // 모든 할당 앞에 붙는 16바이트 (delete 시 출처 판별용)
+    GameArena* owner; // nullptr이면 힙
+    size_t size;
+};
+
+struct AllocationStats
+{ // 스레드별 누적 할당 통계 (게임 전후 차이로 게임당 값을 구함)
+    uint64_t heapCalls = 0;   // malloc 호출 (operator new가 힙으로 간 횟수)
+    uint64_t heapBytes = 0;
+    uint64_t arenaCalls = 0;  // 아레나에서 잘라 준 횟수
+    uint64_t arenaBytes = 0;
+};
+
+thread_local AllocationStats allocationStats;
+thread_local GameArena* activeArena = nullptr;
+
+class GameArena
+{ // 고정 크기 청크를 이어 붙인 범프 할당기, 청크는 리셋 후에도 재사용
+private:
+    struct Chunk
+    {
+        Chunk* next;
+        size_t size; // 헤더를 제외한 데이터 크기
+    };
+
+    static const size_t CHUNK_SIZE = 16 * 1024;
+    static const size_t LARGE_SIZE = CHUNK_SIZE / 4; // 이보다 크면 전용 청크
+
+    Chunk* chunks = nullptr;  // 재사용되는 청크 목록
+    Chunk* current = nullptr;
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    Chunk* large = nullptr;   // 큰 할당용 청크 (리셋 시 반환)
+    size_t footprint = 0;     // 보유 중인 청크 바이트
+
+    static char* dataOf(Chunk* chunk) { return reinterpret_cast<char*>(chunk + 1); }
+
+    static Chunk* newChunk(size_t size)
+    {
+        Chunk* chunk = static_cast<Chunk*>(malloc(sizeof(Chunk) + size));
+        if (!chunk) throw bad_alloc();
+        chunk->next = nullptr;
+        chunk->size = size;
+        return chunk;
+    }
+
+    void enter(Chunk* chunk)
+    {
+        current = chunk;
+        cursor = dataOf(chunk);
+        limit = cursor + chunk->size;
+    }
+
+    char* refill(size_t bytes)
+    { // 현재 청크가 부족할 때: 다음 청크로 넘어가거나 새 청크 추가
+        if (bytes > LARGE_SIZE) {
+            Chunk* chunk = newChunk(bytes);
+            chunk->next = large;
+            large = chunk;
+            footprint += bytes;
+            return dataOf(chunk);
+        }
+        if (current && current->next) {
+            enter(current->next);
+        }
+        else {
+            Chunk* chunk = newChunk(CHUNK_SIZE);
+            footprint += CHUNK_SIZE;
+            if (current) current->next = chunk;
+            else chunks = chunk;
+            enter(chunk);
+        }
+        char* result = cursor;
+        cursor += bytes;
+        return result;
+    }
+
+public:
+    size_t live = 0;       // 아직 delete되지 않은 할당 수 (소유 스레드만 갱신)
+    bool retired = false;  // 게임 종료 후에도 살아남은 할당이 있어 재사용하지 않는 아레나
+
+    GameArena() = default;
+    GameArena(const GameArena&) = delete;
+    GameArena& operator=(const GameArena&) = delete;
+
+    ~GameArena()
+    {
+        releaseLarge();
+        while (chunks) {
+            Chunk* next = chunks->next;
+            free(chunks);
+            chunks = next;
+        }
+    }
+
+    void* allocate(size_t bytes)
+    { // bytes는 헤더 포함, 16의 배수
+        char* result;
+        if (static_cast<size_t>(limit - cursor) >= bytes) {
+            result = cursor;
+            cursor += bytes;
+        }
+        else {
+            result = refill(bytes);
+        }
+        live++;
+        return result;
+    }
+
+    void reset()
+    { // 한 번에 전체 해제: 커서만 첫 청크로 되돌림
+        releaseLarge();
+        live = 0;
+        if (chunks) enter(chunks);
+        else current = nullptr, cursor = limit = nullptr;
+    }
+
+    size_t footprintBytes() const { return footprint; }
+
+private:
+    void releaseLarge()
+    {
+        while (large) {
+            Chunk* next = large->next;
+            footprint -= large->size;
+            free(large);
+            large = next;
+        }
+    }
+};
+
+class ArenaPool
+{ // 스레드별 아레나 재활용 목록
+private:
+    static const int MAX_IDLE = 4;
+    GameArena* idle[MAX_IDLE] = {};
+    int idleCount = 0;
+
+public:
+    ~ArenaPool()
+    {
+        for (int i = 0; i < idleCount; i++) delete idle[i];
+    }
+
+    GameArena* acquire()
+    {
+        if (idleCount > 0) return idle[--idleCount];
+        GameArena* previous = activeArena;
+        activeArena = nullptr; // 아레나 객체 자체는 힙에
+        GameArena* arena = new GameArena();
+        activeArena = previous;
+        return arena;
+    }
+
+    bool recycle(GameArena* arena)
+    { // 살아남은 할당이 없으면 리셋 후 보관, 있으면 버리지 않고 은퇴 (마지막 delete에서 해제)
+        if (arena->live != 0) {
+            arena->retired = true;
+            return false;
+        }
+        arena->reset();
+        if (idleCount < MAX_IDLE) idle[idleCount++] = arena;
+        else delete arena;
+        return true;
+    }
+};
+
+thread_local ArenaPool arenaPool;
+
+class ArenaBypass
+{ // 스레드 수명 이상 살아남는 객체(등록 목록, 스레드별 버퍼)를 게임 중에 만들 때 힙 사용
+private:
+    GameArena* saved;
+
+public:
+    ArenaBypass() : saved(activeArena) { activeArena = nullptr; }
+    ~ArenaBypass() { activeArena = saved; }
+
+    ArenaBypass(const ArenaBypass&) = delete;
+    ArenaBypass& operator=(const ArenaBypass&) = delete;
+};
+
+// 전역 operator new/delete 교체: 모든 형태를 직접 정의 (표준 기본 구현이 이쪽을 부른다는 보장은 없어서
+// 새니타이저 빌드에서는 nothrow new가 새니타이저 할당기로 가고 해제만 여기로 와 헤더가 어긋남)
+// 정렬 지정(align_val_t) 형태는 할당과 해제 모두 표준 구현이므로 교체하지 않음
+void* operator new(size_t size)
+{
+    size_t bytes = (sizeof(AllocHeader) + size + 15) & ~static_cast<size_t>(15);
+    AllocHeader* header;
+    if (GameArena* arena = activeArena) {
+        header = static_cast<AllocHeader*>(arena->allocate(bytes));
+        header->owner = arena;
+        allocationStats.arenaCalls++;
+        allocationStats.arenaBytes += size;
+    }
+    else {
+        header = static_cast<AllocHeader*>(malloc(bytes));
+        if (!header) throw bad_alloc();
+        header->owner = nullptr;
+        allocationStats.heapCalls++;
+        allocationStats.heapBytes += size;
+    }
+    header->size = size;
+    return header + 1;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (!pointer) return;
+    AllocHeader* header = static_cast<AllocHeader*>(pointer) - 1;
+    GameArena* arena = header->owner;
+    if (!arena) {
+        free(header);
+        return;
+    }
+    // 아레나 메모리는 개별 반환하지 않음 (리셋 때 한꺼번에)
+    if (--arena->live == 0 && arena->retired) delete arena;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept
+{
+    try {
+        return operator new(size);
+    }
+    catch (const bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, const nothrow_t&) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, const nothrow_t&) noexcept
+{
+    operator delete(pointer);
+}
+
+#endif // ARENA_H
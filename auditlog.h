@@ -0,0 +1,439 @@
+// auditlog.h
+#ifndef AUDITLOG_H
+#define AUDITLOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+// 분쟁 대응용 감사 로그: 게임 스레드는 고정 크기 레코드를 큐에 넣기만 하고,
+// 백그라운드 스레드가 묶음 단위로 압축하여 순차 기록 후 fsync 한다.
+
+enum AuditEventType : uint8_t
+{
+    AUDIT_GAME_START,   // value: 인원 수
+    AUDIT_DEAL,         // actor: 좌석, value: 직업 번호 (createRole 기준)
+    AUDIT_NIGHT_ACTION, // actor -> target, value: 직업 번호
+    AUDIT_ARMOR,        // actor: 방탄복으로 버틴 좌석
+    AUDIT_TAMING,       // actor: 늑대인간 좌석
+    AUDIT_DEATH,        // actor: 밤 사이 사망한 좌석
+    AUDIT_VOTE,         // actor -> target (기권은 AUDIT_NO_SEAT)
+    AUDIT_FINAL_VOTE,   // actor: 후보, value: 찬성, extra: 반대
+    AUDIT_EXECUTION,    // actor: 처형된 좌석
+    AUDIT_GAME_END,     // value: 승리 팀 (0 무승부, 1 시민, 2 마피아)
+    AUDIT_TYPE_COUNT
+};
+
+const uint8_t AUDIT_NO_SEAT = 0xFF;
+
+const char* auditTypeName(uint8_t type)
+{
+    static const char* names[AUDIT_TYPE_COUNT] = {
+        "game_start", "deal", "night_action", "armor", "taming",
+        "death", "vote", "final_vote", "execution", "game_end" };
+    return type < AUDIT_TYPE_COUNT ? names[type] : "?";
+}
+
+struct AuditRecord
+{ // 32바이트 고정 크기
+    uint64_t gameId;
+    uint64_t timeNs;    // system_clock 기준 (epoch 이후 나노초)
+    uint16_t day;
+    uint8_t type;
+    uint8_t actor;
+    uint8_t target;
+    uint8_t reserved;
+    uint16_t value;
+    uint16_t extra;
+    uint8_t padding[6];
+};
+static_assert(sizeof(AuditRecord) == 32, "AuditRecord must stay 32 bytes");
+
+class AuditQueue
+{ // 유한 크기 다중 생산자/단일 소비자 큐 (셀별 시퀀스 번호, Vyukov 방식)
+private:
+    struct Cell
+    {
+        atomic<size_t> sequence;
+        AuditRecord record;
+    };
+
+    static const size_t CAPACITY = 1 << 16;
+    static const size_t MASK = CAPACITY - 1;
+
+    unique_ptr<Cell[]> cells;
+    alignas(64) atomic<size_t> enqueuePos;
+    alignas(64) size_t dequeuePos; // 소비자 전용
+
+public:
+    AuditQueue() : cells(new Cell[CAPACITY]), enqueuePos(0), dequeuePos(0)
+    {
+        for (size_t i = 0; i < CAPACITY; i++) cells[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    bool tryPush(const AuditRecord& record)
+    {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & MASK];
+            size_t seq = cell->sequence.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                return false; // 가득 참
+            }
+            else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+        cell->record = record;
+        cell->sequence.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    bool tryPop(AuditRecord& record)
+    {
+        Cell* cell = &cells[dequeuePos & MASK];
+        if (cell->sequence.load(memory_order_acquire) != dequeuePos + 1) return false;
+        record = cell->record;
+        cell->sequence.store(dequeuePos + CAPACITY, memory_order_release);
+        dequeuePos++;
+        return true;
+    }
+};
+
+// 묶음(batch) 인코딩: 필드별 이전 레코드와의 차이를 varint로 저장
+namespace auditcodec
+{
+    const uint32_t FRAME_MAGIC = 0x4C50414E; // "NAPL"
+
+    uint32_t crc32(const uint8_t* data, size_t length)
+    {
+        struct Table
+        {
+            uint32_t entries[256];
+            Table()
+            {
+                for (uint32_t i = 0; i < 256; i++) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    entries[i] = c;
+                }
+            }
+        };
+        static const Table table; // 스레드 안전한 1회 초기화
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < length; i++) crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    void putVarint(vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7) {
+            uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+    int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+    void encode(const vector<AuditRecord>& records, vector<uint8_t>& out)
+    {
+        AuditRecord prev;
+        memset(&prev, 0, sizeof(prev));
+        for (const auto& r : records) {
+            putVarint(out, zigzag(static_cast<int64_t>(r.gameId - prev.gameId)));
+            putVarint(out, zigzag(static_cast<int64_t>(r.timeNs - prev.timeNs)));
+            putVarint(out, r.day);
+            out.push_back(r.type);
+            out.push_back(r.actor);
+            out.push_back(r.target);
+            putVarint(out, r.value);
+            putVarint(out, r.extra);
+            prev = r;
+        }
+    }
+
+    bool decode(const uint8_t* p, const uint8_t* end, uint32_t count, vector<AuditRecord>& out)
+    {
+        AuditRecord prev;
+        memset(&prev, 0, sizeof(prev));
+        for (uint32_t i = 0; i < count; i++) {
+            AuditRecord r;
+            memset(&r, 0, sizeof(r));
+            uint64_t v;
+            if (!getVarint(p, end, v)) return false;
+            r.gameId = prev.gameId + static_cast<uint64_t>(unzigzag(v));
+            if (!getVarint(p, end, v)) return false;
+            r.timeNs = prev.timeNs + static_cast<uint64_t>(unzigzag(v));
+            if (!getVarint(p, end, v)) return false;
+            r.day = static_cast<uint16_t>(v);
+            if (end - p < 3) return false;
+            r.type = *p++;
+            r.actor = *p++;
+            r.target = *p++;
+            if (!getVarint(p, end, v)) return false;
+            r.value = static_cast<uint16_t>(v);
+            if (!getVarint(p, end, v)) return false;
+            r.extra = static_cast<uint16_t>(v);
+            out.push_back(r);
+            prev = r;
+        }
+        return true;
+    }
+
+    template <typename Fn>
+    long readFrames(FILE* in, Fn&& onFrame)
+    { // CRC가 맞는 프레임만 순서대로 전달, 온전한 앞부분의 바이트 수 반환
+        long valid = 0;
+        vector<uint8_t> body;
+        uint32_t header[4];
+        while (fread(header, 1, sizeof(header), in) == sizeof(header)) {
+            if (header[0] != FRAME_MAGIC) break;
+            body.resize(header[2]);
+            if (fread(body.data(), 1, body.size(), in) != body.size() ||
+                crc32(body.data(), body.size()) != header[3])
+                break;
+            if (!onFrame(header[1], body)) break;
+            valid += static_cast<long>(sizeof(header) + body.size());
+        }
+        return valid;
+    }
+}
+
+class AuditLog
+{
+private:
+    static const size_t BATCH_MAX = 8192;  // 묶음당 최대 레코드 수
+    static constexpr int FLUSH_MS = 10;    // 첫 레코드 후 최대 대기 시간
+
+    AuditQueue queue;
+    atomic<bool> enabled;
+    atomic<bool> running;
+    atomic<uint64_t> stalls; // 큐가 가득 차서 생산자가 양보한 횟수
+    FILE* file;
+    thread writer;
+    uint64_t batchesWritten;
+    uint64_t recordsWritten;
+    uint64_t bytesWritten;
+
+    void writeBatch(const vector<AuditRecord>& batch)
+    { // 프레임: magic, 레코드 수, 본문 길이, CRC32, 본문 (한 번의 fwrite 후 fsync)
+        vector<uint8_t> frame(16);
+        auditcodec::encode(batch, frame);
+
+        uint32_t header[4] = {
+            auditcodec::FRAME_MAGIC,
+            static_cast<uint32_t>(batch.size()),
+            static_cast<uint32_t>(frame.size() - 16),
+            auditcodec::crc32(frame.data() + 16, frame.size() - 16) };
+        memcpy(frame.data(), header, sizeof(header));
+
+        fwrite(frame.data(), 1, frame.size(), file);
+        fflush(file);
+#ifdef _WIN32
+        _commit(_fileno(file));
+#else
+        fsync(fileno(file));
+#endif
+        batchesWritten++;
+        recordsWritten += batch.size();
+        bytesWritten += frame.size();
+    }
+
+    void run()
+    {
+#ifdef __linux__
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10); // 게임 스레드보다 낮은 우선순위
+#endif
+        vector<AuditRecord> batch;
+        batch.reserve(BATCH_MAX);
+        steady_clock::time_point firstPending;
+
+        while (true) {
+            bool stopping = !running.load();
+            AuditRecord record;
+            while (batch.size() < BATCH_MAX && queue.tryPop(record)) {
+                if (batch.empty()) firstPending = steady_clock::now();
+                batch.push_back(record);
+            }
+
+            bool due = !batch.empty() &&
+                (batch.size() >= BATCH_MAX || stopping ||
+                    steady_clock::now() - firstPending >= milliseconds(FLUSH_MS));
+            if (due) {
+                writeBatch(batch);
+                batch.clear();
+                continue;
+            }
+            if (stopping) break;
+            this_thread::sleep_for(milliseconds(FLUSH_MS / 2)); // 깨어나는 횟수를 줄여 게임 스레드 선점 최소화
+        }
+    }
+
+public:
+    AuditLog() : enabled(false), running(false), stalls(0), file(nullptr),
+        batchesWritten(0), recordsWritten(0), bytesWritten(0) {}
+    ~AuditLog() { stop(); }
+
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+
+    bool start(const string& path)
+    { // 기존 파일의 온전한 프레임 뒤에 이어 씀 (비정상 종료로 잘린 꼬리는 잘라냄)
+        if (running.load()) return true;
+        file = fopen(path.c_str(), "r+b");
+        if (file) {
+            long valid = auditcodec::readFrames(file, [](uint32_t, const vector<uint8_t>&) { return true; });
+            fseek(file, 0, SEEK_END);
+            if (ftell(file) != valid) {
+#ifdef _WIN32
+                _chsize(_fileno(file), valid);
+#else
+                if (ftruncate(fileno(file), valid) != 0) return false;
+#endif
+            }
+            fseek(file, valid, SEEK_SET);
+        }
+        else {
+            file = fopen(path.c_str(), "wb");
+        }
+        if (!file) return false;
+        running.store(true);
+        writer = thread(&AuditLog::run, this);
+        enabled.store(true, memory_order_release);
+        return true;
+    }
+
+    void stop()
+    { // 남은 레코드를 모두 기록하고 닫음
+        if (!running.load()) return;
+        enabled.store(false, memory_order_release);
+        running.store(false);
+        if (writer.joinable()) writer.join();
+        fclose(file);
+        file = nullptr;
+    }
+
+    void append(const AuditRecord& record)
+    { // 큐가 가득 찬 경우에만 양보하며 재시도 (기록을 버리지 않음)
+        while (!queue.tryPush(record)) {
+            stalls.fetch_add(1, memory_order_relaxed);
+            this_thread::yield();
+        }
+    }
+
+    void printSummary(ostream& out) const
+    {
+        out << "감사 로그: " << recordsWritten << "건, " << batchesWritten << "묶음, "
+            << bytesWritten << "바이트 (레코드당 "
+            << (recordsWritten ? static_cast<double>(bytesWritten) / recordsWritten : 0.0)
+            << "바이트), 큐 대기 " << stalls.load() << "회\n";
+    }
+};
+
+AuditLog auditLog;
+
+void auditEvent(uint64_t gameId, int day, AuditEventType type,
+    uint8_t actor = AUDIT_NO_SEAT, uint8_t target = AUDIT_NO_SEAT, uint16_t value = 0, uint16_t extra = 0)
+{ // 비활성 시 분기 하나
+    if (!auditLog.isEnabled()) return;
+    AuditRecord record;
+    memset(&record, 0, sizeof(record));
+    record.gameId = gameId;
+    record.timeNs = static_cast<uint64_t>(
+        duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count());
+    record.day = static_cast<uint16_t>(day);
+    record.type = type;
+    record.actor = actor;
+    record.target = target;
+    record.value = value;
+    record.extra = extra;
+    auditLog.append(record);
+}
+
+size_t readAuditLog(const string& path, const function<void(const AuditRecord&)>& visit, bool& truncated)
+{ // 온전한 프레임만 읽음, 잘렸거나 CRC가 맞지 않는 프레임을 만나면 그 앞에서 멈춤
+    truncated = false;
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) return 0;
+
+    size_t total = 0;
+    vector<AuditRecord> records;
+    long valid = auditcodec::readFrames(in, [&](uint32_t count, const vector<uint8_t>& body) {
+        records.clear();
+        if (!auditcodec::decode(body.data(), body.data() + body.size(), count, records)) return false;
+        for (const auto& r : records) visit(r);
+        total += records.size();
+        return true;
+        });
+    fseek(in, 0, SEEK_END);
+    truncated = ftell(in) != valid;
+    fclose(in);
+    return total;
+}
+
+int runAuditCommand(int argc, char* argv[])
+{ // 사용법: napoly audit 파일 [게임 번호]
+    if (argc < 3) {
+        cout << "사용법: napoly audit 파일 [게임 번호]\n";
+        return 1;
+    }
+    bool filterGame = argc > 3;
+    uint64_t gameFilter = filterGame ? strtoull(argv[3], nullptr, 10) : 0;
+
+    bool truncated = false;
+    size_t count = readAuditLog(argv[2], [&](const AuditRecord& r) {
+        if (filterGame && r.gameId != gameFilter) return;
+        cout << r.gameId << "\t" << r.day << "\t" << auditTypeName(r.type);
+        if (r.actor != AUDIT_NO_SEAT) cout << "\tactor=" << static_cast<int>(r.actor);
+        if (r.target != AUDIT_NO_SEAT) cout << "\ttarget=" << static_cast<int>(r.target);
+        if (r.type == AUDIT_GAME_START || r.type == AUDIT_DEAL || r.type == AUDIT_NIGHT_ACTION ||
+            r.type == AUDIT_FINAL_VOTE || r.type == AUDIT_GAME_END)
+            cout << "\tvalue=" << r.value;
+        if (r.type == AUDIT_FINAL_VOTE) cout << "\textra=" << r.extra;
+        cout << "\n";
+        }, truncated);
+
+    cout << "# " << count << "건" << (truncated ? " (마지막 묶음이 손상되어 이후는 무시함)" : "") << "\n";
+    return 0;
+}
+
+#endif // AUDITLOG_H
@@ -0,0 +1,551 @@
+// batch.h
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "botplugin.h"
+#include "deal.h"
+#include "jobs.h"
+#include "rng.h"
+
+using namespace std;
+
+// 일괄 엔진: 여러 게임을 구조체 배열(SoA)로 두고 같은 단계를 한꺼번에 진행 (봇 시뮬레이션 전용)
+// 좌석 집합은 게임마다 1바이트 비트마스크(좌석 i = 비트 i, 최대 8인)로 표현하고
+// 밤 판정(processActions)과 투표 집계는 게임 축으로 벡터화한 커널에서 처리함
+// 봇 입력의 난수 소비 순서는 runSimulatedGame과 같으므로 같은 시드, 같은 게임 번호면 결과도 같음
+
+#if defined(__GNUC__)
+#define NAPOLY_BATCH_VECTOR 1
+#define NAPOLY_LANE_INLINE inline __attribute__((always_inline))
+typedef uint8_t Lane16 __attribute__((vector_size(16)));  // SSE2 (x86-64 기본), 다른 CPU는 해당 SIMD로 변환됨
+typedef uint8_t Lane32 __attribute__((vector_size(32)));  // AVX2
+#else
+#define NAPOLY_LANE_INLINE inline
+#endif
+
+struct ScalarLane
+{ // 벡터 확장이 없는 컴파일러용 1게임 레인 (비교 결과는 벡터와 같이 0xFF/0x00)
+    uint8_t v;
+    ScalarLane(uint8_t x = 0) : v(x) {}
+};
+inline ScalarLane operator&(ScalarLane a, ScalarLane b) { return ScalarLane(a.v & b.v); }
+inline ScalarLane operator|(ScalarLane a, ScalarLane b) { return ScalarLane(a.v | b.v); }
+inline ScalarLane operator~(ScalarLane a) { return ScalarLane(static_cast<uint8_t>(~a.v)); }
+inline ScalarLane operator+(ScalarLane a, ScalarLane b) { return ScalarLane(static_cast<uint8_t>(a.v + b.v)); }
+inline ScalarLane operator-(ScalarLane a, ScalarLane b) { return ScalarLane(static_cast<uint8_t>(a.v - b.v)); }
+inline ScalarLane operator>>(ScalarLane a, int n) { return ScalarLane(static_cast<uint8_t>(a.v >> n)); }
+inline ScalarLane operator==(ScalarLane a, ScalarLane b) { return ScalarLane(a.v == b.v ? 0xFF : 0x00); }
+inline ScalarLane operator>(ScalarLane a, ScalarLane b) { return ScalarLane(a.v > b.v ? 0xFF : 0x00); }
+
+// 모든 레인에 같은 바이트 (벡터에 스칼라를 섞는 연산은 값이 상수로 접히지 않으면 최적화 수준에 따라 컴파일되지 않음)
+template <typename V>
+NAPOLY_LANE_INLINE void broadcast(V& out, uint8_t x) { memset(&out, x, sizeof(V)); }
+inline void broadcast(ScalarLane& out, uint8_t x) { out = ScalarLane(x); }
+
+struct BatchColumns
+{ // 레인(게임)별 열, 길이는 가장 넓은 커널 폭의 배수로 맞춤
+    static const int MAX_SEATS = 8;
+
+    vector<uint8_t> alive;         // 생존 좌석
+    vector<uint8_t> mafia;         // 마피아 좌석
+    vector<uint8_t> wolf;          // 늑대인간 좌석 (한 비트)
+    vector<uint8_t> actors;        // 밤 능력 사용 좌석 (마피아, 늑대인간, 경찰, 의사, 사립 탐정)
+    vector<uint8_t> doctor;        // 의사 좌석 (한 비트)
+    vector<uint8_t> armor;         // 방탄복이 남은 군인 좌석
+    vector<uint8_t> tamed;         // 늑대인간 접선 여부 (0xFF/0x00)
+    vector<uint8_t> mafiaTarget;   // 이번 밤 마지막 마피아의 대상 (한 비트, 없으면 0)
+    vector<uint8_t> wolfTarget;    // 늑대인간의 대상
+    vector<uint8_t> doctorTarget;  // 의사의 대상
+    vector<uint8_t> votes[MAX_SEATS]; // 좌석별 1차 투표 득표 수
+    vector<uint8_t> candidate;     // 찬반 투표 대상 (단독 최다 득표자, 없으면 0)
+    vector<uint8_t> agree;         // 찬성 수
+    vector<uint8_t> voters;        // 투표 참여자 수
+    vector<uint8_t> winner;        // 0: 진행 중, 1: 시민 팀, 2: 마피아 팀
+
+    void resize(size_t lanes)
+    {
+        for (vector<uint8_t>* column : { &alive, &mafia, &wolf, &actors, &doctor, &armor, &tamed,
+            &mafiaTarget, &wolfTarget, &doctorTarget, &candidate, &agree, &voters, &winner }) {
+            column->assign(lanes, 0);
+        }
+        for (auto& column : votes) column.assign(lanes, 0);
+    }
+
+    void moveLane(size_t from, size_t to)
+    { // 끝난 게임 자리를 마지막 레인으로 채움 (밤/투표 중간 값은 매일 다시 계산하므로 제외)
+        alive[to] = alive[from];
+        mafia[to] = mafia[from];
+        wolf[to] = wolf[from];
+        actors[to] = actors[from];
+        doctor[to] = doctor[from];
+        armor[to] = armor[from];
+        tamed[to] = tamed[from];
+    }
+};
+
+namespace batchkernel
+{
+    template <typename V>
+    NAPOLY_LANE_INLINE void load(V& out, const vector<uint8_t>& column, size_t lane)
+    {
+        memcpy(&out, column.data() + lane, sizeof(V));
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void store(vector<uint8_t>& column, size_t lane, const V& value)
+    {
+        memcpy(column.data() + lane, &value, sizeof(V));
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void popcount(V& x)
+    { // 바이트별 비트 수
+        V m1, m2, m4;
+        broadcast(m1, 0x55);
+        broadcast(m2, 0x33);
+        broadcast(m4, 0x0F);
+        x = x - ((x >> 1) & m1);
+        x = (x & m2) + ((x >> 2) & m2);
+        x = (x + (x >> 4)) & m4;
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void victory(V& winner, const V& alive, const V& mafia, const V& wolf, const V& T)
+    { // evaluateVictory: 마피아 + 접선한 늑대인간이 마피아 팀 (1: 시민 팀, 2: 마피아 팀, 0: 진행 중)
+        const V zero = V();
+        V mafiaAlive = alive & (mafia | (wolf & T));
+        V total = alive;
+        popcount(mafiaAlive);
+        popcount(total);
+        V citizens = total - mafiaAlive;
+        V noMafia = (V)(mafiaAlive == zero);
+        V mafiaAhead = ~noMafia & ~(V)(citizens > mafiaAlive);
+        V one, two;
+        broadcast(one, 1);
+        broadcast(two, 2);
+        winner = (noMafia & one) | (mafiaAhead & two);
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void night(BatchColumns& c, size_t lanes, bool doctorBeatsArmor)
+    { // processActions의 판정을 비트 연산으로 옮김 (처리 순서: 늑대인간 -> 의사 -> 마피아)
+        const V zero = V();
+        const V armorFirst = doctorBeatsArmor ? zero : ~zero; // GameRules::doctorBeatsArmor
+        for (size_t lane = 0; lane < lanes; lane += sizeof(V)) {
+            V M, W, D, wolf, T, armor, alive, mafia, winner;
+            load(M, c.mafiaTarget, lane);
+            load(W, c.wolfTarget, lane);
+            load(D, c.doctorTarget, lane);
+            load(wolf, c.wolf, lane);
+            load(T, c.tamed, lane);
+            load(armor, c.armor, lane);
+            load(alive, c.alive, lane);
+            load(mafia, c.mafia, lane);
+
+            V hasMafia = ~(V)(M == zero);
+
+            // 늑대인간: 접선 전이면 마피아와 대상 일치 여부만, 접선 후면 무조건 공격
+            V match = (V)(W == M) & hasMafia & ~T;
+            V killed = W & T;
+
+            // 의사: 아직 방어된 대상이 없으므로 항상 치료
+            V healed = D;
+
+            // 마피아: 늑대인간을 쏘면 즉시 접선, 군인은 방탄복 소모 (규칙에 따라 치료받았으면 유지), 그 외는 처치
+            V hitsWolf = (V)(M == wolf) & hasMafia;
+            V tameNow = hitsWolf & ~T;
+            V shot = M & ~hitsWolf;
+            V defended = shot & armor & (armorFirst | ~D);
+            armor = armor & ~defended;
+            healed = healed & ~defended;
+            V mafiaKill = shot & ~defended;
+            killed = killed | mafiaKill;
+
+            // 늑대인간 대상과 일치한 마피아 대상이 실제로 죽으면 접선
+            V survives = healed | defended;
+            V matchedDies = ~(V)((mafiaKill & ~survives) == zero);
+            T = T | tameNow | (match & matchedDies);
+
+            // 밤 직후 승리 체크는 사망 반영 전 생존자 기준 (접선으로 팀 수가 바뀔 수 있음)
+            victory(winner, alive, mafia, wolf, T);
+
+            // 사망 반영 (resolveDay의 DEATH_MARK 처리)
+            alive = alive & ~(killed & ~survives);
+
+            store(c.winner, lane, winner);
+            store(c.armor, lane, armor);
+            store(c.tamed, lane, T);
+            store(c.alive, lane, alive);
+        }
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void tally(BatchColumns& c, size_t lanes, int seats)
+    { // tallyVotes: 최다 득표자가 단독일 때만 후보로 남김
+        const V zero = V();
+        V one;
+        broadcast(one, 1);
+        for (size_t lane = 0; lane < lanes; lane += sizeof(V)) {
+            V most = zero, count;
+            for (int seat = 0; seat < seats; seat++) {
+                load(count, c.votes[seat], lane);
+                V greater = (V)(count > most);
+                most = (count & greater) | (most & ~greater);
+            }
+            V leaders = zero, bit;
+            for (int seat = 0; seat < seats; seat++) {
+                load(count, c.votes[seat], lane);
+                broadcast(bit, static_cast<uint8_t>(1u << seat));
+                leaders = leaders | ((V)(count == most) & bit);
+            }
+            V single = (V)((leaders & (leaders - one)) == zero);
+            store(c.candidate, lane, leaders & single & ~(V)(most == zero));
+        }
+    }
+
+    template <typename V>
+    NAPOLY_LANE_INLINE void execute(BatchColumns& c, size_t lanes)
+    { // resolveFinalVote + evaluateVictory
+        for (size_t lane = 0; lane < lanes; lane += sizeof(V)) {
+            V candidate, agree, voters, alive, mafia, wolf, T, winner;
+            load(candidate, c.candidate, lane);
+            load(agree, c.agree, lane);
+            load(voters, c.voters, lane);
+            load(alive, c.alive, lane);
+            load(mafia, c.mafia, lane);
+            load(wolf, c.wolf, lane);
+            load(T, c.tamed, lane);
+
+            V executed = (V)(agree > (voters - agree));
+            alive = alive & ~(candidate & executed);
+            victory(winner, alive, mafia, wolf, T);
+
+            store(c.alive, lane, alive);
+            store(c.winner, lane, winner);
+        }
+    }
+
+#ifdef NAPOLY_BATCH_VECTOR
+#ifdef NAPOLY_RNG_AVX2
+    __attribute__((target("avx2"))) void nightAvx2(BatchColumns& c, size_t lanes, bool rule) { night<Lane32>(c, lanes, rule); }
+    __attribute__((target("avx2"))) void tallyAvx2(BatchColumns& c, size_t lanes, int seats) { tally<Lane32>(c, lanes, seats); }
+    __attribute__((target("avx2"))) void executeAvx2(BatchColumns& c, size_t lanes) { execute<Lane32>(c, lanes); }
+#endif
+    void nightSse(BatchColumns& c, size_t lanes, bool rule) { night<Lane16>(c, lanes, rule); }
+    void tallySse(BatchColumns& c, size_t lanes, int seats) { tally<Lane16>(c, lanes, seats); }
+    void executeSse(BatchColumns& c, size_t lanes) { execute<Lane16>(c, lanes); }
+#endif
+
+    bool useAvx2()
+    {
+#if defined(NAPOLY_BATCH_VECTOR) && defined(NAPOLY_RNG_AVX2)
+        return philox::hasAvx2();
+#else
+        return false;
+#endif
+    }
+
+    const char* backendName()
+    {
+#ifdef NAPOLY_BATCH_VECTOR
+        return useAvx2() ? "AVX2" : "SSE";
+#else
+        return "scalar";
+#endif
+    }
+
+    void runNight(BatchColumns& c, size_t lanes, bool doctorBeatsArmor)
+    {
+#ifdef NAPOLY_BATCH_VECTOR
+#ifdef NAPOLY_RNG_AVX2
+        if (useAvx2()) { nightAvx2(c, lanes, doctorBeatsArmor); return; }
+#endif
+        nightSse(c, lanes, doctorBeatsArmor);
+#else
+        night<ScalarLane>(c, lanes, doctorBeatsArmor);
+#endif
+    }
+
+    void runTally(BatchColumns& c, size_t lanes, int seats)
+    {
+#ifdef NAPOLY_BATCH_VECTOR
+#ifdef NAPOLY_RNG_AVX2
+        if (useAvx2()) { tallyAvx2(c, lanes, seats); return; }
+#endif
+        tallySse(c, lanes, seats);
+#else
+        tally<ScalarLane>(c, lanes, seats);
+#endif
+    }
+
+    void runExecute(BatchColumns& c, size_t lanes)
+    {
+#ifdef NAPOLY_BATCH_VECTOR
+#ifdef NAPOLY_RNG_AVX2
+        if (useAvx2()) { executeAvx2(c, lanes); return; }
+#endif
+        executeSse(c, lanes);
+#else
+        execute<ScalarLane>(c, lanes);
+#endif
+    }
+}
+
+struct SeatTables
+{ // 8비트 좌석 마스크용 표: 비트 수, k번째 좌석
+    uint8_t count[256];
+    uint8_t nth[256][8];
+
+    SeatTables()
+    {
+        for (int mask = 0; mask < 256; mask++) {
+            int k = 0;
+            for (int seat = 0; seat < 8; seat++) {
+                if (mask & (1 << seat)) nth[mask][k++] = static_cast<uint8_t>(seat);
+            }
+            count[mask] = static_cast<uint8_t>(k);
+            for (; k < 8; k++) nth[mask][k] = 0;
+        }
+    }
+};
+
+const SeatTables seatTables;
+
+class GameBatch
+{ // 최대 capacity개 게임을 동시에 진행, 끝난 게임은 하루가 끝날 때마다 빠짐
+public:
+    static const size_t LANE_ALIGN = 32; // 가장 넓은 커널 폭 (AVX2)
+
+    GameBatch(int playerCount, size_t capacity)
+        : seats(playerCount), capacity(capacity), count(0)
+    {
+        columns.resize((capacity + LANE_ALIGN - 1) / LANE_ALIGN * LANE_ALIGN);
+        gameIds.resize(capacity);
+        deals.resize(capacity);
+        days.resize(capacity);
+        rngs.reserve(capacity);
+    }
+
+    void setBot(BotDecisions* decisions) { bot = decisions; } // 있으면 봇 입력을 플러그인이 대신함
+    size_t size() const { return count; }
+    bool full() const { return count == capacity; }
+
+    void add(uint64_t gameId, const uint8_t* deal, const GameRng& decisionRng)
+    { // deal[seat] = 직업 번호 (DealGenerator 결과)
+        size_t lane = count++;
+        uint8_t mafia = 0, wolf = 0, actors = 0, doctor = 0, armor = 0;
+        for (int seat = 0; seat < seats; seat++) { // 직업 등록부의 행동 종류로 열을 채움
+            uint8_t bit = static_cast<uint8_t>(1u << seat);
+            const RoleInfo& info = roleRegistry[deal[seat]];
+            if (info.night != NIGHT_NONE) actors |= bit; // 조사/추적은 판정에 영향 없이 난수만 소비
+            if (info.night == NIGHT_KILL) mafia |= bit;
+            else if (info.night == NIGHT_HUNT) wolf |= bit;
+            else if (info.night == NIGHT_HEAL) doctor |= bit;
+            if (info.armored) armor |= bit;
+        }
+        columns.alive[lane] = static_cast<uint8_t>((1u << seats) - 1);
+        columns.mafia[lane] = mafia;
+        columns.wolf[lane] = wolf;
+        columns.actors[lane] = actors;
+        columns.doctor[lane] = doctor;
+        columns.armor[lane] = armor;
+        columns.tamed[lane] = 0;
+        gameIds[lane] = gameId;
+        deals[lane] = packDeal(deal, seats);
+        days[lane] = 1;
+        if (lane < rngs.size()) rngs[lane] = decisionRng;
+        else rngs.push_back(decisionRng);
+    }
+
+    template <typename Fn>
+    void step(int maxDays, Fn&& onFinished)
+    { // 모든 게임을 하루(밤 + 투표) 진행, 끝난 게임은 onFinished(게임 번호, 승리 팀, 진행 일수, DealOutcome) 후 제거
+        size_t lanes = (count + LANE_ALIGN - 1) / LANE_ALIGN * LANE_ALIGN;
+
+        if (bot) pluginNightInput();
+        else nightInput();
+        batchkernel::runNight(columns, lanes, gameRules.doctorBeatsArmor);
+        retire(false, maxDays, onFinished);
+
+        lanes = (count + LANE_ALIGN - 1) / LANE_ALIGN * LANE_ALIGN;
+        if (bot) pluginBallots();
+        else ballots();
+        batchkernel::runTally(columns, lanes, seats);
+        if (bot) pluginFinalVotes();
+        else finalVotes();
+        batchkernel::runExecute(columns, lanes);
+        retire(true, maxDays, onFinished);
+    }
+
+private:
+    int seats;
+    size_t capacity;
+    size_t count;
+    BatchColumns columns;
+    vector<uint64_t> gameIds;
+    vector<uint32_t> deals; // packDeal
+    vector<int> days;
+    vector<GameRng> rngs;
+    BotDecisions* bot = nullptr;
+
+    int roleAt(size_t lane, int seat) const { return static_cast<int>((deals[lane] >> (4 * seat)) & 0x0F); }
+
+    uint8_t alliesOf(size_t lane, uint8_t self) const
+    { // 그 좌석이 아는 같은 팀: 마피아와 접선한 늑대인간은 서로 앎
+        uint8_t mafia = columns.mafia[lane], wolf = columns.wolf[lane];
+        bool tamed = columns.tamed[lane] != 0;
+        if ((self & mafia) || ((self & wolf) && tamed)) return static_cast<uint8_t>(mafia | (tamed ? wolf : 0) | self);
+        return self;
+    }
+
+    template <typename Fn>
+    void retire(bool endOfDay, int maxDays, Fn& onFinished)
+    { // 승패가 났거나 (하루가 끝난 뒤) 최대 일수를 넘긴 게임 제거
+        for (size_t lane = count; lane-- > 0; ) {
+            uint8_t winner = columns.winner[lane];
+            if (!winner && (!endOfDay || ++days[lane] <= maxDays)) continue;
+            DealOutcome outcome;
+            outcome.roles = deals[lane];
+            outcome.seats = static_cast<uint8_t>(seats);
+            outcome.alive = columns.alive[lane];
+            outcome.tamed = columns.tamed[lane] != 0;
+            onFinished(gameIds[lane], winner, days[lane], outcome);
+
+            size_t last = --count;
+            if (lane != last) {
+                columns.moveLane(last, lane);
+                gameIds[lane] = gameIds[last];
+                deals[lane] = deals[last];
+                days[lane] = days[last];
+                rngs[lane] = rngs[last];
+            }
+        }
+    }
+
+    void nightInput()
+    { // botNightInput: 능력자가 좌석 순서대로 생존자 중 하나를 고름 (마피아는 마지막 선택만 유효)
+        for (size_t lane = 0; lane < count; lane++) {
+            uint8_t alive = columns.alive[lane];
+            uint32_t targets = seatTables.count[alive];
+            uint8_t actors = alive & columns.actors[lane];
+            uint8_t mafia = columns.mafia[lane], wolf = columns.wolf[lane], doctor = columns.doctor[lane];
+            uint8_t mafiaTarget = 0, wolfTarget = 0, doctorTarget = 0;
+            GameRng& gen = rngs[lane];
+
+            for (; actors; actors &= actors - 1) {
+                uint8_t actor = actors & static_cast<uint8_t>(-actors);
+                uint8_t target = static_cast<uint8_t>(1u << seatTables.nth[alive][boundedRandom(gen, targets)]);
+                if (actor & mafia) mafiaTarget = target;
+                else if (actor & wolf) wolfTarget = target;
+                else if (actor & doctor) doctorTarget = target;
+                // 경찰의 조사는 판정에 영향 없음 (난수만 소비)
+            }
+            columns.mafiaTarget[lane] = mafiaTarget;
+            columns.wolfTarget[lane] = wolfTarget;
+            columns.doctorTarget[lane] = doctorTarget;
+        }
+    }
+
+    void pluginNightInput()
+    { // 판정에 영향을 주는 능력자(마피아, 늑대인간, 의사)의 대상을 한 묶음으로 물음, 죽은 좌석이나 범위 밖 대상은 행동 없음
+        bot->begin(NAPOLY_DECIDE_NIGHT, seats);
+        for (size_t lane = 0; lane < count; lane++) {
+            uint8_t alive = columns.alive[lane];
+            uint8_t actors = alive & (columns.mafia[lane] | columns.wolf[lane] | columns.doctor[lane]);
+            for (int k = 0; k < seatTables.count[actors]; k++) {
+                int seat = seatTables.nth[actors][k];
+                bot->push(static_cast<uint32_t>(lane), gameIds[lane], days[lane], seat, roleAt(lane, seat), alive,
+                    alliesOf(lane, static_cast<uint8_t>(1u << seat)));
+            }
+            columns.mafiaTarget[lane] = columns.wolfTarget[lane] = columns.doctorTarget[lane] = 0;
+        }
+        bot->decide();
+        for (size_t i = 0; i < bot->size(); i++) { // 좌석 순서대로 반영하므로 마피아는 마지막 선택이 남음
+            size_t lane = bot->lane(i);
+            uint8_t choice = bot->choice(i);
+            if (choice >= seats || !((columns.alive[lane] >> choice) & 1)) continue;
+            uint8_t actor = static_cast<uint8_t>(1u << bot->seat(i)), target = static_cast<uint8_t>(1u << choice);
+            if (actor & columns.mafia[lane]) columns.mafiaTarget[lane] = target;
+            else if (actor & columns.wolf[lane]) columns.wolfTarget[lane] = target;
+            else columns.doctorTarget[lane] = target;
+        }
+        bot->finish();
+    }
+
+    void pluginBallots()
+    { // 1차 투표: 생존자마다 한 표, 죽은 좌석이나 범위 밖 선택은 기권
+        for (int seat = 0; seat < seats; seat++) {
+            memset(columns.votes[seat].data(), 0, columns.votes[seat].size());
+        }
+        bot->begin(NAPOLY_DECIDE_VOTE, seats);
+        for (size_t lane = 0; lane < count; lane++) {
+            uint8_t alive = columns.alive[lane];
+            for (int k = 0; k < seatTables.count[alive]; k++) {
+                int seat = seatTables.nth[alive][k];
+                bot->push(static_cast<uint32_t>(lane), gameIds[lane], days[lane], seat, roleAt(lane, seat), alive,
+                    alliesOf(lane, static_cast<uint8_t>(1u << seat)));
+            }
+        }
+        bot->decide();
+        for (size_t i = 0; i < bot->size(); i++) {
+            size_t lane = bot->lane(i);
+            uint8_t choice = bot->choice(i);
+            if (choice < seats && ((columns.alive[lane] >> choice) & 1)) columns.votes[choice][lane]++;
+        }
+        bot->finish();
+    }
+
+    void pluginFinalVotes()
+    { // 찬반 투표: 후보가 있는 게임의 생존자만 물음
+        bot->begin(NAPOLY_DECIDE_FINAL, seats);
+        for (size_t lane = 0; lane < count; lane++) {
+            uint8_t alive = columns.alive[lane], candidate = columns.candidate[lane];
+            columns.agree[lane] = 0;
+            columns.voters[lane] = seatTables.count[alive];
+            if (!candidate) continue;
+            for (int k = 0; k < seatTables.count[alive]; k++) {
+                int seat = seatTables.nth[alive][k];
+                bot->push(static_cast<uint32_t>(lane), gameIds[lane], days[lane], seat, roleAt(lane, seat), alive,
+                    alliesOf(lane, static_cast<uint8_t>(1u << seat)), seatTables.nth[candidate][0]);
+            }
+        }
+        bot->decide();
+        for (size_t i = 0; i < bot->size(); i++) columns.agree[bot->lane(i)] += bot->choice(i) != 0;
+        bot->finish();
+    }
+
+    void ballots()
+    { // botVoting의 1차 투표: 생존자가 좌석 순서대로 기권 또는 생존자 한 명에게 투표
+        for (int seat = 0; seat < seats; seat++) {
+            memset(columns.votes[seat].data(), 0, columns.votes[seat].size());
+        }
+        for (size_t lane = 0; lane < count; lane++) {
+            uint8_t alive = columns.alive[lane];
+            uint32_t voters = seatTables.count[alive];
+            GameRng& gen = rngs[lane];
+            for (uint32_t v = 0; v < voters; v++) {
+                uint32_t choice = boundedRandom(gen, voters + 1); // 0: 기권
+                if (choice) columns.votes[seatTables.nth[alive][choice - 1]][lane]++;
+            }
+        }
+    }
+
+    void finalVotes()
+    { // 찬반 투표: 후보가 있는 게임만 생존자 수만큼 난수 소비
+        for (size_t lane = 0; lane < count; lane++) {
+            uint8_t voters = seatTables.count[columns.alive[lane]];
+            uint8_t agree = 0;
+            if (columns.candidate[lane]) {
+                GameRng& gen = rngs[lane];
+                for (uint8_t v = 0; v < voters; v++) agree += static_cast<uint8_t>(gen() >> 31);
+            }
+            columns.agree[lane] = agree;
+            columns.voters[lane] = voters;
+        }
+    }
+};
+
+#endif // BATCH_H
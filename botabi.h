@@ -0,0 +1,77 @@
+// botabi.h
+#ifndef BOTABI_H
+#define BOTABI_H
+
+// 봇 플러그인 C ABI: 전략을 공유 라이브러리로 만들어 napoly simulate --bot 파일로 불러옴 (일괄 엔진 전용)
+// 엔진은 하루의 같은 단계(밤 행동, 1차 투표, 찬반 투표)에서 동시에 진행 중인 모든 게임의 결정을 모아
+// 열 배열(결정 i의 값은 각 배열의 i번째) 하나로 decide를 한 번 호출함
+// 플러그인은 napoly_bot_api 하나만 내보내고, 엔진 스레드마다 create로 만든 인스턴스는 그 스레드에서만 쓰임
+// 이 파일은 C와 C++ 양쪽에서 그대로 포함할 수 있어야 함 (플러그인 작성자에게 이 파일만 배포)
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NAPOLY_BOT_ABI_VERSION 1
+#define NAPOLY_BOT_ENTRY "napoly_bot_api"
+#define NAPOLY_NO_SEAT 0xFF
+
+#if defined(_WIN32)
+#define NAPOLY_BOT_EXPORT __declspec(dllexport)
+#else
+#define NAPOLY_BOT_EXPORT __attribute__((visibility("default")))
+#endif
+
+enum NapolyDecisionKind
+{
+    NAPOLY_DECIDE_NIGHT = 0, // 밤 행동 대상: choice = 생존 좌석 번호, NAPOLY_NO_SEAT이면 행동 없음
+    NAPOLY_DECIDE_VOTE = 1,  // 1차 투표: choice = 생존 좌석 번호, NAPOLY_NO_SEAT이면 기권
+    NAPOLY_DECIDE_FINAL = 2  // 찬반 투표: choice가 0이 아니면 찬성
+};
+
+enum NapolyRole
+{ // 직업 번호 (엔진의 내장 직업 번호와 같음)
+    NAPOLY_ROLE_MAFIA = 0,
+    NAPOLY_ROLE_WEREWOLF = 1,
+    NAPOLY_ROLE_POLICE = 2,
+    NAPOLY_ROLE_DOCTOR = 3,
+    NAPOLY_ROLE_SOLDIER = 4,
+    NAPOLY_ROLE_CITIZEN = 5,
+    NAPOLY_ROLE_DETECTIVE = 6
+};
+
+typedef struct NapolyDecisionBatch
+{ // 좌석 집합은 8비트 마스크 (좌석 s = 비트 s), 배열은 모두 count개이며 decide가 돌아올 때까지만 유효
+    uint32_t kind;           // NapolyDecisionKind (묶음 전체가 같은 종류)
+    uint32_t count;
+    uint32_t seats;          // 게임 인원 (묶음 전체가 같음)
+    uint32_t reserved;
+    const uint64_t* gameId;  // 게임 번호: 같은 시드, 같은 게임 번호로 결정을 정하면 스레드 수와 무관하게 재현됨
+    const uint16_t* day;
+    const uint8_t* seat;     // 결정하는 좌석
+    const uint8_t* role;     // 그 좌석의 직업 (NapolyRole)
+    const uint8_t* alive;    // 생존 좌석
+    const uint8_t* allies;   // 그 좌석이 아는 같은 팀 좌석 (자기 포함): 마피아와 접선한 늑대인간은 서로, 그 밖에는 자기만
+    const uint8_t* candidate; // 찬반 투표 대상 좌석 (NAPOLY_DECIDE_FINAL만, 그 밖에는 NAPOLY_NO_SEAT)
+    uint8_t* choice;         // 출력
+} NapolyDecisionBatch;
+
+typedef struct NapolyBotApi
+{
+    uint32_t abiVersion;     // NAPOLY_BOT_ABI_VERSION
+    uint32_t structSize;     // sizeof(NapolyBotApi): 이후 버전에서 끝에 필드가 늘어도 앞부분은 그대로
+    const char* name;
+    void* (*create)(uint64_t seed); // 시뮬레이션 시드, 엔진 스레드마다 한 번
+    void (*destroy)(void* bot);
+    void (*decide)(void* bot, const NapolyDecisionBatch* batch);
+} NapolyBotApi;
+
+typedef const NapolyBotApi* (*NapolyBotEntry)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOTABI_H
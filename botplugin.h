@@ -0,0 +1,183 @@
+// botplugin.h
+#ifndef BOTPLUGIN_H
+#define BOTPLUGIN_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "botabi.h"
+#include "roles.h"
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+// 봇 플러그인 불러오기와 결정 묶음 (C ABI는 botabi.h)
+// 결정 열은 엔진 스레드마다 한 벌을 두고 단계마다 처음부터 다시 채움 (한 번 늘린 뒤에는 할당 없음)
+
+static_assert(static_cast<int>(NAPOLY_ROLE_MAFIA) == ROLE_MAFIA && static_cast<int>(NAPOLY_ROLE_WEREWOLF) == ROLE_WEREWOLF &&
+    static_cast<int>(NAPOLY_ROLE_POLICE) == ROLE_POLICE && static_cast<int>(NAPOLY_ROLE_DOCTOR) == ROLE_DOCTOR &&
+    static_cast<int>(NAPOLY_ROLE_SOLDIER) == ROLE_SOLDIER && static_cast<int>(NAPOLY_ROLE_CITIZEN) == ROLE_CITIZEN &&
+    static_cast<int>(NAPOLY_ROLE_DETECTIVE) == ROLE_DETECTIVE, "botabi.h role numbers must match RoleType");
+
+class BotPlugin
+{ // 실행 동안 열어 둔 플러그인, 통계는 모든 엔진 스레드의 합계
+private:
+    void* handle = nullptr;
+    const NapolyBotApi* api = nullptr;
+
+public:
+    atomic<uint64_t> decisions{ 0 };
+    atomic<uint64_t> batches{ 0 };
+    atomic<uint64_t> engineNs{ 0 };  // 결정 열을 채우고 결과를 게임에 반영한 시간 (decide 호출 제외)
+    atomic<uint64_t> pluginNs{ 0 };  // decide 안에서 쓴 시간
+
+    BotPlugin() = default;
+    BotPlugin(const BotPlugin&) = delete;
+    BotPlugin& operator=(const BotPlugin&) = delete;
+
+    ~BotPlugin()
+    {
+#ifndef _WIN32
+        if (handle) dlclose(handle);
+#endif
+    }
+
+    bool load(const string& path, string& error)
+    {
+#ifndef _WIN32
+        // 경로에 '/'가 없으면 dlopen이 라이브러리 검색 경로에서 찾으므로 현재 디렉터리 기준으로 바꿈
+        string file = path.find('/') == string::npos ? "./" + path : path;
+        handle = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!handle) {
+            error = dlerror();
+            return false;
+        }
+        NapolyBotEntry entry = reinterpret_cast<NapolyBotEntry>(dlsym(handle, NAPOLY_BOT_ENTRY));
+        if (!entry) {
+            error = string(NAPOLY_BOT_ENTRY) + " 함수를 찾을 수 없습니다";
+            return false;
+        }
+        api = entry();
+        if (!api || api->abiVersion != NAPOLY_BOT_ABI_VERSION || api->structSize < sizeof(NapolyBotApi)) {
+            error = "ABI 버전이 맞지 않습니다 (엔진 " + to_string(NAPOLY_BOT_ABI_VERSION) + ", 플러그인 " +
+                (api ? to_string(api->abiVersion) : string("?")) + ")";
+            api = nullptr;
+            return false;
+        }
+        if (!api->create || !api->destroy || !api->decide) {
+            error = "create/destroy/decide 중 비어 있는 함수가 있습니다";
+            api = nullptr;
+            return false;
+        }
+        return true;
+#else
+        (void)path;
+        error = "이 환경에서는 봇 플러그인을 지원하지 않습니다";
+        return false;
+#endif
+    }
+
+    const NapolyBotApi& entry() const { return *api; }
+    const char* name() const { return api && api->name ? api->name : "?"; }
+};
+
+class BotDecisions
+{ // 엔진 스레드 하나의 봇 인스턴스와 결정 열
+public:
+    BotDecisions(BotPlugin& plugin, uint64_t seed, size_t capacity) : plugin(plugin), count(0), pluginTime(0), decided(0), calls(0)
+    {
+        bot = plugin.entry().create(seed);
+        gameIds.resize(capacity);
+        days.resize(capacity);
+        seats.resize(capacity);
+        roles.resize(capacity);
+        alive.resize(capacity);
+        allies.resize(capacity);
+        candidates.resize(capacity);
+        choices.resize(capacity);
+        lanes.resize(capacity);
+        batch.reserved = 0;
+    }
+
+    ~BotDecisions()
+    {
+        plugin.entry().destroy(bot);
+        plugin.decisions.fetch_add(decided);
+        plugin.batches.fetch_add(calls);
+        plugin.pluginNs.fetch_add(pluginTime);
+        plugin.engineNs.fetch_add(static_cast<uint64_t>(engineTime.count()) > pluginTime
+            ? static_cast<uint64_t>(engineTime.count()) - pluginTime : 0);
+    }
+
+    void begin(NapolyDecisionKind kind, int seatCount)
+    {
+        batch.kind = kind;
+        batch.seats = static_cast<uint32_t>(seatCount);
+        count = 0;
+        started = steady_clock::now();
+    }
+
+    void push(uint32_t lane, uint64_t gameId, int day, int seat, int role, uint8_t aliveSeats, uint8_t allySeats,
+        uint8_t candidate = NAPOLY_NO_SEAT)
+    {
+        gameIds[count] = gameId;
+        days[count] = static_cast<uint16_t>(min(day, 0xFFFF));
+        seats[count] = static_cast<uint8_t>(seat);
+        roles[count] = static_cast<uint8_t>(role);
+        alive[count] = aliveSeats;
+        allies[count] = allySeats;
+        candidates[count] = candidate;
+        lanes[count] = lane;
+        count++;
+    }
+
+    void decide()
+    { // 모은 결정 전체를 decide 한 번으로 넘김
+        if (count == 0) return;
+        batch.count = static_cast<uint32_t>(count);
+        batch.gameId = gameIds.data();
+        batch.day = days.data();
+        batch.seat = seats.data();
+        batch.role = roles.data();
+        batch.alive = alive.data();
+        batch.allies = allies.data();
+        batch.candidate = candidates.data();
+        batch.choice = choices.data();
+        auto before = steady_clock::now();
+        plugin.entry().decide(bot, &batch);
+        pluginTime += static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now() - before).count());
+        decided += count;
+        calls++;
+    }
+
+    void finish() { engineTime += steady_clock::now() - started; } // 결과를 게임에 반영한 뒤
+
+    size_t size() const { return count; }
+    uint32_t lane(size_t i) const { return lanes[i]; }
+    uint8_t seat(size_t i) const { return seats[i]; }
+    uint8_t choice(size_t i) const { return choices[i]; }
+
+private:
+    BotPlugin& plugin;
+    void* bot;
+    NapolyDecisionBatch batch;
+    size_t count;
+    vector<uint64_t> gameIds;
+    vector<uint16_t> days;
+    vector<uint8_t> seats, roles, alive, allies, candidates, choices;
+    vector<uint32_t> lanes; // 결정 i가 속한 레인 (플러그인에는 넘기지 않음)
+    steady_clock::time_point started;
+    steady_clock::duration engineTime{ 0 };
+    uint64_t pluginTime;
+    uint64_t decided;
+    uint64_t calls;
+};
+
+#endif // BOTPLUGIN_H
@@ -0,0 +1,228 @@
+// broadcast.h
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "publicstate.h"
+
+using namespace std;
+
+// 방(게임)별 공개 이벤트 방송: 생산자 하나(게임 스레드), 소비자 다수(관전자 연결)
+// 생산자는 소비자를 기다리지 않고 링을 덮어씀. 뒤처진 소비자는 덮어쓰기를 감지하면
+// 공개 상태 스냅샷(publicstate.h)으로 다시 맞춘 뒤 스냅샷 이후 이벤트부터 이어서 읽음
+
+enum PublicEventType : uint8_t
+{
+    EVENT_PHASE,       // value: PublicPhase, extra: 승리 팀 (PUBLIC_FINISHED일 때)
+    EVENT_DEATH,       // seat: 밤 사이 사망 (낮 발표)
+    EVENT_DEFENDED,    // seat: 방탄복으로 버틴 군인
+    EVENT_SAVED,       // seat: 의사가 살린 플레이어
+    EVENT_QUIET,       // 아무 일도 없던 밤
+    EVENT_VOTE_TALLY,  // seat: 후보, value: 득표 수
+    EVENT_VOTE_VOID,   // value: 0 투표 없음, 1 동률
+    EVENT_FINAL_VOTE,  // seat: 후보, value: 찬성, extra: 반대
+    EVENT_EXECUTION,   // seat: 처형된 플레이어
+    EVENT_TYPE_COUNT
+};
+
+const uint8_t EVENT_NO_SEAT = 0xFF;
+
+const char* publicEventName(uint8_t type)
+{
+    static const char* names[EVENT_TYPE_COUNT] = {
+        "phase", "death", "defended", "saved", "quiet",
+        "vote_tally", "vote_void", "final_vote", "execution" };
+    return type < EVENT_TYPE_COUNT ? names[type] : "?";
+}
+
+struct PublicEvent
+{ // 16바이트 고정 크기
+    uint64_t gameId;
+    uint16_t day;
+    uint8_t type;
+    uint8_t seat;
+    uint16_t value;
+    uint16_t extra;
+};
+
+static_assert(sizeof(PublicEvent) == 16, "슬롯당 두 워드");
+
+class BroadcastRing
+{ // 슬롯마다 순번을 둔 덮어쓰기 링 (슬롯 단위 seqlock)
+public:
+    static const size_t CAPACITY = 1 << 12;
+    static const size_t MASK = CAPACITY - 1;
+
+    enum ReadResult { READ_OK, READ_EMPTY, READ_OVERRUN };
+
+private:
+    struct alignas(32) Slot
+    {
+        atomic<uint64_t> version; // 2 * 위치 + 1: 쓰는 중, 2 * 위치 + 2: 완료
+        atomic<uint64_t> words[2];
+    };
+
+    unique_ptr<Slot[]> slots;
+    alignas(64) atomic<uint64_t> head; // 다음에 쓸 위치 = 지금까지 게시한 이벤트 수
+
+public:
+    BroadcastRing() : slots(new Slot[CAPACITY]), head(0)
+    {
+        for (size_t i = 0; i < CAPACITY; i++) {
+            slots[i].version.store(0, memory_order_relaxed);
+            slots[i].words[0].store(0, memory_order_relaxed);
+            slots[i].words[1].store(0, memory_order_relaxed);
+        }
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    void publish(const PublicEvent& event)
+    { // 게임 스레드 전용, 대기 없음
+        uint64_t words[2];
+        memcpy(words, &event, sizeof(event));
+
+        uint64_t position = head.load(memory_order_relaxed);
+        Slot& slot = slots[position & MASK];
+        slot.version.store(2 * position + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        slot.words[0].store(words[0], memory_order_relaxed);
+        slot.words[1].store(words[1], memory_order_relaxed);
+        slot.version.store(2 * position + 2, memory_order_release);
+        head.store(position + 1, memory_order_release);
+    }
+
+    uint64_t published() const { return head.load(memory_order_acquire); }
+
+    ReadResult tryRead(uint64_t position, PublicEvent& out) const
+    {
+        const Slot& slot = slots[position & MASK];
+        uint64_t expected = 2 * position + 2;
+        uint64_t before = slot.version.load(memory_order_acquire);
+        if (before < expected) return READ_EMPTY;    // 아직 안 쓰였거나 쓰는 중
+        if (before > expected) return READ_OVERRUN;  // 한 바퀴 이상 뒤처져 덮어쓰임
+
+        uint64_t words[2];
+        words[0] = slot.words[0].load(memory_order_relaxed);
+        words[1] = slot.words[1].load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (slot.version.load(memory_order_relaxed) != before) return READ_OVERRUN;
+
+        memcpy(&out, words, sizeof(out));
+        return READ_OK;
+    }
+};
+
+class SpectatorRoom
+{ // 방 하나: 공개 상태 스냅샷 + 이벤트 링
+public:
+    PublicStateChannel state;
+    BroadcastRing events;
+
+    void attach(); // 호출한 스레드(게임 스레드)의 게시 대상으로 지정
+};
+
+thread_local BroadcastRing* eventRing = nullptr; // 현재 스레드의 이벤트 게시 대상 (nullptr이면 생략)
+
+void SpectatorRoom::attach()
+{
+    publicChannel = &state;
+    eventRing = &events;
+}
+
+SpectatorRoom interactiveRoom; // 대화형 게임이 게시하는 방
+
+void applyPublicEvent(PublicState& view, const PublicEvent& event)
+{ // 스냅샷에 이벤트를 반영 (같은 이벤트를 다시 반영해도 결과가 같음)
+    switch (event.type) {
+    case EVENT_PHASE:
+        view.day = event.day;
+        view.phase = static_cast<uint8_t>(event.value);
+        view.winner = static_cast<uint8_t>(event.extra);
+        break;
+    case EVENT_DEATH:
+    case EVENT_EXECUTION:
+        if (event.seat < PUBLIC_MAX_SEATS) {
+            view.aliveMask &= static_cast<uint8_t>(~(1u << event.seat));
+            view.deathDay[event.seat] = static_cast<uint8_t>(event.day);
+            view.deathCause[event.seat] = event.type == EVENT_DEATH ? DEATH_NIGHT : DEATH_EXECUTION;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+class SpectatorCursor
+{ // 관전자 한 명의 읽기 위치와 재구성한 공개 상태
+private:
+    const SpectatorRoom& room;
+    uint64_t position = 0;
+    PublicState view;
+
+public:
+    uint64_t received = 0;  // 받은 이벤트 수
+    uint64_t resyncs = 0;   // 덮어쓰기 감지 후 스냅샷으로 다시 맞춘 횟수
+    uint64_t skipped = 0;   // 다시 맞추며 건너뛴 이벤트 수
+
+    explicit SpectatorCursor(const SpectatorRoom& r) : room(r)
+    {
+        memset(&view, 0, sizeof(view));
+        room.state.read(view);
+        position = view.eventCount;
+    }
+
+    const PublicState& state() const { return view; }
+    uint64_t nextPosition() const { return position; }
+
+    void adopt(const PublicState& snapshot)
+    { // 스냅샷으로 교체하고 스냅샷 이후 이벤트부터 읽음
+        if (snapshot.eventCount > position) skipped += snapshot.eventCount - position;
+        view = snapshot;
+        position = snapshot.eventCount;
+    }
+
+    void resync()
+    {
+        PublicState snapshot;
+        room.state.read(snapshot);
+        adopt(snapshot);
+        resyncs++;
+    }
+
+    template <typename Fn>
+    size_t poll(Fn&& onEvent, size_t maxEvents = 256)
+    { // 새 이벤트를 최대 maxEvents개 처리, 처리한 수 반환 (0이면 새 이벤트 없음)
+        size_t handled = 0;
+        PublicEvent event;
+        while (handled < maxEvents) {
+            BroadcastRing::ReadResult result = room.events.tryRead(position, event);
+            if (result == BroadcastRing::READ_EMPTY) break;
+            if (result == BroadcastRing::READ_OVERRUN) {
+                resync();
+                continue;
+            }
+            if (event.gameId != view.gameId) {
+                // 다른 게임: 좌석과 이름은 스냅샷에만 있으므로 이 이벤트 이후의 스냅샷으로 시작
+                // (아직 게시 전이면 다음에 재시도)
+                PublicState snapshot;
+                room.state.read(snapshot);
+                if (snapshot.eventCount <= position) break;
+                adopt(snapshot);
+                continue;
+            }
+            applyPublicEvent(view, event);
+            onEvent(event);
+            position++;
+            received++;
+            handled++;
+        }
+        return handled;
+    }
+};
+
+#endif // BROADCAST_H
@@ -0,0 +1,311 @@
+// catalog.h
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// 실행 파일에 넣어 둔 게임 문구 (규칙 전문과 메시지 틀)
+// 틀의 {0}~{7}은 인자 자리이며, 컴파일할 때 글자 조각과 인자 자리로 미리 나눠 둠
+// 메시지 하나를 만들 때는 길이를 한 번 계산해 버퍼를 잡고 조각을 차례로 붙이기만 함 (로케일 전환, 파일 읽기 없음)
+// 다른 언어는 같은 순서의 틀 배열과 규칙 전문을 만들어 catalogs에 한 줄 추가하면 됨 (NAPOLY_LANG으로 선택)
+
+enum MessageId
+{ // 틀 배열의 순서와 같아야 함
+    // 밤 행동 결과 (nightResults)
+    MSG_ATTACKED_BY_MAFIA,
+    MSG_KILL_ACTION,
+    MSG_INVESTIGATE_ACTION,
+    MSG_HEAL_ACTION,
+    MSG_HUNT_ACTION,
+    MSG_POLICE_IS_MAFIA,
+    MSG_POLICE_NOT_MAFIA,
+    MSG_HEAL_CHOSEN,
+    MSG_HUNT_CHOSEN,
+    MSG_TRACK_CHOSEN,
+    MSG_TRACK_NOBODY,
+    MSG_TRACK_RESULT,
+    MSG_ARMOR_HELD,
+    MSG_YOU_DIED,
+    MSG_WEREWOLF_TAMED,
+    MSG_MAFIA_CONTACT,
+    MSG_RESULT_RECEIVED,
+    MSG_RESULT_ACTION,
+    MSG_RESULT_NOTHING,
+    // 밤 차례 (yourTurn)
+    MSG_ABILITY_BLOCKED,
+    MSG_NO_NIGHT_ROLE,
+    MSG_TARGET_ITEM,
+    MSG_MAFIA_TEAM_HEADER,
+    MSG_TEAM_MEMBER,
+    MSG_TEAM_WEREWOLF,
+    MSG_WEREWOLF_TARGET,
+    MSG_OTHER_MAFIA_TARGET,
+    MSG_ASK_YES_NO,
+    MSG_TARGET_KEPT,
+    MSG_MAFIA_TARGET,
+    MSG_CHOOSE_TARGET,
+    MSG_INVALID_INPUT,
+    MSG_ABILITY_CANCELLED,
+    MSG_ABILITY_DONE,
+    MSG_INVALID_CHOICE,
+    // 낮 발표 (startDay)
+    MSG_DAY_HEADER,
+    MSG_ARMOR_DEFENDED,
+    MSG_DOCTOR_SAVED,
+    MSG_PLAYER_DIED,
+    MSG_NOTHING_HAPPENED,
+    MSG_SURVIVORS_HEADER,
+    MSG_DISCUSSION,
+    // 밤 진행, 투표, 승리 (startNight, startVoting, checkVictoryCondition)
+    MSG_NIGHT_HEADER,
+    MSG_YOUR_TURN,
+    MSG_RESULTS_HEADER,
+    MSG_VOTE_HEADER,
+    MSG_FINAL_VOTE_HEADER,
+    MSG_FINAL_VOTE_RESULT,
+    MSG_EXECUTED,
+    MSG_FINAL_VOTE_FAILED,
+    MSG_NOBODY_VOTED,
+    MSG_VOTE_TIED,
+    MSG_CITIZEN_WIN,
+    MSG_MAFIA_WIN,
+    // 소켓 테이블 (table.h)
+    MSG_TABLE_LISTENING,
+    MSG_TABLE_JOINED,
+    MSG_TABLE_NAME_TAKEN,
+    MSG_TABLE_NIGHT_PROMPT,
+    MSG_TABLE_MAFIA_TARGET,
+    MSG_TABLE_VOTE_PROMPT,
+    MSG_TABLE_FINAL_PROMPT,
+    MSG_TABLE_ACCEPTED,
+    MSG_TABLE_ALREADY,
+    MSG_TABLE_TIMEOUT,
+    MSG_TABLE_LEFT,
+    // 중단된 게임 이어서 진행 (checkpoint.h)
+    MSG_CHECKPOINT_FOUND,
+    MSG_CHECKPOINT_RESUMED,
+    // 규칙 화면 (gameRule)
+    MSG_RULES_HEADER,
+    MSG_PRESS_ENTER,
+    MESSAGE_COUNT
+};
+
+struct MessageTemplate
+{ // 미리 나눈 틀: 조각 i는 arg[i] < 0이면 text의 [offset, offset + length), 아니면 arg[i]번째 인자
+    static constexpr int MAX_PARTS = 8;
+    const char* text;
+    uint16_t offset[MAX_PARTS];
+    uint16_t length[MAX_PARTS];
+    int8_t arg[MAX_PARTS];
+    uint8_t parts;
+    uint16_t literalBytes; // 글자 조각 길이의 합
+};
+
+constexpr MessageTemplate splitTemplate(const char* text)
+{ // 상수 식에서만 호출 (조각이 너무 많으면 컴파일 오류)
+    MessageTemplate t{ text, {}, {}, {}, 0, 0 };
+    int start = 0;
+    int i = 0;
+    auto literal = [&t](int from, int to) {
+        if (to == from) return;
+        if (t.parts == MessageTemplate::MAX_PARTS) throw "too many message parts";
+        t.offset[t.parts] = static_cast<uint16_t>(from);
+        t.length[t.parts] = static_cast<uint16_t>(to - from);
+        t.arg[t.parts] = -1;
+        t.parts++;
+        t.literalBytes = static_cast<uint16_t>(t.literalBytes + (to - from));
+    };
+    for (; text[i]; i++) {
+        if (text[i] != '{' || text[i + 1] < '0' || text[i + 1] > '7' || text[i + 2] != '}') continue;
+        literal(start, i);
+        if (t.parts == MessageTemplate::MAX_PARTS) throw "too many message parts";
+        t.arg[t.parts++] = static_cast<int8_t>(text[i + 1] - '0');
+        start = i + 3;
+        i += 2;
+    }
+    literal(start, i);
+    return t;
+}
+
+constexpr MessageTemplate koreanMessages[] = {
+    splitTemplate("마피아에게 공격받았습니다."),
+    splitTemplate("{0}님을 처치 대상으로 지정합니다."),
+    splitTemplate("{0}을(를) 조사합니다."),
+    splitTemplate("{0}을(를) 치료합니다."),
+    splitTemplate("{0}을(를) 먹잇감으로 선정합니다."),
+    splitTemplate("{0}(은)는 마피아입니다."),
+    splitTemplate("{0}(은)는 마피아가 아닙니다."),
+    splitTemplate("{0}을(를) 치료하기로 했습니다."),
+    splitTemplate("{0}님을 대상으로 지정했습니다."),
+    splitTemplate("{0}님을 뒤쫓기로 했습니다."),
+    splitTemplate("{0}님은 이번 밤 아무도 지목하지 않았습니다."),
+    splitTemplate("{0}님은 이번 밤 {1}님을 지목했습니다."),
+    splitTemplate("마피아가 당신에게 총을 겨누었지만, 방탄복으로 버텨냈습니다."),
+    splitTemplate("당신은 사망하셨습니다."),
+    splitTemplate("{0}님은 늑대인간이며 당신에게 길들여졌습니다!"),
+    splitTemplate("{0}님이 마피아이며 당신과 접선하였습니다!"),
+    splitTemplate("[받은 영향] {0}\n"),
+    splitTemplate("[행동 결과] {0}\n"),
+    splitTemplate("[받은 영향] 아무런 일도 일어나지 않았습니다...\n"),
+
+    splitTemplate("현재 능력을 사용할 수 없습니다.\n"),
+    splitTemplate("당신은 밤에 수행할 수 있는 역할이 없습니다.\n"),
+    splitTemplate("{0}. {1}\n"),
+    splitTemplate("\n=== 마피아 팀 정보 ===\n"),
+    splitTemplate("{0}님은 {1}입니다.\n"),
+    splitTemplate("{0}님은 늑대인간입니다.\n"),
+    splitTemplate("\n늑대인간이 {0}님을 살육의 대상으로 지정했습니다.\n"),
+    splitTemplate("\n다른 마피아가 {0}님을 처치 대상으로 지목했습니다.\n바꾸시겠습니까? (Y/N): "),
+    splitTemplate("잘못된 입력입니다. Y 또는 N을 입력해주세요: "),
+    splitTemplate("잘못된 입력입니다. 타겟을 변경하지 않습니다.\n"),
+    splitTemplate("\n마피아가 {0}님을 처치 대상으로 지목했습니다.\n"),
+    splitTemplate("\n능력을 사용할 대상을 선택하세요 (0: 능력 사용하지 않음): "),
+    splitTemplate("잘못된 입력입니다.\n"),
+    splitTemplate("능력 사용을 취소했습니다.\n"),
+    splitTemplate("능력 사용이 완료되었습니다.\n"),
+    splitTemplate("잘못된 선택입니다. 다시 선택해주세요.\n"),
+
+    splitTemplate("\n=== {0}번째 날이 밝았습니다 ===\n"),
+    splitTemplate("{0}님이 방탄복으로 마피아의 총격을 버텨냈습니다!\n"),
+    splitTemplate("{0}님이 의사의 치료를 받고 살아났습니다!\n"),
+    splitTemplate("{0}님이 사망했습니다."),
+    splitTemplate("아무런 일도 일어나지 않았습니다.\n"),
+    splitTemplate("\n=== 생존자 목록 ===\n"),
+    splitTemplate("\n토론 시간입니다. {0}초 후 투표가 시작됩니다...\n"),
+
+    splitTemplate("\n=== {0}번째 밤이 되었습니다 ===\n\n"),
+    splitTemplate("\n=== {0}님의 차례 ===\n당신의 직업은 {1}입니다.\n\n"),
+    splitTemplate("\n=== {0}님의 결과 ===\n"),
+    splitTemplate("\n=== 투표를 시작합니다 ===\n"),
+    splitTemplate("\n=== {0}님에 대한 최종 찬반 투표를 진행합니다 ===\n"),
+    splitTemplate("\n=== 찬반 투표 결과 ===\n찬성: {0}표\n반대: {1}표\n"),
+    splitTemplate("{0}님이 투표로 처형되었습니다.\n"),
+    splitTemplate("과반수를 넘기지 않아 무효처리 되었습니다.\n"),
+    splitTemplate("\n아무도 투표하지 않았습니다\n"),
+    splitTemplate("투표자 동률 발생으로 인해 투표가 무효처리 되었습니다\n"),
+    splitTemplate("\n시민 팀이 승리했습니다!\n"),
+    splitTemplate("\n마피아 팀이 승리했습니다\n"),
+
+    splitTemplate("{0}에서 {1}명을 기다립니다. 각자 napoly join {0} 이름 으로 접속하세요.\n"),
+    splitTemplate("{0}님이 {1}번 좌석에 앉았습니다. ({2}/{3}명)\n"),
+    splitTemplate("이미 사용 중이거나 쓸 수 없는 이름입니다.\n"),
+    splitTemplate("\n능력을 사용할 대상 번호를 보내주세요 (0: 능력 사용하지 않음, {0}초 안에): "),
+    splitTemplate("\n{0}님이 처치 대상을 {1}님으로 정했습니다. 바꾸려면 다른 번호를 보내주세요.\n"),
+    splitTemplate("\n투표할 대상 번호를 보내주세요 (0: 기권, {0}초 안에): "),
+    splitTemplate("\n{0}님 처형에 찬성하면 1, 반대하면 2를 보내주세요 ({1}초 안에): "),
+    splitTemplate("접수되었습니다. 다른 플레이어를 기다립니다...\n"),
+    splitTemplate("이미 제출했습니다.\n"),
+    splitTemplate("\n시간이 지나 선택 없이 넘어갑니다.\n"),
+    splitTemplate("{0}님의 연결이 끊어졌습니다.\n"),
+
+    splitTemplate("\n중단된 게임 #{0}이 있습니다 ({1}일차, 참가자: {2}). 이어서 진행하시겠습니까? (Y/N): "),
+    splitTemplate("\n=== 게임 #{0}을 {1}일차부터 이어서 진행합니다 ===\n"),
+
+    splitTemplate("\n=== 마피아 게임 규칙 ===\n\n"),
+    splitTemplate("계속하려면 Enter키를 눌러주세요..."),
+};
+static_assert(sizeof(koreanMessages) / sizeof(koreanMessages[0]) == MESSAGE_COUNT, "koreanMessages must list every MessageId");
+
+constexpr const char koreanRules[] =
+R"RULES(<기본 규칙>
+6~8명의 플레이어가 게임을 진행할 수 있다.
+게임 시작시, 각 플레이어는 랜덤으로 직업이 부여되며 마피아팀과 시민팀으로 나뉜다.
+게임은 낮과 밤으로 진행되며, 밤에는 각 플레이어마다 고유 능력을 사용할 수 있다.
+낮에는 토론 및 투표를 통해 용의자를 지목하여, '처형'한다.
+마피아 팀을 모두 제거하면 시민 팀의 승리이며, 마피아와 시민의 숫자가 같아지면 마피아 팀이 승리한다.
+각 팀별 고유 능력은 다음과 같다.
+
+<마피아 팀>
+마피아 - 밤에 플레이어 한 명을 지목하여, 그 플레이어를 총으로 '처치'한다.
+
+늑대인간 - 자신이 밤에 선택한 플레이어가 마피아에게 살해 당하거나 자신이 마피아의 ‘처치’ 능력의 대상이 되었을 경우,
+마피아의 ‘처치’ 능력을 무시하고 마피아에게 길들여진다.
+길들여진 이후, 의사의 '치료'를 무시하고 선택한 대상을 '살육'할 수 있다.
+
+<시민 팀>
+경찰 - 밤에 의심 가는 사람 하나를 지목하여 그 사람이 마피아인지 아닌지 알 수 있다.
+마피아 팀인 늑대인간의 여부는 알 수 없다.
+
+의사 - 밤마다 한 사람을 지목하여 대상이 총으로 공격받을 경우, 대상을 '치료'한다.
+
+군인 - '방탄복' 소지시, 총격에 의한 '처치'를 1회 버틸 수 있다. '처형'을 무효화하지는 못한다.
+
+사립 탐정 - 밤에 플레이어 한 명을 지목한다. 해당 플레이어가 능력을 선택한 대상을 알 수 있다.
+
+시민 - 아무런 능력을 가지지 않는다.
+
+<우선 순위>
+
+군인 - 의사 : 군인이 '방탄복' 소지시, 의사에 의한 '치료'보다 먼저 적용된다. 따라서 '방탄복'을 소지한
+군인에게는 치료 능력은 무효화된다.
+
+)RULES";
+
+struct MessageCatalog
+{
+    const char* code;                  // NAPOLY_LANG 값
+    const MessageTemplate* messages;   // MESSAGE_COUNT개
+    string_view rules;
+};
+
+constexpr MessageCatalog catalogs[] = {
+    { "ko", koreanMessages, string_view(koreanRules, sizeof(koreanRules) - 1) },
+};
+
+const MessageCatalog* activeCatalog = &catalogs[0];
+
+bool selectCatalog(const char* code)
+{ // 없는 언어면 그대로 두고 false
+    for (const MessageCatalog& catalog : catalogs) {
+        if (strcmp(catalog.code, code) == 0) {
+            activeCatalog = &catalog;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class... Args>
+void appendMessage(string& out, MessageId id, const Args&... args)
+{ // 인자는 string_view로 바뀌는 값 (숫자는 호출하는 쪽에서 to_string)
+    const MessageTemplate& t = activeCatalog->messages[id];
+    const string_view values[sizeof...(Args) + 1] = { string_view(args)... };
+    size_t bytes = t.literalBytes;
+    for (int i = 0; i < t.parts; i++) {
+        if (t.arg[i] >= 0 && t.arg[i] < static_cast<int>(sizeof...(Args))) bytes += values[t.arg[i]].size();
+    }
+    out.reserve(out.size() + bytes);
+    for (int i = 0; i < t.parts; i++) {
+        if (t.arg[i] < 0) out.append(t.text + t.offset[i], t.length[i]);
+        else if (t.arg[i] < static_cast<int>(sizeof...(Args))) out.append(values[t.arg[i]]);
+    }
+}
+
+template <class... Args>
+string formatMessage(MessageId id, const Args&... args)
+{
+    string out;
+    appendMessage(out, id, args...);
+    return out;
+}
+
+template <class... Args>
+void printMessage(MessageId id, const Args&... args)
+{ // 한 번에 출력 (버퍼는 호출마다 새로 잡음: 게임 중에는 게임 아레나에서 나오므로 게임보다 오래 두면 안 됨)
+    string line;
+    appendMessage(line, id, args...);
+    cout.write(line.data(), static_cast<streamsize>(line.size()));
+}
+
+void printRules()
+{
+    cout.write(activeCatalog->rules.data(), static_cast<streamsize>(activeCatalog->rules.size()));
+}
+
+#endif // CATALOG_H
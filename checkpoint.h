@@ -0,0 +1,277 @@
+// checkpoint.h
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "auditlog.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// 단계 경계 체크포인트: 게임 상태를 256바이트 레코드로 남겨, 게임을 돌리던 프로세스가 죽어도 방(게임)마다 마지막 체크포인트부터 이어서 진행
+// 게임 스레드는 레코드를 넣기만 하고, 결과를 보여 주기 전이면 그 레코드가 들어간 묶음의 fsync를 기다림
+// 기록 스레드는 fsync하는 동안 다른 방들이 넣은 레코드를 다음 묶음으로 한꺼번에 기록하므로 fsync는 방마다가 아니라 묶음마다 한 번 (그룹 커밋)
+// 파일은 프레임(magic, 레코드 수, CRC32, 레코드)의 나열이며, 열 때 방마다 마지막 레코드만 남겨 다시 씀 (잘린 꼬리도 이때 사라짐)
+
+const int CHECKPOINT_MAX_SEATS = 8;
+const int CHECKPOINT_NAME_BYTES = 24;
+const uint32_t CHECKPOINT_FRAME_MAGIC = 0x4B43504E; // "NPCK"
+
+enum CheckpointPhase : uint8_t
+{
+    CHECKPOINT_DEALT,          // 직업 배정 직후 (첫 밤부터 진행)
+    CHECKPOINT_NIGHT_RESOLVED, // processActions 직후 (밤 사망은 좌석 비트로만 있고 아직 반영 전)
+    CHECKPOINT_DAY_APPLIED,    // 낮 발표에서 사망을 반영한 직후 (토론과 투표부터)
+    CHECKPOINT_VOTED,          // 투표 직후 (승리 판정 후 다음 밤부터)
+    CHECKPOINT_FINISHED        // 끝났거나 이어서 진행하지 않기로 한 방
+};
+
+enum CheckpointRoom : uint8_t
+{ // 레코드를 남긴 진행 방식 (이어서 진행할 때 같은 방식의 방만 찾음)
+    CHECKPOINT_ROOM_CONSOLE,    // 대화형 진행 (한 화면을 돌려 가며 입력)
+    CHECKPOINT_ROOM_TABLE,      // 소켓 테이블 (table.h)
+    CHECKPOINT_ROOM_SIMULATION  // napoly simulate --checkpoint
+};
+
+thread_local CheckpointRoom checkpointRoom = CHECKPOINT_ROOM_CONSOLE; // 이 스레드가 진행하는 방
+
+struct GameCheckpoint
+{ // 256바이트 고정 크기, 좌석 비트는 좌석 s = 비트 s
+    uint64_t gameId;        // 방 번호 (방마다 파일에서 가장 나중 레코드가 유효)
+    uint64_t rngPosition;   // 봇 결정 스트림에서 꺼낸 난수 개수 (시뮬레이션)
+    uint64_t seed;          // 실행 시드 (시뮬레이션은 같은 시드의 기록만 이어받음)
+    uint16_t day;
+    uint8_t phase;          // CheckpointPhase
+    uint8_t seats;
+    uint8_t roles[CHECKPOINT_MAX_SEATS];
+    uint8_t alive;          // 생존 좌석 (NIGHT_RESOLVED에서는 밤 사망 반영 전)
+    uint8_t armor;          // 방탄복이 남은 군인
+    uint8_t tamed;
+    uint8_t rules;          // 비트 0: doctorBeatsArmor, 비트 1: policeSeesWerewolf
+    uint8_t shot, hunted, healed, defended, dying; // 밤 판정 결과 (NIGHT_RESOLVED, FINISHED)
+    uint8_t winner;         // FINISHED: 0 무승부 또는 중단, 1 시민, 2 마피아
+    uint8_t room;           // CheckpointRoom
+    uint8_t findings[CHECKPOINT_MAX_SEATS]; // NIGHT_RESOLVED: 좌석별 밤 행동, 하위 4비트는 대상 + 1 (0이면 행동 없음)
+                                            // 상위 4비트는 경찰이면 마피아 판정(1), 사립 탐정이면 대상이 고른 좌석 + 1
+    uint8_t tamedTonight;   // NIGHT_RESOLVED: 이번 밤에 접선함 (마피아 팀과 늑대인간에게 알림)
+    uint8_t reserved[8];
+    char names[CHECKPOINT_MAX_SEATS][CHECKPOINT_NAME_BYTES];
+};
+static_assert(sizeof(GameCheckpoint) == 256, "GameCheckpoint must stay 256 bytes");
+
+class CheckpointLog
+{
+private:
+    mutex lock;
+    condition_variable wake;     // 기록 스레드 깨우기
+    condition_variable durable;  // 묶음 fsync 완료
+    vector<GameCheckpoint> pending;
+    uint64_t submitted = 0;      // 지금까지 넣은 레코드 수 (티켓)
+    uint64_t committed = 0;      // fsync까지 끝난 레코드 수
+    uint64_t batches = 0;
+    uint64_t largestBatch = 0;
+    bool running = false;
+    bool grouped = true;         // false면 레코드마다 fsync (비교용)
+    atomic<bool> enabled{ false };
+    FILE* file = nullptr;
+    string path;
+    thread writer;
+    map<uint64_t, GameCheckpoint> rooms; // 열 때 읽은 방별 마지막 레코드 (압축 후에는 끝나지 않은 방만)
+    uint64_t highWater = 0;              // 파일에 남았던 가장 큰 게임 번호
+
+    static void syncFile(FILE* out)
+    {
+        fflush(out);
+#ifdef _WIN32
+        _commit(_fileno(out));
+#else
+        fsync(fileno(out));
+#endif
+    }
+
+    static void writeFrame(FILE* out, const GameCheckpoint* records, size_t count)
+    {
+        uint32_t header[4] = {
+            CHECKPOINT_FRAME_MAGIC,
+            static_cast<uint32_t>(count),
+            auditcodec::crc32(reinterpret_cast<const uint8_t*>(records), count * sizeof(GameCheckpoint)),
+            0 };
+        fwrite(header, sizeof(header), 1, out);
+        fwrite(records, sizeof(GameCheckpoint), count, out);
+    }
+
+    void run()
+    {
+        vector<GameCheckpoint> batch;
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            wake.wait(guard, [this] { return !pending.empty() || !running; });
+            if (pending.empty()) break; // 멈추는 중이고 남은 레코드 없음
+            batch.swap(pending);
+            guard.unlock();
+
+            if (grouped) {
+                writeFrame(file, batch.data(), batch.size());
+                syncFile(file);
+            }
+            else {
+                for (const GameCheckpoint& record : batch) {
+                    writeFrame(file, &record, 1);
+                    syncFile(file);
+                }
+            }
+
+            guard.lock();
+            committed += batch.size();
+            batches += grouped ? 1 : batch.size();
+            largestBatch = max<uint64_t>(largestBatch, grouped ? batch.size() : 1);
+            batch.clear();
+            durable.notify_all();
+        }
+    }
+
+    bool compact()
+    { // 끝나지 않은 방마다 마지막 레코드만 임시 파일에 쓰고 fsync 후 바꿔 끼움
+        string tempPath = path + ".tmp";
+        FILE* out = fopen(tempPath.c_str(), "wb");
+        if (!out) return false;
+        vector<GameCheckpoint> latest;
+        for (auto it = rooms.begin(); it != rooms.end();) { // 끝난 방은 버리고, 가장 큰 번호의 방만 끝났어도 남겨 번호 발급이 겹치지 않게 함
+            if (it->second.phase != CHECKPOINT_FINISHED) {
+                latest.push_back(it->second);
+                ++it;
+                continue;
+            }
+            if (it->first == highWater) latest.push_back(it->second);
+            it = rooms.erase(it);
+        }
+        if (!latest.empty()) writeFrame(out, latest.data(), latest.size());
+        syncFile(out);
+        fclose(out);
+        if (rename(tempPath.c_str(), path.c_str()) != 0) return false;
+#ifndef _WIN32
+        string directory = path.find('/') == string::npos ? "." : path.substr(0, path.rfind('/') + 1);
+        int dirFd = open(directory.c_str(), O_RDONLY);
+        if (dirFd >= 0) { // rename 자체가 남도록
+            fsync(dirFd);
+            close(dirFd);
+        }
+#endif
+        return true;
+    }
+
+public:
+    ~CheckpointLog() { stop(); }
+
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+
+    bool start(const string& checkpointPath, bool groupCommit = true)
+    { // 기존 파일을 읽어 방별 마지막 상태를 모은 뒤 압축하고 이어 씀
+        if (running) return true;
+        path = checkpointPath;
+        grouped = groupCommit;
+        rooms.clear();
+        readCheckpointFile(path, [this](const GameCheckpoint& record) { rooms[record.gameId] = record; });
+        highWater = rooms.empty() ? 0 : rooms.rbegin()->first;
+        if (!compact()) return false;
+        file = fopen(path.c_str(), "ab");
+        if (!file) return false;
+        running = true;
+        submitted = committed = batches = largestBatch = 0;
+        writer = thread(&CheckpointLog::run, this);
+        enabled.store(true, memory_order_release);
+        return true;
+    }
+
+    void stop()
+    { // 넣은 레코드를 모두 기록하고 닫음
+        if (!running) return;
+        enabled.store(false, memory_order_release);
+        {
+            lock_guard<mutex> guard(lock);
+            running = false;
+        }
+        wake.notify_one();
+        if (writer.joinable()) writer.join();
+        fclose(file);
+        file = nullptr;
+    }
+
+    uint64_t submit(const GameCheckpoint& record)
+    { // 반환값은 waitDurable에 넘길 티켓
+        lock_guard<mutex> guard(lock);
+        pending.push_back(record);
+        wake.notify_one();
+        return ++submitted;
+    }
+
+    void waitDurable(uint64_t ticket)
+    {
+        unique_lock<mutex> guard(lock);
+        durable.wait(guard, [&] { return committed >= ticket; });
+    }
+
+    void commit(const GameCheckpoint& record) { waitDurable(submit(record)); }
+
+    const map<uint64_t, GameCheckpoint>& recovered() const { return rooms; } // 열 때 끝나지 않았던 방들
+
+    uint64_t durableRecords()
+    {
+        lock_guard<mutex> guard(lock);
+        return committed;
+    }
+
+    uint64_t syncCount()
+    {
+        lock_guard<mutex> guard(lock);
+        return batches;
+    }
+
+    uint64_t maxGameId() const { return highWater; }
+
+    void printSummary(ostream& out)
+    {
+        lock_guard<mutex> guard(lock);
+        out << "체크포인트: " << committed << "건, fsync " << batches << "회 (묶음당 평균 " << fixed << setprecision(1)
+            << (batches ? static_cast<double>(committed) / batches : 0.0) << "건, 최대 " << largestBatch << "건)\n";
+        out.unsetf(ios::fixed);
+    }
+
+    template <class Fn>
+    static long readCheckpointFile(const string& filePath, Fn&& visit)
+    { // 온전한 프레임의 레코드를 파일 순서대로 넘김, 반환값은 온전한 부분의 길이
+        FILE* in = fopen(filePath.c_str(), "rb");
+        if (!in) return 0;
+        long valid = 0;
+        vector<GameCheckpoint> records;
+        uint32_t header[4];
+        while (fread(header, sizeof(header), 1, in) == 1 && header[0] == CHECKPOINT_FRAME_MAGIC && header[1] <= (1u << 24)) {
+            records.resize(header[1]);
+            if (fread(records.data(), sizeof(GameCheckpoint), records.size(), in) != records.size()) break;
+            if (auditcodec::crc32(reinterpret_cast<const uint8_t*>(records.data()), records.size() * sizeof(GameCheckpoint)) != header[2]) break;
+            for (const GameCheckpoint& record : records) visit(record);
+            valid = ftell(in);
+        }
+        fclose(in);
+        return valid;
+    }
+};
+
+CheckpointLog checkpointLog;
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,84 @@
+// conflict.h
+#ifndef CONFLICT_H
+#define CONFLICT_H
+
+#include <cstdint>
+
+using namespace std;
+
+// 밤 행동 충돌 표: 한 좌석의 결과(사망, 방탄복 소모, 늑대인간 접선)는 그 좌석에 모인 행동과 좌석 상태만으로 정해짐
+// 처리 순서(늑대인간 -> 의사 -> 마피아)에 따른 충돌 규칙을 게임 시작 시 규칙 선택지별로 128칸 표로 미리 계산해 두고,
+// processActions는 좌석마다 입력 비트를 모아 표를 한 번 찾음
+
+enum NightSeatInput : uint8_t
+{ // 표의 번호 비트
+    SEAT_SHOT = 1,          // 마피아 총격 대상
+    SEAT_HUNTED = 2,        // 늑대인간의 대상
+    SEAT_HEALED = 4,        // 의사의 치료 대상
+    SEAT_ARMORED = 8,       // 방탄복이 남은 군인
+    SEAT_TAMED = 16,        // 밤 시작 시 늑대인간이 접선한 상태 (모든 좌석 공통)
+    SEAT_WEREWOLF = 32,     // 늑대인간 본인
+    SEAT_MAFIA_TARGET = 64, // 마피아가 마지막으로 지목한 대상 (늑대인간 대상과 일치 판정)
+};
+
+enum NightSeatOutcome : uint8_t
+{
+    OUTCOME_DIES = 1,     // 다음 날 사망
+    OUTCOME_DEFENDED = 2, // 방탄복으로 총격을 버팀 (방탄복 소모)
+    OUTCOME_TAMES = 4,    // 늑대인간 접선 (늑대인간을 쏨, 또는 늑대인간과 같은 대상을 쏘아 실제로 죽임)
+};
+
+const int NIGHT_CONFLICT_INPUTS = 128;
+
+class NightConflictTable
+{
+private:
+    uint8_t outcomes[NIGHT_CONFLICT_INPUTS];
+    bool compiled = false;
+    bool compiledRule = false; // 표를 계산할 때의 doctorBeatsArmor
+
+public:
+    NightConflictTable() { compile(false); }
+
+    static uint8_t rule(uint8_t input, bool doctorBeatsArmor)
+    { // 좌석 하나의 판정 (doctorBeatsArmor: GameRules 참고)
+        bool shot = input & SEAT_SHOT;
+        bool hunted = input & SEAT_HUNTED;
+        bool healed = input & SEAT_HEALED;
+        bool tamed = input & SEAT_TAMED;
+
+        // 늑대인간: 접선 후에는 치료보다 먼저 처리되어 치료로 살릴 수 있음, 접선 전에는 마피아 대상과 일치 여부만
+        bool killed = hunted && tamed;
+        bool defended = false;
+        bool tames = false;
+        bool mafiaKill = false;
+        if (shot) {
+            if (input & SEAT_WEREWOLF) tames = !tamed; // 늑대인간을 쏘면 죽이지 않고 즉시 접선
+            else if ((input & SEAT_ARMORED) && !(doctorBeatsArmor && healed)) defended = true; // 치료는 무효
+            else mafiaKill = killed = true;
+        }
+        if (hunted && !tamed && (input & SEAT_MAFIA_TARGET) && mafiaKill && !healed) tames = true;
+
+        uint8_t outcome = 0;
+        if (killed && !healed && !defended) outcome |= OUTCOME_DIES;
+        if (defended) outcome |= OUTCOME_DEFENDED;
+        if (tames) outcome |= OUTCOME_TAMES;
+        return outcome;
+    }
+
+    void compile(bool doctorBeatsArmor)
+    { // 게임 시작 시 호출, 규칙이 그대로면 다시 계산하지 않음
+        if (compiled && compiledRule == doctorBeatsArmor) return;
+        for (int input = 0; input < NIGHT_CONFLICT_INPUTS; input++) {
+            outcomes[input] = rule(static_cast<uint8_t>(input), doctorBeatsArmor);
+        }
+        compiledRule = doctorBeatsArmor;
+        compiled = true;
+    }
+
+    uint8_t operator[](uint8_t input) const { return outcomes[input & (NIGHT_CONFLICT_INPUTS - 1)]; }
+};
+
+thread_local NightConflictTable nightConflicts;
+
+#endif // CONFLICT_H
@@ -0,0 +1,323 @@
+// deal.h
+#ifndef DEAL_H
+#define DEAL_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <chrono>
+#include "rng.h"
+#include "roles.h"
+
+using namespace std;
+using namespace std::chrono;
+
+struct RoleComposition
+{ // 직업별 인원 (덱 구성)
+    uint8_t counts[ROLE_TYPE_COUNT] = {};
+
+    static RoleComposition standard(int players)
+    { // assignRoles의 구성 규칙: 경찰, 의사, 마피아(8명이면 2명), 늑대인간, 군인(8명), 나머지 시민
+        RoleComposition c;
+        c.counts[ROLE_POLICE] = 1;
+        c.counts[ROLE_DOCTOR] = 1;
+        c.counts[ROLE_MAFIA] = players == 8 ? 2 : 1;
+        c.counts[ROLE_WEREWOLF] = 1;
+        c.counts[ROLE_SOLDIER] = players == 8 ? 1 : 0;
+        int special = c.total();
+        c.counts[ROLE_CITIZEN] = static_cast<uint8_t>(players > special ? players - special : 0);
+        return c;
+    }
+
+    int total() const
+    {
+        int sum = 0;
+        for (int role = 0; role < ROLE_TYPE_COUNT; role++) sum += counts[role];
+        return sum;
+    }
+
+    string describe() const
+    { // 예: "마피아2 늑대인간1 경찰1 의사1 군인1 시민2"
+        string text;
+        for (int role = 0; role < ROLE_TYPE_COUNT; role++) {
+            if (!counts[role]) continue;
+            if (!text.empty()) text += " ";
+            text += roleTypeName(role) + to_string(counts[role]);
+        }
+        return text;
+    }
+
+    static bool parse(const string& spec, RoleComposition& out)
+    { // 예: "마피아2,늑대인간,경찰,의사,사립탐정,시민2" (쉼표로 구분, 숫자가 없으면 1명, 직업 이름은 등록부 기준)
+        RoleComposition c;
+        size_t begin = 0;
+        while (begin <= spec.size()) {
+            size_t end = spec.find(',', begin);
+            if (end == string::npos) end = spec.size();
+            string token = spec.substr(begin, end - begin);
+            size_t digits = token.size();
+            while (digits > 0 && token[digits - 1] >= '0' && token[digits - 1] <= '9') digits--;
+            int count = digits < token.size() ? atoi(token.c_str() + digits) : 1;
+            int role = roleRegistry.find(token.substr(0, digits));
+            if (role < 0 || role >= ROLE_TYPE_COUNT || count < 0 || c.counts[role] + count > 64) return false;
+            c.counts[role] = static_cast<uint8_t>(c.counts[role] + count);
+            begin = end + 1;
+        }
+        out = c;
+        return true;
+    }
+};
+
+struct DealOutcome
+{ // 끝난 게임의 좌석별 결과 (직업별 집계용, 최대 8인)
+    uint32_t roles = 0;  // 좌석 s의 직업 번호 = (roles >> 4s) & 15
+    uint8_t seats = 0;
+    uint8_t alive = 0;   // 생존 좌석 비트
+    bool tamed = false;  // 늑대인간이 마피아 팀으로 끝남
+
+    int role(int seat) const { return static_cast<int>((roles >> (4 * seat)) & 0x0F); }
+};
+
+inline uint32_t packDeal(const uint8_t* deal, int seats)
+{
+    uint32_t packed = 0;
+    for (int seat = 0; seat < seats && seat < 8; seat++) packed |= static_cast<uint32_t>(deal[seat]) << (4 * seat);
+    return packed;
+}
+
+class DealGenerator
+{ // 직업 덱을 만든 뒤 Fisher–Yates 한 번으로 좌석별 직업을 뽑음 (거절 루프 없음)
+private:
+    int playerCount;
+    vector<uint8_t> deck;     // 정렬된 기본 덱
+    uint32_t permutations;    // n! (n! < 2^32 인 경우만 사용, 아니면 0)
+    uint32_t threshold;       // 균등 분포를 위한 거절 기준 (2^32 mod n!)
+
+public:
+    explicit DealGenerator(int count = 0) : playerCount(0), permutations(0), threshold(0)
+    {
+        reset(count);
+    }
+
+    void reset(int count)
+    { // assignRoles의 구성 규칙 (RoleComposition::standard)
+        reset(RoleComposition::standard(count), count);
+    }
+
+    void reset(const RoleComposition& composition, int count = -1)
+    { // count가 없으면 구성의 인원 합
+        playerCount = count < 0 ? composition.total() : count;
+        deck.clear();
+        if (playerCount <= 0) return;
+
+        // 덱 순서: 경찰, 의사, 마피아, 늑대인간, 군인, 사립 탐정, 시민 (같은 난수면 예전과 같은 배정)
+        static const uint8_t order[ROLE_TYPE_COUNT] = { ROLE_POLICE, ROLE_DOCTOR, ROLE_MAFIA, ROLE_WEREWOLF, ROLE_SOLDIER, ROLE_DETECTIVE, ROLE_CITIZEN };
+        for (uint8_t role : order) {
+            for (int i = 0; i < composition.counts[role]; i++) deck.push_back(role);
+        }
+        while (static_cast<int>(deck.size()) < playerCount) deck.push_back(ROLE_CITIZEN);
+        deck.resize(playerCount); // 인원이 필수 직업보다 적은 경우 대비
+
+        uint64_t factorial = 1;
+        for (int i = 2; i <= playerCount && factorial <= 0xFFFFFFFFull; i++) factorial *= i;
+        permutations = factorial <= 0xFFFFFFFFull ? static_cast<uint32_t>(factorial) : 0;
+        threshold = permutations ? static_cast<uint32_t>(-permutations) % permutations : 0;
+    }
+
+    int size() const { return playerCount; }
+    const vector<uint8_t>& baseDeck() const { return deck; }
+
+    template <typename Rng>
+    void deal(uint8_t* out, Rng& gen) const
+    { // out[seat] = 직업 번호
+        for (int i = 0; i < playerCount; i++) out[i] = deck[i];
+
+        if (permutations) {
+            // n! 범위 난수 하나를 팩토리얼 진법으로 풀어 각 교환 위치로 사용
+            uint32_t r = boundedRandom(gen, permutations);
+            for (int i = playerCount - 1; i > 0; i--) {
+                uint32_t j = r % static_cast<uint32_t>(i + 1);
+                r /= static_cast<uint32_t>(i + 1);
+                swap(out[i], out[j]);
+            }
+        }
+        else {
+            for (int i = playerCount - 1; i > 0; i--) {
+                swap(out[i], out[boundedRandom(gen, static_cast<uint32_t>(i + 1))]);
+            }
+        }
+    }
+
+    template <typename Rng>
+    void dealBatch(uint8_t* out, size_t count, Rng& gen) const
+    { // 미리 할당된 버퍼(count * size())에 연속으로 채움
+        for (size_t d = 0; d < count; d++) {
+            deal(out + d * playerCount, gen);
+        }
+    }
+};
+
+// 인원별 고정 덱: 배포 환경은 assignRoles의 6~8인 덱만 사용하므로 컴파일 타임에 특수화
+template <size_t... I, typename Fn>
+void forEachIndex(index_sequence<I...>, Fn&& fn)
+{ // fn(integral_constant<size_t, I>)를 순서대로 호출 (반복문 없이 펼쳐짐)
+    (fn(integral_constant<size_t, I>()), ...);
+}
+
+template <size_t N, typename Fn>
+void unrollSeats(Fn&& fn)
+{
+    forEachIndex(make_index_sequence<N>(), fn);
+}
+
+constexpr uint32_t factorial32(int n)
+{
+    return n <= 1 ? 1u : static_cast<uint32_t>(n) * factorial32(n - 1);
+}
+
+template <int Players>
+constexpr array<uint8_t, Players> makeFixedDeck()
+{ // DealGenerator::reset과 같은 순서: 경찰, 의사, 마피아(8명이면 2명), 늑대인간, 군인(8명), 시민
+    array<uint8_t, Players> deck{};
+    int i = 0;
+    deck[i++] = ROLE_POLICE;
+    deck[i++] = ROLE_DOCTOR;
+    for (int m = 0; m < (Players == 8 ? 2 : 1); m++) deck[i++] = ROLE_MAFIA;
+    deck[i++] = ROLE_WEREWOLF;
+    if (Players == 8) deck[i++] = ROLE_SOLDIER;
+    while (i < Players) deck[i++] = ROLE_CITIZEN;
+    return deck;
+}
+
+template <int Players>
+struct FixedDeck
+{ // 덱과 n!을 상수로 두고 좌석 반복을 펼친 배정기 (같은 난수면 DealGenerator와 같은 배정)
+    static_assert(Players >= 6 && Players <= 8, "assignRoles가 정의하는 덱은 6~8인");
+    static constexpr int SEATS = Players;
+    static constexpr array<uint8_t, Players> deck = makeFixedDeck<Players>();
+    static constexpr uint32_t PERMUTATIONS = factorial32(Players);
+
+    constexpr int seats() const { return Players; }
+
+    template <typename Rng>
+    void deal(uint8_t* out, Rng& gen) const
+    {
+        unrollSeats<Players>([out](auto seat) { out[seat] = deck[seat]; });
+
+        // 나누는 수가 상수이므로 나눗셈이 곱셈으로 바뀜
+        uint32_t r = boundedRandom(gen, PERMUTATIONS);
+        unrollSeats<Players - 1>([out, &r](auto step) {
+            constexpr uint32_t i = Players - 1 - decltype(step)::value;
+            uint32_t j = r % (i + 1);
+            r /= (i + 1);
+            swap(out[i], out[j]);
+        });
+    }
+};
+
+struct RuntimeDeck
+{ // 인원을 실행 시간에 받는 배정기 (FixedDeck과 같은 인터페이스, 비교용)
+    static constexpr int SEATS = 0;
+    DealGenerator generator;
+
+    explicit RuntimeDeck(int players) : generator(players) {}
+    explicit RuntimeDeck(const RoleComposition& composition) { generator.reset(composition); }
+
+    int seats() const { return generator.size(); }
+
+    template <typename Rng>
+    void deal(uint8_t* out, Rng& gen) const
+    {
+        generator.deal(out, gen);
+    }
+};
+
+// 공정성 검사: 좌석 x 직업 분포에 대한 카이제곱 검정
+double chiSquareUpperTail(double statistic, double degrees)
+{ // Wilson–Hilferty 근사로 P(X >= statistic)
+    if (degrees <= 0) return 1.0;
+    double z = (pow(statistic / degrees, 1.0 / 3.0) - (1.0 - 2.0 / (9.0 * degrees))) /
+        sqrt(2.0 / (9.0 * degrees));
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+int runDealAuditCommand(int argc, char* argv[])
+{ // 사용법: napoly dealaudit [배정 횟수] [--players N]
+    uint64_t deals = 1000000000ull;
+    int playerCount = 8;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--players" && i + 1 < argc) playerCount = atoi(argv[++i]);
+        else deals = strtoull(arg.c_str(), nullptr, 10);
+    }
+    if (deals == 0 || playerCount < 2 || playerCount > 64) {
+        cout << "사용법: napoly dealaudit [배정 횟수] [--players N]\n";
+        return 1;
+    }
+
+    DealGenerator generator(playerCount);
+    GameRng gen = rngService.stream(0, RNG_STREAM_DEAL); // 하나의 긴 스트림
+
+    const size_t BATCH = 4096;
+    vector<uint8_t> buffer(BATCH * playerCount);
+    vector<uint64_t> observed(static_cast<size_t>(playerCount) * ROLE_TYPE_COUNT, 0);
+
+    auto begin = steady_clock::now();
+    for (uint64_t done = 0; done < deals; ) {
+        size_t count = static_cast<size_t>(min<uint64_t>(BATCH, deals - done));
+        generator.dealBatch(buffer.data(), count, gen);
+        const uint8_t* p = buffer.data();
+        for (size_t d = 0; d < count; d++) {
+            for (int seat = 0; seat < playerCount; seat++) {
+                observed[seat * ROLE_TYPE_COUNT + *p++]++;
+            }
+        }
+        done += count;
+    }
+    double seconds = duration<double>(steady_clock::now() - begin).count();
+
+    // 기대값: 덱 내 해당 직업 비율 x 배정 횟수 (좌석과 무관해야 함)
+    int roleInDeck[ROLE_TYPE_COUNT] = {};
+    for (uint8_t role : generator.baseDeck()) roleInDeck[role]++;
+
+    double statistic = 0.0;
+    int rolesPresent = 0;
+    for (int role = 0; role < ROLE_TYPE_COUNT; role++) {
+        if (!roleInDeck[role]) continue;
+        rolesPresent++;
+        double expected = static_cast<double>(deals) * roleInDeck[role] / playerCount;
+        for (int seat = 0; seat < playerCount; seat++) {
+            double diff = observed[seat * ROLE_TYPE_COUNT + role] - expected;
+            statistic += diff * diff / expected;
+        }
+    }
+    double degrees = static_cast<double>(playerCount - 1) * (rolesPresent - 1);
+    double pValue = chiSquareUpperTail(statistic, degrees);
+
+    cout << "=== 직업 배정 공정성 검사 (" << playerCount << "인, " << deals << "회) ===\n";
+    for (int role = 0; role < ROLE_TYPE_COUNT; role++) {
+        if (!roleInDeck[role]) continue;
+        cout << roleTypeName(role) << ":";
+        for (int seat = 0; seat < playerCount; seat++) {
+            cout << " " << fixed << setprecision(5)
+                << static_cast<double>(observed[seat * ROLE_TYPE_COUNT + role]) / deals;
+        }
+        cout << "  (기대 " << static_cast<double>(roleInDeck[role]) / playerCount << ")\n";
+    }
+    cout << setprecision(2) << "카이제곱 = " << statistic << ", 자유도 = " << degrees
+        << ", p = " << setprecision(4) << pValue
+        << (pValue < 0.001 ? "  -> 편향 의심\n" : "  -> 편향 없음\n");
+    cout << setprecision(1) << "소요 시간: " << seconds << "초 ("
+        << deals / seconds / 1e6 << "M deals/s)\n";
+    cout.unsetf(ios::fixed);
+    return 0;
+}
+
+#endif // DEAL_H
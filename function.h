@@ -4,25 +4,47 @@
 
 #include <ctime>
 #include <functional>
-#include <fstream>
 #include <algorithm>
 #include <chrono>
 #include <thread>
-#include <locale>
-#include <codecvt>
+#include <cassert>
 #include "jobs.h"
+#include "profiler.h"
+#include "metrics.h"
+#include "trace.h"
+#include "auditlog.h"
+#include "deal.h"
+#include "conflict.h"
+#include "broadcast.h"
+#include "archive.h"
+#include "rating.h"
+#include "catalog.h"
+#include "checkpoint.h"
 
 using namespace std;
 using namespace std::chrono;
 
 // 전방 선언
 class NightPhaseManager;
-void checkWerewolfTaming(shared_ptr<Player> currentPlayer, shared_ptr<Player> target);
-string formatActionMessage(const string&, const string&, bool);
+void tameWerewolf();
+void noteTamingResults();
+string formatActionMessage(RoleType, const string&, bool);
 void startNight();
 void startDay();
 void startVoting();
+void continueGame(int phase);
+void showEachPlayerResults();
+void discussAndVote();
+void announceDay();
 bool checkVictoryCondition();
+void onWerewolfTamed();
+void onMafiaAttack(const shared_ptr<Player>& target);
+void onArmorUsed(const shared_ptr<Player>& soldier);
+uint8_t seatOf(const shared_ptr<Player>& player);
+int roleTypeOf(const Player& player);
+extern thread_local int currentDay;
+extern thread_local uint64_t currentGameId;
+extern thread_local bool werewolfTamed;
 
 // 구조체 정의
 struct NightResult
@@ -34,7 +56,7 @@ struct NightResult
     bool isDeathMessage; // 사망 메시지 여부 저장
 };
 
-vector<NightResult> nightResults;
+thread_local vector<NightResult> nightResults;
 
 struct NightAction
 { // 밤 행동 관리
@@ -45,21 +67,56 @@ struct NightAction
 };
 
 // 클래스 정의
+class PhaseScope
+{ // 단계 구간 계측: 하드웨어 카운터(활성 시), 지연 시간 히스토그램, 트레이스 구간
+private:
+    GamePhase phase;
+    bool perfActive;
+    PerfCounters begin;
+    LatencyTimer timer;
+    TraceSpan span;
+
+public:
+    explicit PhaseScope(GamePhase p)
+        : phase(p), perfActive(phaseProfiler.isEnabled()), timer(static_cast<MetricLatency>(p)),
+        span(phaseName(p), "phase", currentDay)
+    {
+        if (perfActive) perfActive = phaseProfiler.read(begin);
+    }
+
+    ~PhaseScope()
+    {
+        PerfCounters end;
+        if (perfActive && phaseProfiler.read(end)) {
+            phaseProfiler.record(phase, begin, end);
+        }
+    }
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+};
+
 class NightPhaseManager
 {
 private:
     vector<NightAction> actions;
-    map<string, int> actionPriorities;
     string mafiaTarget;
-    string werewolfTarget;
-    bool werewolfTamed;
     vector<shared_ptr<Player>>& mafiaPlayers;
     vector<shared_ptr<Player>>& players;
     shared_ptr<Player>& werewolfPlayer;
-    map<shared_ptr<Player>, bool> healedPlayers;    // 치료된 플레이어 추적
-    map<shared_ptr<Player>, bool> killedPlayers;    // 죽은 플레이어 추적
-    map<shared_ptr<Player>, bool> defendedPlayers;  // 방어에 성공한 플레이어 추적
-    map<shared_ptr<Player>, bool> willDiePlayers;   // 죽을 예정인 플레이어
+    // 좌석 비트 (밤 판정의 입력과 결과, 낮 발표에서 사용)
+    uint64_t shotSeats = 0;      // 마피아 총격 대상
+    uint64_t huntedSeats = 0;    // 늑대인간의 대상
+    uint64_t healedSeats = 0;    // 의사의 치료 대상
+    uint64_t defendedSeats = 0;  // 방탄복으로 버틴 좌석
+    uint64_t dyingSeats = 0;     // 다음 날 사망할 좌석
+    bool tamedTonight = false;   // 이번 밤 판정에서 늑대인간이 접선함
+
+    static uint64_t seatBit(const shared_ptr<Player>& player)
+    {
+        uint8_t seat = seatOf(player);
+        return seat < 64 ? 1ull << seat : 0;
+    }
 
 public:
     NightPhaseManager(
@@ -67,41 +124,23 @@ public:
         vector<shared_ptr<Player>>& all_players,
         shared_ptr<Player>& werewolf_player)
         : mafiaTarget(""),
-        werewolfTamed(false),
         mafiaPlayers(mafia_players),
         players(all_players),
         werewolfPlayer(werewolf_player)
     {
-        actionPriorities = {
-            {"늑대인간", 1},
-            {"의사", 2},
-            {"마피아", 3},
-            {"군인", 4},
-            {"시민", 5} };
     }
 
     bool wasDefended(const shared_ptr<Player>& player) const {
-        auto it = defendedPlayers.find(player);
-        return it != defendedPlayers.end() && it->second;
+        return (defendedSeats & seatBit(player)) != 0;
     }
 
     string getDefendedPlayerName() const {
-        for (const auto& pair : defendedPlayers) {
-            if (pair.second) {
-                return pair.first->getName();
-            }
+        for (size_t seat = 0; seat < players.size() && seat < 64; seat++) {
+            if ((defendedSeats >> seat) & 1) return players[seat]->getName();
         }
         return "";
     }
 
-    void setWerewolfTamed(bool tamed) {
-        werewolfTamed = tamed;
-    }
-
-    bool isWerewolfTamed() const {
-        return werewolfTamed;
-    }
-
     void setMafiaTarget(const string& target) {
         mafiaTarget = target;
     }
@@ -114,13 +153,69 @@ public:
         return actions;
     }
 
+    uint64_t attackedSeats() const
+    { // 공격받은 좌석 (접선한 늑대인간의 대상 포함, 낮 발표의 치료 성공 판정용)
+        return shotSeats | (werewolfTamed ? huntedSeats : 0);
+    }
+
+    uint64_t healSeats() const { return healedSeats; }
+    uint64_t defendedSeatMask() const { return defendedSeats; }
+
     void clear()
     {
         actions.clear();
         mafiaTarget.clear();
-        healedPlayers.clear();
-        killedPlayers.clear();
-        defendedPlayers.clear();
+        shotSeats = huntedSeats = healedSeats = defendedSeats = dyingSeats = 0;
+        tamedTonight = false;
+    }
+
+    void release()
+    { // 게임 종료 시 보관 중인 메모리까지 반환 (게임 아레나 리셋 전에 호출)
+        clear();
+        vector<NightAction>().swap(actions);
+        string().swap(mafiaTarget);
+    }
+
+    uint64_t pendingDeathSeats() const
+    { // 이번 밤 사망 예정 좌석 (낮 발표 전에 게임이 끝나면 생존 상태로 남아 있음)
+        return dyingSeats;
+    }
+
+    void saveSeats(GameCheckpoint& record) const
+    { // 밤 판정 결과를 체크포인트에 (최대 8좌석)
+        record.shot = static_cast<uint8_t>(shotSeats);
+        record.hunted = static_cast<uint8_t>(huntedSeats);
+        record.healed = static_cast<uint8_t>(healedSeats);
+        record.defended = static_cast<uint8_t>(defendedSeats);
+        record.dying = static_cast<uint8_t>(dyingSeats);
+        record.tamedTonight = tamedTonight;
+        for (const auto& action : actions) { // 본인에게만 보이는 행동 안내와 조사 결과 (이어서 진행할 때 다시 보여 줌)
+            uint8_t actor = seatOf(action.actor), target = seatOf(action.target);
+            if (actor >= CHECKPOINT_MAX_SEATS || target >= CHECKPOINT_MAX_SEATS) continue;
+            uint8_t finding = static_cast<uint8_t>(target + 1);
+            NightKind kind = action.actor->roleInfo().night;
+            if (kind == NIGHT_INVESTIGATE && Police::revealsAsMafia(*action.target)) finding |= 0x10;
+            else if (kind == NIGHT_TRACK) { // processActions와 같은 방식으로 대상의 행동을 찾음
+                for (const auto& other : actions) {
+                    if (other.actor == action.target && other.target) {
+                        finding |= static_cast<uint8_t>((seatOf(other.target) + 1) << 4);
+                        break;
+                    }
+                }
+            }
+            record.findings[actor] = finding;
+        }
+    }
+
+    void restoreSeats(const GameCheckpoint& record)
+    { // processActions 직후 상태로 (행동 목록은 필요 없음, 낮 발표는 좌석 비트만 씀)
+        clear();
+        shotSeats = record.shot;
+        huntedSeats = record.hunted;
+        healedSeats = record.healed;
+        defendedSeats = record.defended;
+        dyingSeats = record.dying;
+        tamedTonight = record.tamedTonight != 0;
     }
 
     void removeAction(shared_ptr<Player> actor, const string& actionType)
@@ -140,26 +235,19 @@ public:
         action.actor = actor;
         action.target = target;
         action.actionType = actionType;
-        action.priority = actionPriorities[actor->getRole()];
+        action.priority = actor->roleInfo().priority; // 우선순위는 직업 등록부에서
         actions.push_back(action);
     }
     void processActions()
-    {
-        healedPlayers.clear();
-        killedPlayers.clear();
-        defendedPlayers.clear();
-        willDiePlayers.clear();
-
-        bool werewolfTargetMatch = false;
-        bool targetKilled = false;
-        shared_ptr<Player> matchedTarget = nullptr;
+    { // 1) 행동을 좌석 비트로 모으고 2) 영향을 받은 좌석마다 충돌 표(conflict.h)를 한 번 찾아 결과 반영
+        shotSeats = huntedSeats = healedSeats = defendedSeats = dyingSeats = 0;
+        shared_ptr<Player> shooter;
 
         // 우선순위에 따라 정렬
         sort(actions.begin(), actions.end(),
-            [this](const NightAction& a, const NightAction& b)
+            [](const NightAction& a, const NightAction& b)
             {
-                return actionPriorities[a.actor->getRole()] <
-                    actionPriorities[b.actor->getRole()];
+                return a.priority < b.priority;
             });
 
         // 각 액션 처리
@@ -168,98 +256,35 @@ public:
             if (!action.actor->checkAlive() || !action.actor->getCanUseAbility())
                 continue;
 
-            if (action.actor->getRole() == "마피아")
-            {
-                // 늑대인간을 공격하는 경우 즉시 접선
-                if (action.target == werewolfPlayer && !werewolfTamed) {
-                    werewolfTamed = true;
-                    auto werewolf = dynamic_pointer_cast<Werewolf>(werewolfPlayer);
-                    if (werewolf) {
-                        werewolf->setTamed(true);
-                        mafiaPlayers.push_back(werewolfPlayer);
-
-                        // 마피아팀 메시지
-                        for (const auto& mafia : mafiaPlayers) {
-                            if (mafia->getRole() == "마피아") {
-                                nightResults.push_back({
-                                mafia->getName(),
-                                werewolfPlayer->getName(),
-                                werewolfPlayer->getName() + "님은 늑대인간이며 당신에게 길들여졌습니다!",
-                                true,
-                                false
-                                });
-                            }
-                        }
-
-                        // 늑대인간 메시지
-                        string mafiaTeamInfo = "";
-                        for (const auto& mafia : mafiaPlayers) {
-                            if (mafia->getRole() == "마피아" && mafia->checkAlive()) {
-                                if (!mafiaTeamInfo.empty()) {
-                                    mafiaTeamInfo += ", ";
-                                }
-                                mafiaTeamInfo += mafia->getName();
-                            }
-                        }
+            if (auditLog.isEnabled()) // 좌석 번호 계산은 기록할 때만
+                auditEvent(currentGameId, currentDay, AUDIT_NIGHT_ACTION,
+                    seatOf(action.actor), seatOf(action.target), static_cast<uint16_t>(roleTypeOf(*action.actor)));
 
-                        nightResults.push_back({
-                            werewolfPlayer->getName(),
-                            "",
-                            mafiaTeamInfo + "님이 마피아이며 당신과 접선하였습니다!",
-                            true,
-                            false
-                        });
-                    }
-                }
-                // 일반적인 마피아의 공격 처리 (늑대인간 제외)
-                else if (action.target != werewolfPlayer) {
-                    
-                    bool shouldKill = true;
-                    if (auto soldier = dynamic_cast<Soldier*>(action.target.get()))
-                    {
-                        if (soldier->isArmorActive()) {
-                            soldier->defendShot(); // Armor 소모
-                            defendedPlayers[action.target] = true;
-                            healedPlayers.erase(action.target); // 이 때 의사의 치료는 무효
-                            shouldKill = false;
-
-                            // 군인에게 보내는 게인 메시지
-                            nightResults.push_back({
-                                action.target->getName(),
-                                action.actor->getName(),
-                                "마피아가 당신에게 총을 겨누었지만, 방탄복으로 버텨냈습니다.",
-                                true,
-                                false
-                                });
-                        }
-                    }
-                    if (shouldKill) {
-                        killedPlayers[action.target] = true;
-                        if (action.target->getName() == mafiaTarget) {
-                            matchedTarget = action.target;
-                        }
-                    }
-                }
+            NightKind kind = action.actor->roleInfo().night; // 직업 이름 대신 행동 종류로 분기
+            if (kind == NIGHT_KILL)
+            {
+                onMafiaAttack(action.target);
+                shotSeats |= seatBit(action.target);
+                shooter = action.actor;
             }
-            else if (action.actor->getRole() == "늑대인간")
+            else if (kind == NIGHT_HUNT)
             {
-                auto werewolf = dynamic_pointer_cast<Werewolf>(action.actor);
-                if (werewolf && !werewolf->isTamed() && action.target->getName() == mafiaTarget)
-                {
-                    werewolfTargetMatch = true;
-                }
-                else if (werewolf && werewolf->isTamed())
-                {
-                    // 길들여진 늑대인간의 공격은 무조건 성공
-                    killedPlayers[action.target] = true;
-                    healedPlayers.erase(action.target); // 의사의 치료 무시
-                }
+                huntedSeats |= seatBit(action.target);
             }
-            else if (action.actor->getRole() == "의사")
+            else if (kind == NIGHT_HEAL)
             {
-                if (!defendedPlayers[action.target]) { // 방어되지 않은 대상만 치료
-                    healedPlayers[action.target] = true;
+                healedSeats |= seatBit(action.target);
+            }
+            else if (kind == NIGHT_TRACK)
+            { // 가장 늦게 처리되므로 이번 밤의 행동이 모두 정해져 있음
+                string message = formatMessage(MSG_TRACK_NOBODY, action.target->getName());
+                for (const auto& other : actions) {
+                    if (other.actor == action.target && other.target) {
+                        message = formatMessage(MSG_TRACK_RESULT, action.target->getName(), other.target->getName());
+                        break;
+                    }
                 }
+                nightResults.push_back({ action.actor->getName(), action.target->getName(), message, true, false });
             }
             // 다른 직업들의 능력은 즉시 처리
             else
@@ -268,103 +293,192 @@ public:
             }
         }
 
-        // 늑대인간 접선 조건 체크
-        if (werewolfTargetMatch && !werewolfTamed && matchedTarget)
-        {
-            // 해당 타겟이 실제로 죽는지 확인
-            if (killedPlayers[matchedTarget] && !healedPlayers[matchedTarget] && !defendedPlayers[matchedTarget])
-            {
-                auto werewolf = dynamic_pointer_cast<Werewolf>(werewolfPlayer);
-                if (werewolf) {
-                    werewolfTamed = true;
-                    werewolf->setTamed(true);
-                    mafiaPlayers.push_back(werewolfPlayer);
-
-                    // 마피아팀 메시지
-                    for (const auto& mafia : mafiaPlayers) {
-                        if (mafia->getRole() == "마피아") {
-                            nightResults.push_back({
-                                mafia->getName(),
-                                werewolfPlayer->getName(),
-                                werewolfPlayer->getName() + "님은 늑대인간이며 당신에게 길들여졌습니다!",
-                                true,
-                                false
-                            });
-                        }
-                    }
-
-                    // 늑대인간 메시지
-                    string mafiaTeamInfo = "";
-                    for (const auto& mafia : mafiaPlayers) {
-                        if (mafia->getRole() == "마피아" && mafia->checkAlive()) {
-                            if (!mafiaTeamInfo.empty()) mafiaTeamInfo += ", ";
-                            mafiaTeamInfo += mafia->getName();
-                        }
-                    }
-
-                    nightResults.push_back({
-                        werewolfPlayer->getName(),
-                        "",
-                        mafiaTeamInfo + "님이 마피아이며 당신과 접선하였습니다!",
-                        true,
-                        false
+        // 좌석별 판정 (총격이나 늑대인간의 대상이 된 좌석만 결과가 있음)
+        uint8_t common = werewolfTamed ? SEAT_TAMED : 0;
+        for (uint64_t rest = shotSeats | huntedSeats; rest; rest &= rest - 1) {
+            int seat = __builtin_ctzll(rest);
+            uint64_t bit = 1ull << seat;
+            const shared_ptr<Player>& target = players[seat];
+            bool armored = target->roleInfo().armored; // armored 직업은 항상 Soldier로 생성됨
+            uint8_t input = common;
+            if (shotSeats & bit) input |= SEAT_SHOT;
+            if (huntedSeats & bit) input |= SEAT_HUNTED;
+            if (healedSeats & bit) input |= SEAT_HEALED;
+            if (armored && static_cast<Soldier*>(target.get())->isArmorActive()) input |= SEAT_ARMORED;
+            if (target == werewolfPlayer) input |= SEAT_WEREWOLF;
+            if (!mafiaTarget.empty() && target->getName() == mafiaTarget) input |= SEAT_MAFIA_TARGET;
+
+            uint8_t outcome = nightConflicts[input];
+            if (outcome & OUTCOME_DEFENDED) {
+                static_cast<Soldier*>(target.get())->defendShot(); // Armor 소모
+                onArmorUsed(target);
+                defendedSeats |= bit;
+
+                // 군인에게 보내는 게인 메시지
+                nightResults.push_back({
+                    target->getName(),
+                    shooter ? shooter->getName() : "",
+                    formatMessage(MSG_ARMOR_HELD),
+                    true,
+                    false
                     });
-                }
+            }
+            if (outcome & OUTCOME_DIES) dyingSeats |= bit;
+            if (outcome & OUTCOME_TAMES) {
+                tameWerewolf();
+                tamedTonight = true;
             }
         }
 
-        bool anyEvent = false;
-
         // 방어 성공 메시지 출력
-        for (const auto& pair : defendedPlayers) {
-            if (pair.second) {
-                cout << pair.first->getName() << "님이 방탄복으로 마피아의 총격을 버텨냈습니다!\n";
-                anyEvent = true;
-            }
+        for (uint64_t rest = defendedSeats; rest && !muteGameOutput; rest &= rest - 1) {
+            printMessage(MSG_ARMOR_DEFENDED, players[__builtin_ctzll(rest)]->getName());
+        }
+
+        // 사망 메시지 생성 (사망은 낮 발표에서 dyingSeats로 반영)
+        for (uint64_t rest = dyingSeats; rest; rest &= rest - 1) {
+            nightResults.push_back({
+                players[__builtin_ctzll(rest)]->getName(),
+                "",
+                formatMessage(MSG_YOU_DIED),
+                true,
+                true
+            });
         }
+    }
+};
 
-        // 사망 처리 및 메시지 생성
+// 전역 변수 선언 (게임 상태는 스레드별, 시뮬레이터가 스레드마다 게임을 따로 진행함)
+thread_local vector<string> playlist;
+thread_local vector<shared_ptr<Player>> players;
+thread_local vector<shared_ptr<Player>> mafiaPlayers;
+thread_local shared_ptr<Player> mafiaTargetPlayer;
+thread_local shared_ptr<Player> previousMafia;
+thread_local shared_ptr<Player> werewolfPlayer;
+static thread_local NightPhaseManager nightManager(mafiaPlayers, players, werewolfPlayer);
+thread_local string mafiaTarget;
+thread_local string werewolfTarget;
+thread_local int currentDay = 1;
+thread_local bool werewolfTamed = false;
+thread_local uint64_t currentGameId = 0; // 감사 로그 및 난수 스트림용 게임 번호
+atomic<uint64_t> nextGameId(1);
+
+enum class Winner { None, Citizen, Mafia };
+
+class RosterCache
+{ // 생존자 파생 상태: setAlive, 접선, 방탄복 이벤트마다 갱신하여 매번 전체 플레이어를 훑지 않음
+private:
+    const vector<shared_ptr<Player>>* seats = nullptr;
+    vector<shared_ptr<Player>> alive; // 생존자 (좌석 순서) = 밤 대상 목록 = 투표 대상 목록
+    uint64_t aliveMask = 0;
+    uint64_t mafiaTeamMask = 0;       // 마피아 + 접선한 늑대인간
+    uint64_t armorMask = 0;           // 방탄복이 남은 군인
+    int mafiaAlive = 0;
+    int citizenAlive = 0;
+
+    int seatIndex(const Player& player) const
+    {
+        if (!seats) return -1;
+        for (size_t i = 0; i < seats->size(); i++) {
+            if ((*seats)[i].get() == &player) return static_cast<int>(i);
+        }
+        return -1;
+    }
 
-        for (const auto& pair : killedPlayers)
-        {
-            if (pair.second && !healedPlayers[pair.first] && !defendedPlayers[pair.first])
-            {
-                willDiePlayers[pair.first] = true;
-                nightResults.push_back({
-                    pair.first->getName(),
-                    "",
-                    "당신은 사망하셨습니다.",
-                    true,
-                    true
-                });
+public:
+    void rebuild(const vector<shared_ptr<Player>>& table, bool tamed)
+    { // 게임 시작 시 한 번 전체 계산
+        assert(table.size() <= 64);
+        seats = &table;
+        alive.clear();
+        aliveMask = mafiaTeamMask = armorMask = 0;
+        mafiaAlive = citizenAlive = 0;
+        for (size_t i = 0; i < table.size(); i++) {
+            const Player& player = *table[i];
+            uint64_t bit = 1ull << i;
+            RoleTeam team = player.roleInfo().team;
+            if (team == TEAM_MAFIA || (team == TEAM_WEREWOLF && tamed)) mafiaTeamMask |= bit;
+            if (player.roleInfo().armored) {
+                if (static_cast<const Soldier&>(player).isArmorActive()) armorMask |= bit;
+            }
+            if (player.checkAlive()) {
+                aliveMask |= bit;
+                alive.push_back(table[i]);
+                if (mafiaTeamMask & bit) mafiaAlive++;
+                else citizenAlive++;
             }
         }
+    }
 
-        // willDiePlayers 정보를 다음 날 사용하기 위해 저장
-        for (const auto& pair : willDiePlayers) {
-            nightResults.push_back({
-                "SYSTEM",
-                pair.first->getName(),
-                "DEATH_MARK", // 다음 날 처리를 위한 마커
-                false,
-                true
-            });
+    void onAliveChanged(const Player& player)
+    {
+        int seat = seatIndex(player);
+        if (seat < 0) return; // 현재 게임의 플레이어가 아님
+        uint64_t bit = 1ull << seat;
+        int& team = (mafiaTeamMask & bit) ? mafiaAlive : citizenAlive;
+
+        if (player.checkAlive() && !(aliveMask & bit)) {
+            aliveMask |= bit;
+            team++;
+            auto it = alive.begin();
+            while (it != alive.end() && seatIndex(**it) < seat) ++it;
+            alive.insert(it, (*seats)[seat]);
+        }
+        else if (!player.checkAlive() && (aliveMask & bit)) {
+            aliveMask &= ~bit;
+            team--;
+            alive.erase(find(alive.begin(), alive.end(), (*seats)[seat]));
         }
     }
+
+    void onTamed(const Player& werewolf)
+    { // 접선한 늑대인간은 마피아 팀으로 셈
+        int seat = seatIndex(werewolf);
+        if (seat < 0) return;
+        uint64_t bit = 1ull << seat;
+        if (mafiaTeamMask & bit) return;
+        mafiaTeamMask |= bit;
+        if (aliveMask & bit) {
+            citizenAlive--;
+            mafiaAlive++;
+        }
+    }
+
+    void onArmorUsed(const Player& soldier)
+    {
+        int seat = seatIndex(soldier);
+        if (seat >= 0) armorMask &= ~(1ull << seat);
+    }
+
+    void release()
+    { // 게임 종료 시 목록 메모리 반환
+        vector<shared_ptr<Player>>().swap(alive);
+        seats = nullptr;
+        aliveMask = mafiaTeamMask = armorMask = 0;
+        mafiaAlive = citizenAlive = 0;
+    }
+
+    const vector<shared_ptr<Player>>& aliveRoster() const { return alive; }
+    uint64_t aliveSeats() const { return aliveMask; }
+    bool isArmorActive(int seat) const { return (armorMask >> seat) & 1; }
+
+    Winner victory() const
+    { // O(1) 승리 판정
+        if (mafiaAlive == 0) return Winner::Citizen;
+        if (mafiaAlive >= citizenAlive) return Winner::Mafia;
+        return Winner::None;
+    }
+
+    bool matchesRebuild(bool tamed) const
+    { // 전체 재계산 결과와 같은지 (napoly fuzz와 NAPOLY_VERIFY_ROSTER 빌드의 검사용)
+        RosterCache fresh;
+        if (seats) fresh.rebuild(*seats, tamed);
+        return fresh.aliveMask == aliveMask && fresh.alive == alive && fresh.mafiaTeamMask == mafiaTeamMask &&
+            fresh.armorMask == armorMask && fresh.mafiaAlive == mafiaAlive && fresh.citizenAlive == citizenAlive;
+    }
 };
 
-// 전역 변수 선언
-vector<string> playlist;
-vector<shared_ptr<Player>> players;
-vector<shared_ptr<Player>> mafiaPlayers;
-shared_ptr<Player> mafiaTargetPlayer;
-shared_ptr<Player> previousMafia;
-shared_ptr<Player> werewolfPlayer;
-static NightPhaseManager nightManager(mafiaPlayers, players, werewolfPlayer);
-string mafiaTarget;
-string werewolfTarget;
-int currentDay = 1;
-bool werewolfTamed = false;
+thread_local RosterCache roster;
 
 // 유틸리티 함수
 void clearInputBuffer()
@@ -383,15 +497,15 @@ void showPlayerList()
     cout << "\n전체: " << playlist.size() << "명\n";
 }
 
-void showResults(const string& playerName)
-{
+void appendNightResults(string& out, const string& playerName)
+{ // 한 플레이어가 볼 수 있는 밤 결과 (대화형 진행과 소켓 테이블 공통)
     bool foundResult = false;
 
     auto currentPlayer = find_if(players.begin(), players.end(),
         [&playerName](const auto& player) {return player->getName() == playerName; });
 
     if (currentPlayer != players.end() && !(*currentPlayer)->checkAlive()) {
-        cout << "[받은 영향] 당신은 사망하셨습니다.\n";
+        appendMessage(out, MSG_RESULT_RECEIVED, formatMessage(MSG_YOU_DIED));
         foundResult = true;
     }
 
@@ -400,80 +514,198 @@ void showResults(const string& playerName)
     {
         if (result.playerName == playerName && result.isPrivate)
         {
-            cout << "[행동 결과] " << result.message << "\n";
+            appendMessage(out, MSG_RESULT_ACTION, result.message);
             foundResult = true;
         }
     }
 
     if (!foundResult)
     {
-        cout << "[받은 영향] 아무런 일도 일어나지 않았습니다...\n";
+        appendMessage(out, MSG_RESULT_NOTHING);
     }
 }
 
-string formatActionMessage(const string& actorRole, const string& action, bool isReceived = false) {
+void showResults(const string& playerName)
+{
+    string out;
+    appendNightResults(out, playerName);
+    cout << out;
+}
+
+string formatActionMessage(RoleType role, const string& targetName, bool isReceived = false)
+{ // 밤 행동 안내 문구 (isReceived면 대상 시점)
     if (isReceived) {
-        if (actorRole == "마피아") return "마피아에게 공격받았습니다.";
+        if (role == ROLE_MAFIA) return formatMessage(MSG_ATTACKED_BY_MAFIA);
     }
     else {
-        if (actorRole == "마피아") return "님을 처지 대상으로 지정합니다.";
-        if (actorRole == "의사") return "을(를) 치료합니다.";
-        if (actorRole == "경찰") return "을(를) 조사합니다.";
-        if (actorRole == "늑대인간") return "을(를) 먹잇감으로 선정합니다.";
+        if (role == ROLE_MAFIA) return formatMessage(MSG_KILL_ACTION, targetName);
+        if (role == ROLE_DOCTOR) return formatMessage(MSG_HEAL_ACTION, targetName);
+        if (role == ROLE_POLICE) return formatMessage(MSG_INVESTIGATE_ACTION, targetName);
+        if (role == ROLE_WEREWOLF) return formatMessage(MSG_HUNT_ACTION, targetName);
     }
     return "";
 }
 
-void yourTurn(shared_ptr<Player> currentPlayer)
-{
-    if (!currentPlayer->getCanUseAbility()) // 구현은 했지만, 직업 삭제로 사용 x
+void submitNightAction(shared_ptr<Player> currentPlayer, shared_ptr<Player> target)
+{ // 선택된 대상에 대한 직업별 밤 행동 등록 (입력 방식과 무관하게 공유), 분기는 등록부의 행동 종류
+    NightKind kind = currentPlayer->roleInfo().night;
+    // 6.1 경찰 능력
+    if (kind == NIGHT_INVESTIGATE)
     {
-        cout << "현재 능력을 사용할 수 없습니다.\n";
-        return;
+        MessageId result = Police::revealsAsMafia(*target) ? MSG_POLICE_IS_MAFIA : MSG_POLICE_NOT_MAFIA;
+        nightResults.push_back({ currentPlayer->getName(),
+                                target->getName(),
+                                formatMessage(result, target->getName()),
+                                true });
+        nightManager.addAction(currentPlayer, target, currentPlayer->getRole());
     }
+    // 6.2 마피아 능력
+    else if (kind == NIGHT_KILL)
+    {
+        // 이전 마피아의 액션이 있었다면 제거
+        if (previousMafia)
+        {
+            nightManager.removeAction(previousMafia, previousMafia->getRole());
+            string prevMafiaName = previousMafia->getName();
+            // 이전 결과 제거
+            nightResults.erase(
+                remove_if(nightResults.begin(), nightResults.end(),
+                    [prevMafiaName](const NightResult& result)
+                    {
+                        return result.playerName == prevMafiaName ||
+                            (result.playerName == "마피아" &&
+                                result.targetName == mafiaTarget);
+                    }),
+                nightResults.end());
+        }
 
-    // 1. 능력이 없는 직업 체크
-    if (currentPlayer->getRole() == "군인" || currentPlayer->getRole() == "시민")
+        // 새로운 타겟 정보 저장
+        mafiaTarget = target->getName();
+        nightManager.setMafiaTarget(target->getName());
+        mafiaTargetPlayer = target;
+        previousMafia = currentPlayer;
+
+        // 행동 결과 저장 - 공격자 시점
+        nightResults.push_back({
+            currentPlayer->getName(),
+            target->getName(),
+            formatActionMessage(ROLE_MAFIA, target->getName()),
+            true
+            });
+
+        // 타겟 시점의 메시지
+        nightResults.push_back({
+            "마피아",
+            target->getName(),
+            formatActionMessage(ROLE_MAFIA, target->getName(), true),
+            true
+            });
+
+        nightManager.addAction(currentPlayer, target, currentPlayer->getRole());
+    }
+    // 6.3 의사 능력
+    else if (kind == NIGHT_HEAL)
     {
-        cout << "당신은 밤에 수행할 수 있는 역할이 없습니다.\n";
-        return;
+        nightResults.push_back({ currentPlayer->getName(),
+                                target->getName(),
+                                formatMessage(MSG_HEAL_CHOSEN, target->getName()),
+                                true });
+        nightManager.addAction(currentPlayer, target, currentPlayer->getRole());
     }
-
-    // 3. 유효한 타겟 목록 표시
-    vector<shared_ptr<Player>> validTargets;
-    for (const auto& player : players)
+    // 6.4 늑대인간 능력
+    else if (kind == NIGHT_HUNT)
     {
-        if (player->checkAlive())
-        {
-            validTargets.push_back(player);
-            cout << validTargets.size() << ". " << player->getName() << "\n";
-        }
+        nightResults.push_back({ currentPlayer->getName(),
+                                target->getName(),
+                                formatMessage(MSG_HUNT_CHOSEN, target->getName()),
+                                true });
+        nightManager.addAction(currentPlayer, target, currentPlayer->getRole());
+        werewolfTarget = target->getName(); // 늑대인간의 타겟 저장 (접선 판정은 processActions에서)
+    }
+    // 6.5 사립 탐정 능력 (결과는 processActions에서)
+    else if (kind == NIGHT_TRACK)
+    {
+        nightResults.push_back({ currentPlayer->getName(),
+                                target->getName(),
+                                formatMessage(MSG_TRACK_CHOSEN, target->getName()),
+                                true,
+                                false });
+        nightManager.addAction(currentPlayer, target, currentPlayer->getRole());
     }
+}
 
-    // 4. 마피아 특별 처리
-    if (currentPlayer->getRole() == "마피아")
+void appendTeamBriefing(string& out, const shared_ptr<Player>& currentPlayer)
+{ // 밤 차례에 보여 줄 팀 정보 (공개 범위는 등록부의 sight, 대화형 진행과 소켓 테이블 공통)
+    const RoleInfo& info = currentPlayer->roleInfo();
+    if (info.sight == SIGHT_MAFIA)
     {
-        cout << "\n=== 마피아 팀 정보 ===\n";
+        appendMessage(out, MSG_MAFIA_TEAM_HEADER);
         for (const auto& mafia : mafiaPlayers) {
-            if (mafia->getName() != currentPlayer->getName() && mafia->getRole() == "마피아") {
-                cout << mafia->getName() << "님은 " << mafia->getRole() << "입니다.\n";
+            if (mafia->getName() != currentPlayer->getName() && mafia->roleInfo().team == TEAM_MAFIA) {
+                appendMessage(out, MSG_TEAM_MEMBER, mafia->getName(), mafia->getRole());
             }
         }
 
         // 늑대인간의 타겟 정보 표시
         auto werewolf = dynamic_pointer_cast<Werewolf>(werewolfPlayer);
         if (werewolf && werewolf->isTamed()) {
-            cout << werewolfPlayer->getName() << "님은 늑대인간입니다.\n";
+            appendMessage(out, MSG_TEAM_WEREWOLF, werewolfPlayer->getName());
             if (!werewolfTarget.empty()) {
-                cout << "\n늑대인간이 " << werewolfTarget << "님을 살육의 대상으로 지정했습니다.\n";
+                appendMessage(out, MSG_WEREWOLF_TARGET, werewolfTarget);
+            }
+        }
+    }
+    else if (info.sight == SIGHT_MAFIA_WHEN_TAMED) {
+        auto werewolf = dynamic_pointer_cast<Werewolf>(currentPlayer);
+        if (werewolf && werewolf->isTamed()) {
+            appendMessage(out, MSG_MAFIA_TEAM_HEADER);
+            for (const auto& member : mafiaPlayers) {
+                if (member->roleInfo().team == TEAM_MAFIA && member->checkAlive()) {
+                    appendMessage(out, MSG_TEAM_MEMBER, member->getName(), member->getRole());
+                }
+            }
+
+            // 마피아의 타겟 정보 표시
+            if (!mafiaTarget.empty()) {
+                appendMessage(out, MSG_MAFIA_TARGET, mafiaTarget);
             }
         }
+    }
+}
+
+void yourTurn(shared_ptr<Player> currentPlayer)
+{
+    if (!currentPlayer->getCanUseAbility()) // 구현은 했지만, 직업 삭제로 사용 x
+    {
+        printMessage(MSG_ABILITY_BLOCKED);
+        return;
+    }
+
+    // 1. 능력이 없는 직업 체크
+    const RoleInfo& info = currentPlayer->roleInfo();
+    if (info.night == NIGHT_NONE)
+    {
+        printMessage(MSG_NO_NIGHT_ROLE);
+        return;
+    }
+
+    // 3. 유효한 타겟 목록 표시
+    const vector<shared_ptr<Player>>& validTargets = roster.aliveRoster();
+    for (size_t i = 0; i < validTargets.size(); i++)
+    {
+        printMessage(MSG_TARGET_ITEM, to_string(i + 1), validTargets[i]->getName());
+    }
 
+    // 4. 마피아 특별 처리 (팀 정보 공개 범위는 등록부의 sight)
+    string briefing;
+    appendTeamBriefing(briefing, currentPlayer);
+    cout << briefing;
+    if (info.sight == SIGHT_MAFIA)
+    {
         // 이미 다른 마피아가 타겟을 선택했는지 확인
-        if (!mafiaTarget.empty())
+        if (info.night == NIGHT_KILL && !mafiaTarget.empty())
         {
-            cout << "\n다른 마피아가 " << mafiaTarget << "님을 처치 대상으로 지목했습니다.\n";
-            cout << "바꾸시겠습니까? (Y/N): ";
+            printMessage(MSG_OTHER_MAFIA_TARGET, mafiaTarget);
 
             char choice = 'N';
             clearInputBuffer();
@@ -481,14 +713,14 @@ void yourTurn(shared_ptr<Player> currentPlayer)
             while (!(cin >> choice))
             {
                 clearInputBuffer();
-                cout << "잘못된 입력입니다. Y 또는 N을 입력해주세요: ";
+                printMessage(MSG_ASK_YES_NO);
             }
 
             choice = toupper(choice);
 
             if (choice != 'Y' && choice != 'N')
             {
-                cout << "잘못된 입력입니다. 타겟을 변경하지 않습니다.\n";
+                printMessage(MSG_TARGET_KEPT);
                 return;
             }
 
@@ -499,7 +731,7 @@ void yourTurn(shared_ptr<Player> currentPlayer)
                         nightResults.push_back({
                             currentPlayer->getName(),
                             validTarget->getName(),
-                            validTarget->getName() + formatActionMessage("마피아", "attack"),
+                            formatActionMessage(ROLE_MAFIA, validTarget->getName()),
                             true,
                             false
                             });
@@ -509,28 +741,7 @@ void yourTurn(shared_ptr<Player> currentPlayer)
                 }
                 return;
             }
-
-            if (choice > 0 && choice <= static_cast<int>(validTargets.size()))
-            {
-                shared_ptr<Player> target = validTargets[choice - 1];
-                checkWerewolfTaming(currentPlayer, target);
-            }
-        }
-    }
-    else if (currentPlayer->getRole() == "늑대인간") {
-        auto werewolf = dynamic_pointer_cast<Werewolf>(currentPlayer);
-        if (werewolf && werewolf->isTamed()) {
-            cout << "\n=== 마피아 팀 정보 ===\n";
-            for (const auto& member : mafiaPlayers) {
-                if (member->getRole() == "마피아" && member->checkAlive()) {
-                    cout << member->getName() << "님은 " << member->getRole() << "입니다.\n";
-                }
-            }
-
-            // 마피아의 타겟 정보 표시
-            if (!mafiaTarget.empty()) {
-                cout << "\n마피아가 " << mafiaTarget << "님을 처치 대상으로 지목했습니다.\n";
-            }
+            // Y: 아래에서 새 대상을 고름 (이전 마피아의 행동은 submitNightAction이 교체)
         }
     }
 
@@ -539,17 +750,17 @@ void yourTurn(shared_ptr<Player> currentPlayer)
     int choice;
     while (true)
     {
-        cout << "\n능력을 사용할 대상을 선택하세요 (0: 능력 사용하지 않음): ";
+        printMessage(MSG_CHOOSE_TARGET);
         if (!(cin >> choice))
         {
             clearInputBuffer();
-            cout << "잘못된 입력입니다.\n";
+            printMessage(MSG_INVALID_INPUT);
             continue;
         }
 
         if (choice == 0)
         {
-            cout << "능력 사용을 취소했습니다.\n";
+            printMessage(MSG_ABILITY_CANCELLED);
             return;
         }
 
@@ -558,96 +769,12 @@ void yourTurn(shared_ptr<Player> currentPlayer)
             shared_ptr<Player> target = validTargets[choice - 1];
 
             // 6. 직업별 능력 사용 처리
-            // 6.1 경찰 능력
-            if (currentPlayer->getRole() == "경찰")
-            {
-                string result;
-                if (target->getRole() == "마피아")
-                {
-                    result = "마피아입니다.";
-                }
-                else
-                {
-                    result = "마피아가 아닙니다.";
-                }
-                nightResults.push_back({ currentPlayer->getName(),
-                                        target->getName(),
-                                        target->getName() + "(은)는 " + result,
-                                        true });
-                nightManager.addAction(currentPlayer, target, currentPlayer->getRole());
-            }
-            // 6.2 마피아 능력
-            else if (currentPlayer->getRole() == "마피아")
-            {
-                // 이전 마피아의 액션이 있었다면 제거
-                if (previousMafia)
-                {
-                    nightManager.removeAction(previousMafia, "마피아");
-                    string prevMafiaName = previousMafia->getName();
-                    // 이전 결과 제거
-                    nightResults.erase(
-                        remove_if(nightResults.begin(), nightResults.end(),
-                            [prevMafiaName](const NightResult& result)
-                            {
-                                return result.playerName == prevMafiaName ||
-                                    (result.playerName == "마피아" &&
-                                        result.targetName == mafiaTarget);
-                            }),
-                        nightResults.end());
-                }
-
-                // 새로운 타겟 정보 저장
-                mafiaTarget = target->getName();
-                nightManager.setMafiaTarget(target->getName());
-                mafiaTargetPlayer = target;
-                previousMafia = currentPlayer;
-
-                // 행동 결과 저장 - 공격자 시점
-                nightResults.push_back({
-                    currentPlayer->getName(),
-                    target->getName(),
-                    target->getName() + formatActionMessage("마피아", "attack"),
-                    true
-                    });
+            submitNightAction(currentPlayer, target);
 
-                // 타겟 시점의 메시지
-                nightResults.push_back({
-                    "마피아",
-                    target->getName(),
-                    formatActionMessage("마피아", "attack", true),
-                    true
-                    });
-
-                nightManager.addAction(currentPlayer, target, currentPlayer->getRole());
-            }
-            // 6.3 의사 능력
-            else if (currentPlayer->getRole() == "의사")
-            {
-                nightResults.push_back({ currentPlayer->getName(),
-                                        target->getName(),
-                                        target->getName() + "을(를) 치료하기로 했습니다.",
-                                        true });
-                nightManager.addAction(currentPlayer, target, currentPlayer->getRole());
-            }
-            // 6.4 늑대인간 능력
-            else if (currentPlayer->getRole() == "늑대인간")
-            {
-                nightResults.push_back({ currentPlayer->getName(),
-                                        target->getName(),
-                                        target->getName() + "님을 대상으로 지정했습니다.",
-                                        true });
-                nightManager.addAction(currentPlayer, target, currentPlayer->getRole());
-                werewolfTarget = target->getName(); // 늑대인간의 타겟 저장
-
-                if (!mafiaTarget.empty() && target->getName() == mafiaTarget) {
-                    checkWerewolfTaming(currentPlayer, target);
-                }
-            }
-
-            cout << "능력 사용이 완료되었습니다.\n";
+            printMessage(MSG_ABILITY_DONE);
             break;
         }
-        cout << "잘못된 선택입니다. 다시 선택해주세요.\n";
+        printMessage(MSG_INVALID_CHOICE);
     }
 
     clearInputBuffer();
@@ -710,6 +837,13 @@ void playerModify()
                     --i; // 반복 횟수 보정
                     continue;
                 }
+                if (name.size() > static_cast<size_t>(CHECKPOINT_NAME_BYTES - 1))
+                { // 체크포인트의 이름 칸에 그대로 들어가야 이어서 진행할 때 이름이 바뀌지 않음
+                    cout << "이름이 너무 깁니다. 영문 " << CHECKPOINT_NAME_BYTES - 1 << "자, 한글 "
+                         << (CHECKPOINT_NAME_BYTES - 1) / 3 << "자 이내로 다시 입력해주세요. \n\n";
+                    --i;
+                    continue;
+                }
                 playlist.push_back(name);
                 cout << name << " 플레이어가 등록 되었습니다.\n\n";
                 ++player_cnt;
@@ -753,96 +887,61 @@ void playerModify()
 }
 
 shared_ptr<Player> createRole(const string& name, int roleType)
-{
-    switch (roleType)
-    {
-    case 0:
-        return make_shared<Mafia>(name);
-    case 1:
-        return make_shared<Werewolf>(name);
-    case 2:
-        return make_shared<Police>(name);
-    case 3:
-        return make_shared<Doctor>(name);
-    case 4:
-        return make_shared<Soldier>(name);
-    case 5:
-        return make_shared<Citizen>(name);
-    default:
-        return make_shared<Citizen>(name);
+{ // 직업 등록부의 생성 함수 (등록되지 않은 번호는 시민)
+    if (roleType < 0 || roleType >= roleRegistry.size()) roleType = ROLE_CITIZEN;
+    return roleRegistry[roleType].create(name, roleType);
+}
+
+int roleTypeOf(const Player& player)
+{ // createRole의 번호 체계
+    return player.roleType();
+}
+
+uint8_t seatOf(const shared_ptr<Player>& player)
+{ // players 벡터 내 좌석 번호
+    for (size_t i = 0; i < players.size(); i++) {
+        if (players[i] == player) return static_cast<uint8_t>(i);
     }
+    return AUDIT_NO_SEAT;
 }
 
-void assignRoles()
-{
+void assignRolesFromDeal(const uint8_t* deal)
+{ // deal[seat] = 직업 번호, 좌석 순서는 playlist 순서를 따름
     players.clear();
     mafiaPlayers.clear();
-    werewolfTamed = false;
+    werewolfPlayer = nullptr; // 늑대인간이 없는 구성 대비
+    werewolfTamed = false; // 이전 게임의 접선 상태 초기화
 
     int totalPlayers = playlist.size();
-    vector<bool> assigned(totalPlayers, false);
-    random_device rd;
-    mt19937 gen(rd());
-
-    // 필수 직업 할당
-    uniform_int_distribution<> dis(0, totalPlayers - 1); // 1. 경찰 할당
-    int policeIndex = dis(gen);
-    players.push_back(make_shared<Police>(playlist[policeIndex]));
-    assigned[policeIndex] = true;
-
-    int doctorIndex; // 2. 의사 할당
-    do
-    {
-        doctorIndex = dis(gen);
-    } while (assigned[doctorIndex]);
-    players.push_back(make_shared<Doctor>(playlist[doctorIndex]));
-    assigned[doctorIndex] = true;
-
-    int mafiaCount = (totalPlayers == 8) ? 2 : 1; // 3. 마피아 할당 (8명일 때만 2명, 그 외에는 1명)
-    for (int i = 0; i < mafiaCount; i++)
+    players.reserve(totalPlayers);
+    for (int i = 0; i < totalPlayers; i++)
     {
-        int mafiaIndex;
-        do
-        {
-            mafiaIndex = dis(gen);
-        } while (assigned[mafiaIndex]);
-        auto mafia = make_shared<Mafia>(playlist[mafiaIndex]);
-        players.push_back(mafia);
-        mafiaPlayers.push_back(mafia); // 마피아 플레이어 저장
-        assigned[mafiaIndex] = true;
+        auto player = createRole(playlist[i], deal[i]);
+        players.push_back(player);
+        RoleTeam team = player->roleInfo().team;
+        if (team == TEAM_MAFIA) mafiaPlayers.push_back(player); // 마피아 플레이어 저장
+        else if (team == TEAM_WEREWOLF) werewolfPlayer = player;
     }
+}
 
-    int werewolfIndex; // 4. 늑대인간 할당
-    do
-    {
-        werewolfIndex = dis(gen);
-    } while (assigned[werewolfIndex]);
-    werewolfPlayer = make_shared<Werewolf>(playlist[werewolfIndex]);
-    players.push_back(werewolfPlayer);
-    assigned[werewolfIndex] = true;
-
-    if (totalPlayers == 8) { // 5. 군인은 8명일 때만 할당
-        int soldierIndex;
-        do {
-            soldierIndex = dis(gen);
-        } while (assigned[soldierIndex]);
-        players.push_back(make_shared<Soldier>(playlist[soldierIndex]));
-        assigned[soldierIndex] = true;
-    }
+void assignRoles()
+{ // 직업 덱을 한 번 섞어 배정 (덱 구성은 DealGenerator 참고)
+    static thread_local DealGenerator generator;
+    static thread_local vector<uint8_t> deal;
+    GameRng gen = rngService.stream(currentGameId, RNG_STREAM_DEAL);
 
-    for (int i = 0; i < totalPlayers; i++)
-    { // 6. 나머지는 모두 시민으로 할당
-        if (!assigned[i])
-        {
-            players.push_back(make_shared<Citizen>(playlist[i]));
-        }
+    int totalPlayers = playlist.size();
+    if (generator.size() != totalPlayers) {
+        ArenaBypass bypass; // 스레드 수명 버퍼는 게임 아레나 밖에 할당
+        generator.reset(totalPlayers);
+        deal.resize(totalPlayers);
     }
-
-    shuffle(players.begin(), players.end(), gen); // 플레이어 순서 랜덤
+    generator.deal(deal.data(), gen);
+    assignRolesFromDeal(deal.data());
 }
 
-void checkWerewolfTaming(shared_ptr<Player> currentPlayer, shared_ptr<Player> target)
-{
+void tameWerewolf()
+{ // 늑대인간 접선: 마피아 팀에 합류시키고 양쪽에 알림 (충돌 표의 OUTCOME_TAMES)
     if (!werewolfPlayer || werewolfTamed)
         return;
 
@@ -850,107 +949,541 @@ void checkWerewolfTaming(shared_ptr<Player> currentPlayer, shared_ptr<Player> ta
     if (!werewolf)
         return;
 
-    // 1. 마피아가 늑대인간 공격한 경우
-    if (currentPlayer->getRole() == "마피아" && target == werewolfPlayer) {
-        // 이 경우는 즉시 접선 (늑대인간이 직접 타겟이 된 경우)
-        werewolfTamed = true;
-        werewolf->setTamed(true);
-        mafiaPlayers.push_back(werewolfPlayer); // 마피아팀과 공유
-
-        string mafiaMessage = target->getName() + "님은 늑대인간이며 당신과 접선하였습니다!";
-        string werewolfMessage = target->getName() + "님은 마피아이며 당신과 접선하였습니다!";
-
-        // 마피아 팀 전체에 동일 메시지 전달
-        for (const auto& mafia : mafiaPlayers) {
-            nightResults.push_back({
-                mafia->getName(),
-                werewolfPlayer->getName(),
-                mafiaMessage,
-                true,
-                false
-                });
-        }
+    werewolf->setTamed(true);
+    mafiaPlayers.push_back(werewolfPlayer);
+    onWerewolfTamed();
+    noteTamingResults();
+}
 
-        // 늑대인간에게 메시지 전달
+void noteTamingResults()
+{ // 접선 알림: 마피아에게는 늑대인간, 늑대인간에게는 살아 있는 마피아 팀 (체크포인트에서 이어서 진행할 때도 사용)
+    // 마피아팀 메시지
+    string mafiaTeamInfo = "";
+    for (const auto& mafia : mafiaPlayers) {
+        if (mafia->roleInfo().team != TEAM_MAFIA) continue;
         nightResults.push_back({
+            mafia->getName(),
             werewolfPlayer->getName(),
-            currentPlayer->getName(),
-            werewolfMessage,
+            formatMessage(MSG_WEREWOLF_TAMED, werewolfPlayer->getName()),
             true,
             false
             });
+        if (mafia->checkAlive()) {
+            if (!mafiaTeamInfo.empty()) mafiaTeamInfo += ", ";
+            mafiaTeamInfo += mafia->getName();
+        }
     }
 
-    // 2. 마피아와 늑대인간의 타겟 일치
-    else if (currentPlayer->getRole() == "늑대인간" && !mafiaTarget.empty() && target->getName() == mafiaTarget)
-    {
-        nightResults.push_back({
-            "SYSTEM",
-            "CHECK_TAMING",
-            target->getName(),  // 타겟 이름 저장
-            false,
-            false
-            });
-    }
+    // 늑대인간 메시지
+    nightResults.push_back({
+        werewolfPlayer->getName(),
+        "",
+        formatMessage(MSG_MAFIA_CONTACT, mafiaTeamInfo),
+        true,
+        false
+        });
 }
 
 void gameRule()
+{ // 규칙 전문은 catalog.h에 들어 있음
+    printMessage(MSG_RULES_HEADER);
+    printRules();
+    printMessage(MSG_PRESS_ENTER);
+    clearInputBuffer();
+    cin.get();
+    system("cls");
+}
+
+// 게임 규칙 함수 (입출력 없이 상태만 변경, 대화형 진행과 시뮬레이션이 공유)
+void onAliveChanged(Player& player)
+{ // Player::setAlive에서 생사가 바뀔 때 호출
+    roster.onAliveChanged(player);
+}
+
+void onWerewolfTamed()
+{ // 접선 발생 시 팀 구성, 지표 및 감사 로그 기록
+    werewolfTamed = true;
+    if (werewolfPlayer) roster.onTamed(*werewolfPlayer);
+    metricsIncrement(COUNTER_WEREWOLF_TAMINGS);
+    if (auditLog.isEnabled()) auditEvent(currentGameId, currentDay, AUDIT_TAMING, seatOf(werewolfPlayer));
+    if (gameArchive.isEnabled() && !archiveDraft.tamedDay) archiveDraft.tamedDay = static_cast<uint8_t>(min(currentDay, 255));
+}
+
+void onMafiaAttack(const shared_ptr<Player>& target)
+{ // 마피아의 공격 (기록 보관소에는 첫날 밤 대상만)
+    if (currentDay == 1 && gameArchive.isEnabled() && archiveDraft.firstTarget == ARCHIVE_NO_SEAT) {
+        archiveDraft.firstTarget = seatOf(target);
+    }
+}
+
+void onArmorUsed(const shared_ptr<Player>& soldier)
+{ // 군인의 방탄복 소모
+    roster.onArmorUsed(*soldier);
+    if (auditLog.isEnabled()) auditEvent(currentGameId, currentDay, AUDIT_ARMOR, seatOf(soldier));
+}
+
+struct DayReport
+{ // 낮에 공개되는 밤 행동 결과
+    string defendedName;        // 방탄복으로 버틴 플레이어
+    string savedPlayerName;     // 의사의 치료로 살아난 플레이어
+    vector<string> deathMessages;
+    bool anyEvent = false;
+    bool anyAttack = false;
+};
+
+struct VoteTally
+{ // 1차 투표 집계 결과
+    shared_ptr<Player> maxVotePlayer = nullptr;
+    int maxVotes = 0;
+    bool isDuplicate = false;
+};
+
+// 공개 상태 게시와 이벤트 방송 (관전자/진행자용, 게시 대상이 있을 때만)
+thread_local PublicState publicDraft;
+
+void emitPublicEvent(PublicEventType type, uint8_t seat = EVENT_NO_SEAT, uint16_t value = 0, uint16_t extra = 0)
 {
-    string originalLocale = setlocale(LC_ALL, nullptr); // 현재 로케일 저장
+    if (!eventRing) return;
+    PublicEvent event;
+    event.gameId = currentGameId;
+    event.day = static_cast<uint16_t>(currentDay);
+    event.type = type;
+    event.seat = seat;
+    event.value = value;
+    event.extra = extra;
+    eventRing->publish(event);
+}
+
+void publishPublicState(PublicPhase phase, Winner winner = Winner::None)
+{ // 단계 경계에서 호출: 단계 이벤트를 먼저 보내고 그 이벤트까지 반영한 스냅샷 게시
+    uint8_t winnerCode = static_cast<uint8_t>(winner == Winner::Citizen ? 1 : winner == Winner::Mafia ? 2 : 0);
+    emitPublicEvent(EVENT_PHASE, EVENT_NO_SEAT, phase, winnerCode);
+    if (!publicChannel) return;
+    publicDraft.version++;
+    publicDraft.eventCount = eventRing ? eventRing->published() : 0;
+    publicDraft.day = currentDay;
+    publicDraft.phase = phase;
+    publicDraft.winner = winnerCode;
+    publicChannel->publish(publicDraft);
+}
 
-    cout << "\n=== 마피아 게임 규칙 ===\n\n";
+void notePublicDeath(const shared_ptr<Player>& player, PublicDeathCause cause)
+{ // 발표된 사망만 기록 (스냅샷은 다음 게시에 반영)
+    uint8_t seat = seatOf(player);
+    emitPublicEvent(cause == DEATH_EXECUTION ? EVENT_EXECUTION : EVENT_DEATH, seat);
+    if (gameArchive.isEnabled()) archiveDraft.noteDeath(seat, currentDay, cause == DEATH_EXECUTION);
+    if (!publicChannel || seat >= PUBLIC_MAX_SEATS) return;
+    publicDraft.aliveMask &= static_cast<uint8_t>(~(1u << seat));
+    publicDraft.deathDay[seat] = static_cast<uint8_t>(min(currentDay, 255));
+    publicDraft.deathCause[seat] = cause;
+}
+
+void resetPublicState()
+{ // 새 게임의 좌석과 이름 (버전은 채널 단위로 계속 증가)
+    if (!publicChannel) return;
+    uint64_t version = publicDraft.version;
+    memset(&publicDraft, 0, sizeof(publicDraft));
+    publicDraft.version = version;
+    publicDraft.gameId = currentGameId;
+    publicDraft.seatCount = static_cast<uint8_t>(min<size_t>(players.size(), PUBLIC_MAX_SEATS));
+    publicDraft.aliveMask = static_cast<uint8_t>((1u << publicDraft.seatCount) - 1);
+    for (int seat = 0; seat < publicDraft.seatCount; seat++) {
+        strncpy(publicDraft.names[seat], players[seat]->getName().c_str(), PUBLIC_NAME_BYTES - 1);
+    }
+}
 
-    try {
-        setlocale(LC_ALL, ".UTF-8"); // UTF-8 출력을 위한 로케일 설정
-        wifstream file("mafiarule.txt");
-        if (!file.is_open()) {
-            throw runtime_error("Cannot open file");
+void beginGame(const uint8_t* deal = nullptr, uint64_t gameId = 0)
+{ // 직업 배정 및 게임 시작 기록 (대화형 진행과 시뮬레이션 공통), deal이 있으면 그대로 사용
+  // gameId가 0이면 새 번호를 받음 (번호가 같으면 같은 난수 스트림)
+    currentGameId = gameId ? gameId : nextGameId.fetch_add(1);
+    nightManager.clear(); // 밤 직후 끝난 이전 게임의 행동이 남지 않도록
+    if (deal) assignRolesFromDeal(deal);
+    else assignRoles();
+    roster.rebuild(players, werewolfTamed);
+    nightConflicts.compile(gameRules.doctorBeatsArmor); // 규칙 선택지가 바뀌었을 때만 다시 계산
+    currentDay = 1;
+    resetPublicState();
+    metricsIncrement(COUNTER_GAMES_STARTED);
+
+    if (auditLog.isEnabled()) {
+        auditEvent(currentGameId, currentDay, AUDIT_GAME_START, AUDIT_NO_SEAT, AUDIT_NO_SEAT,
+            static_cast<uint16_t>(players.size()));
+        for (size_t seat = 0; seat < players.size(); seat++) {
+            auditEvent(currentGameId, currentDay, AUDIT_DEAL, static_cast<uint8_t>(seat), AUDIT_NO_SEAT,
+                static_cast<uint16_t>(roleTypeOf(*players[seat])));
         }
-        file.imbue(locale(locale(), new codecvt_utf8<wchar_t>));
-        wcout.imbue(locale(".UTF-8"));
-        wstring line;
-        while (getline(file, line)) {
-            wcout << line << endl;
+    }
+    if (gameArchive.isEnabled()) {
+        archiveDraft.begin(static_cast<int>(players.size()));
+        for (size_t seat = 0; seat < players.size() && seat < ARCHIVE_MAX_SEATS; seat++) {
+            archiveDraft.roles[seat] = static_cast<uint8_t>(roleTypeOf(*players[seat]));
         }
-        setlocale(LC_ALL, originalLocale.c_str()); // 원래 로케일로 복귀
-        file.close();
-        cout << endl;
-    }
-    catch (const runtime_error& e) {
-        setlocale(LC_ALL, originalLocale.c_str());
-        cout << "1. 게임은 최소 6명의 플레이어가 필요합니다.\n";
-        cout << "2. 각 플레이어는 게임 시작 시 랜덤으로 직업을 부여받습니다.\n";
-        cout << "3. 게임은 낮과 밤으로 진행됩니다.\n";
-        cout << "4. 낮에는 토론과 투표를 통해 용의자를 처형합니다.\n";
-        cout << "5. 밤에는 각자의 직업에 따른 역할을 수행합니다.\n";
-        cout << "6. 마피아를 모두 제거하거나, 마피아가 선량한 시민 수와 같아지면 게임이 종료됩니다.\n\n";
-    }
-    cout << "계속하려면 Enter키를 눌러주세요...";
-    clearInputBuffer();
-    cin.get();
-    system("cls");
+    }
 }
 
-// 게임 진행 함수
-void startVoting()
-{
-    cout << "\n=== 투표를 시작합니다 ===\n";
-    map<shared_ptr<Player>, int> votes;
-    vector<shared_ptr<Player>> alivePlayers;
+GameCheckpoint captureCheckpoint(CheckpointPhase phase, uint8_t winner = 0, uint64_t rngPosition = 0)
+{ // 현재 게임 상태를 체크포인트 레코드로 (이름은 23바이트까지)
+    GameCheckpoint record;
+    memset(&record, 0, sizeof(record));
+    record.gameId = currentGameId;
+    record.rngPosition = rngPosition;
+    record.seed = rngService.seed();
+    record.day = static_cast<uint16_t>(min(currentDay, 65535));
+    record.phase = phase;
+    record.seats = static_cast<uint8_t>(players.size());
+    record.tamed = werewolfTamed;
+    record.rules = static_cast<uint8_t>((gameRules.doctorBeatsArmor ? 1 : 0) | (gameRules.policeSeesWerewolf ? 2 : 0));
+    record.winner = winner;
+    record.room = checkpointRoom;
+    for (int seat = 0; seat < record.seats; seat++) {
+        const Player& player = *players[seat];
+        uint8_t bit = static_cast<uint8_t>(1u << seat);
+        record.roles[seat] = static_cast<uint8_t>(roleTypeOf(player));
+        if (player.checkAlive()) record.alive |= bit;
+        if (roster.isArmorActive(seat)) record.armor |= bit;
+        strncpy(record.names[seat], player.getName().c_str(), CHECKPOINT_NAME_BYTES - 1); // 등록할 때 이름 칸 이내로 제한하므로 잘리지 않음
+    }
+    nightManager.saveSeats(record);
+    return record;
+}
 
-    // 살아있는 플레이어의 목록 생성
-    for (const auto& player : players)
+void saveCheckpoint(CheckpointPhase phase, Winner winner = Winner::None, uint64_t rngPosition = 0, bool wait = true)
+{ // 단계 경계 체크포인트, wait면 결과를 보여 주기 전에 fsync까지 기다림 (같은 묶음의 다른 방과 fsync 한 번을 나눠 씀)
+    if (!checkpointLog.isEnabled() || players.empty() || players.size() > CHECKPOINT_MAX_SEATS) return;
+    uint8_t winnerCode = static_cast<uint8_t>(winner == Winner::Citizen ? 1 : winner == Winner::Mafia ? 2 : 0);
+    GameCheckpoint record = captureCheckpoint(phase, winnerCode, rngPosition);
+    if (wait) checkpointLog.commit(record);
+    else checkpointLog.submit(record);
+}
+
+void restoreNightResults(const GameCheckpoint& record)
+{ // NIGHT_RESOLVED: 결과를 보여 주기 전에 멈춘 방의 좌석별 결과를 submitNightAction과 processActions가 남기는 순서대로 다시 만듦
+    nightResults.clear();
+    auto targetOf = [&record](int seat) { return (record.findings[seat] & 0x0F) - 1; };
+    for (int seat = 0; seat < record.seats; seat++) { // 행동을 고를 때 남는 안내 (좌석 순서로 차례가 돎)
+        int target = targetOf(seat);
+        if (target < 0 || target >= record.seats) continue;
+        const string& actorName = players[seat]->getName();
+        const string& targetName = players[target]->getName();
+        switch (players[seat]->roleInfo().night) {
+        case NIGHT_INVESTIGATE:
+            nightResults.push_back({ actorName, targetName,
+                formatMessage((record.findings[seat] >> 4) ? MSG_POLICE_IS_MAFIA : MSG_POLICE_NOT_MAFIA, targetName), true, false });
+            break;
+        case NIGHT_KILL:
+            nightResults.push_back({ actorName, targetName, formatActionMessage(ROLE_MAFIA, targetName, false), true, false });
+            nightResults.push_back({ "마피아", targetName, formatActionMessage(ROLE_MAFIA, targetName, true), true, false });
+            break;
+        case NIGHT_HEAL:
+            nightResults.push_back({ actorName, targetName, formatMessage(MSG_HEAL_CHOSEN, targetName), true, false });
+            break;
+        case NIGHT_HUNT:
+            nightResults.push_back({ actorName, targetName, formatMessage(MSG_HUNT_CHOSEN, targetName), true, false });
+            break;
+        case NIGHT_TRACK:
+            nightResults.push_back({ actorName, targetName, formatMessage(MSG_TRACK_CHOSEN, targetName), true, false });
+            break;
+        default:
+            break;
+        }
+    }
+    for (int seat = 0; seat < record.seats; seat++) { // 판정 결과 (추적 -> 방탄복 -> 접선 -> 사망)
+        int target = targetOf(seat);
+        if (target < 0 || target >= record.seats || players[seat]->roleInfo().night != NIGHT_TRACK) continue;
+        int seen = (record.findings[seat] >> 4) - 1;
+        const string& targetName = players[target]->getName();
+        string message = seen >= 0 && seen < record.seats
+            ? formatMessage(MSG_TRACK_RESULT, targetName, players[seen]->getName())
+            : formatMessage(MSG_TRACK_NOBODY, targetName);
+        nightResults.push_back({ players[seat]->getName(), targetName, message, true, false });
+    }
+    for (int seat = 0; seat < record.seats; seat++) {
+        if ((record.defended >> seat) & 1) {
+            nightResults.push_back({ players[seat]->getName(), "", formatMessage(MSG_ARMOR_HELD), true, false });
+        }
+    }
+    if (record.tamedTonight && werewolfPlayer) noteTamingResults();
+    for (int seat = 0; seat < record.seats; seat++) {
+        if ((record.dying >> seat) & 1) {
+            nightResults.push_back({ players[seat]->getName(), "", formatMessage(MSG_YOU_DIED), true, true });
+        }
+    }
+}
+
+void restoreCheckpoint(const GameCheckpoint& record)
+{ // beginGame 대신 호출 (게임 아레나 안에서): 체크포인트 시점의 좌석, 생사, 방탄복, 접선, 밤 판정 결과로 되돌림
+    currentGameId = record.gameId;
+    currentDay = record.day;
+    gameRules.doctorBeatsArmor = (record.rules & 1) != 0;
+    gameRules.policeSeesWerewolf = (record.rules & 2) != 0;
     {
-        if (player->checkAlive())
-        {
-            alivePlayers.push_back(player);
+        ArenaBypass bypass; // 참가자 목록은 게임보다 오래 남음
+        playlist.clear();
+        for (int seat = 0; seat < record.seats; seat++) {
+            playlist.push_back(string(record.names[seat], strnlen(record.names[seat], CHECKPOINT_NAME_BYTES)));
         }
     }
+    assignRolesFromDeal(record.roles);
+    for (int seat = 0; seat < record.seats; seat++) {
+        const shared_ptr<Player>& player = players[seat];
+        if (!((record.alive >> seat) & 1)) player->setAlive(false);
+        if (player->roleInfo().armored && !((record.armor >> seat) & 1)) static_cast<Soldier*>(player.get())->defendShot();
+    }
+    if (record.tamed && werewolfPlayer) {
+        auto werewolf = dynamic_pointer_cast<Werewolf>(werewolfPlayer);
+        if (werewolf) werewolf->setTamed(true);
+        mafiaPlayers.push_back(werewolfPlayer);
+        werewolfTamed = true;
+    }
+    roster.rebuild(players, werewolfTamed);
+    nightConflicts.compile(gameRules.doctorBeatsArmor);
+    nightManager.restoreSeats(record);
+    if (record.phase == CHECKPOINT_NIGHT_RESOLVED) restoreNightResults(record);
+    resetPublicState();
+    if (publicChannel) publicDraft.aliveMask &= record.alive;
+}
+
+bool openCheckpoints(const string& path, bool groupCommit = true)
+{ // 체크포인트 파일을 열고, 새 게임 번호가 기록된 방과 겹치지 않도록 넘김
+    if (!checkpointLog.start(path, groupCommit)) return false;
+    uint64_t highest = checkpointLog.maxGameId();
+    uint64_t expected = nextGameId.load();
+    while (expected <= highest && !nextGameId.compare_exchange_weak(expected, highest + 1)) {}
+    return true;
+}
+
+const GameCheckpoint* findInterruptedRoom(CheckpointRoom room, const vector<string>& names)
+{ // 같은 이름들로 진행하다 끝나지 않은 가장 최근 방 (좌석 순서는 달라도 됨)
+    vector<string> wanted(names);
+    sort(wanted.begin(), wanted.end());
+    const GameCheckpoint* found = nullptr;
+    for (const auto& entry : checkpointLog.recovered()) {
+        const GameCheckpoint& record = entry.second;
+        if (record.room != room || record.phase == CHECKPOINT_FINISHED || record.seats != wanted.size()) continue;
+        vector<string> recorded;
+        for (int seat = 0; seat < record.seats; seat++) recorded.push_back(record.names[seat]);
+        sort(recorded.begin(), recorded.end());
+        if (recorded == wanted) found = &record;
+    }
+    return found;
+}
+
+bool gameArenaEnabled = true; // false면 게임 중 할당도 malloc 사용 (비교용)
+
+void releaseGameState()
+{ // 게임이 쓰던 전역 상태를 비우고 보관 메모리까지 반환
+    vector<shared_ptr<Player>>().swap(players);
+    vector<shared_ptr<Player>>().swap(mafiaPlayers);
+    mafiaTargetPlayer = nullptr;
+    previousMafia = nullptr;
+    werewolfPlayer = nullptr;
+    vector<NightResult>().swap(nightResults);
+    nightManager.release();
+    string().swap(mafiaTarget);
+    string().swap(werewolfTarget);
+    roster.release();
+}
+
+class GameArenaScope
+{ // 게임 한 판의 할당을 스레드별 아레나로 받고, 끝나면 상태를 비운 뒤 한 번에 리셋
+private:
+    GameArena* arena = nullptr;
+    AllocationStats before;
+
+public:
+    GameArenaScope()
+    {
+        nightManager.clear(); // 스레드별 관리자 생성(우선순위 표)은 아레나 밖에서
+        before = allocationStats;
+        if (gameArenaEnabled) {
+            arena = arenaPool.acquire();
+            activeArena = arena;
+        }
+    }
+
+    ~GameArenaScope()
+    {
+        releaseGameState();
+        activeArena = nullptr;
+        bool retired = arena && !arenaPool.recycle(arena);
+
+        const AllocationStats& after = allocationStats;
+        metricsIncrement(COUNTER_HEAP_ALLOCATIONS, after.heapCalls - before.heapCalls);
+        metricsIncrement(COUNTER_HEAP_BYTES, after.heapBytes - before.heapBytes);
+        metricsIncrement(COUNTER_ARENA_ALLOCATIONS, after.arenaCalls - before.arenaCalls);
+        metricsIncrement(COUNTER_ARENA_BYTES, after.arenaBytes - before.arenaBytes);
+        if (retired) metricsIncrement(COUNTER_ARENA_RETIRED);
+    }
+
+    GameArenaScope(const GameArenaScope&) = delete;
+    GameArenaScope& operator=(const GameArenaScope&) = delete;
+};
+
+void beginNight()
+{ // 밤 시작 시 이전 밤의 상태 초기화
+    nightResults.clear();
+    mafiaTarget.clear(); // 마피아 타겟 초기화
+    werewolfTarget.clear(); // 늑대인간 타겟 초기화
+    mafiaTargetPlayer = nullptr;
+    previousMafia = nullptr;
+    publishPublicState(PUBLIC_NIGHT);
+}
+
+DayReport resolveDay()
+{ // 밤 사이 사망자 반영 및 의사 치료 판정 (판정 결과는 processActions가 좌석 비트로 남김)
+    DayReport report;
+
+    // 방어 성공 여부
+    report.defendedName = nightManager.getDefendedPlayerName();
+    if (!report.defendedName.empty()) {
+        report.anyEvent = true;
+        report.anyAttack = true;
+    }
+
+    // 밤 판정에서 사망 예정이 된 좌석 (방탄복으로 버틴 좌석은 들어 있지 않음)
+    for (uint64_t rest = nightManager.pendingDeathSeats(); rest; rest &= rest - 1) {
+        const shared_ptr<Player>& target = players[__builtin_ctzll(rest)];
+        target->setAlive(false);
+        if (auditLog.isEnabled()) auditEvent(currentGameId, currentDay, AUDIT_DEATH, seatOf(target));
+        notePublicDeath(target, DEATH_NIGHT);
+        report.deathMessages.push_back(formatMessage(MSG_PLAYER_DIED, target->getName()));
+        report.anyEvent = true;
+        report.anyAttack = true;
+    }
+
+    // 의사 치료 체크 (공격받은 좌석 중 치료 대상, 치료 대상은 밤에 죽지 않음)
+    uint64_t attacked = nightManager.attackedSeats();
+    if (attacked) report.anyAttack = true;
+    uint64_t saved = attacked & nightManager.healSeats();
+    shared_ptr<Player> healTarget = saved ? players[__builtin_ctzll(saved)] : nullptr;
+    if (healTarget && healTarget->checkAlive()) {
+        report.savedPlayerName = healTarget->getName();
+        report.anyEvent = true;
+    }
+
+    if (eventRing) { // startDay가 출력하는 발표와 같은 내용 (사망은 위에서 보냄)
+        for (uint64_t rest = nightManager.defendedSeatMask(); rest; rest &= rest - 1) {
+            emitPublicEvent(EVENT_DEFENDED, static_cast<uint8_t>(__builtin_ctzll(rest)));
+        }
+        if (healTarget && !report.savedPlayerName.empty()) emitPublicEvent(EVENT_SAVED, seatOf(healTarget));
+        if (report.deathMessages.empty() && !report.anyEvent && !report.anyAttack) emitPublicEvent(EVENT_QUIET);
+    }
+    publishPublicState(PUBLIC_DAY);
+    return report;
+}
+
+void beginVoting()
+{ // 투표 시작 (대화형 진행과 시뮬레이션 공통)
+    publishPublicState(PUBLIC_VOTE);
+}
+
+void castBallot(map<shared_ptr<Player>, int>& votes, const shared_ptr<Player>& voter, const shared_ptr<Player>& target)
+{ // 1차 투표 한 표 반영 (target이 nullptr이면 기권)
+    if (target) votes[target]++;
+    if (auditLog.isEnabled()) auditEvent(currentGameId, currentDay, AUDIT_VOTE, seatOf(voter), target ? seatOf(target) : AUDIT_NO_SEAT);
+}
+
+VoteTally tallyVotes(const map<shared_ptr<Player>, int>& votes)
+{ // 최다 득표자 확인
+    LatencyTimer timer(LATENCY_VOTE_RESOLUTION);
+    VoteTally tally;
+
+    for (const auto& vote : votes) {
+        if (vote.second > tally.maxVotes) {
+            tally.maxVotes = vote.second;
+            tally.maxVotePlayer = vote.first;
+            tally.isDuplicate = false;
+        }
+        else if (vote.second == tally.maxVotes) {
+            tally.isDuplicate = true;
+        }
+    }
+
+    if (eventRing) { // 득표 현황과 무효 여부 방송 (startVoting의 무효 안내와 같은 조건)
+        for (const auto& vote : votes) {
+            emitPublicEvent(EVENT_VOTE_TALLY, seatOf(vote.first), static_cast<uint16_t>(vote.second));
+        }
+        if (tally.maxVotes == 0) emitPublicEvent(EVENT_VOTE_VOID, EVENT_NO_SEAT, 0);
+        else if (tally.isDuplicate) emitPublicEvent(EVENT_VOTE_VOID, EVENT_NO_SEAT, 1);
+    }
+    return tally;
+}
+
+bool resolveFinalVote(const shared_ptr<Player>& candidate, int agree, int disagree)
+{ // 찬반 투표 결과 반영, 처형 여부 반환
+    if (auditLog.isEnabled())
+        auditEvent(currentGameId, currentDay, AUDIT_FINAL_VOTE, seatOf(candidate), AUDIT_NO_SEAT,
+            static_cast<uint16_t>(agree), static_cast<uint16_t>(disagree));
+    emitPublicEvent(EVENT_FINAL_VOTE, seatOf(candidate), static_cast<uint16_t>(agree), static_cast<uint16_t>(disagree));
+    if (agree > disagree) {
+        candidate->setAlive(false);
+        if (auditLog.isEnabled()) auditEvent(currentGameId, currentDay, AUDIT_EXECUTION, seatOf(candidate));
+        notePublicDeath(candidate, DEATH_EXECUTION);
+        return true;
+    }
+    return false;
+}
+
+Winner evaluateVictory()
+{ // 생존자 기준 승리 팀 판정 (팀별 생존 수는 RosterCache가 유지)
+#ifdef NAPOLY_VERIFY_ROSTER // 승리 판정마다 전체 재계산과 비교 (재계산과 할당이 생기므로 기본 빌드에서는 끔)
+    assert(roster.matchesRebuild(werewolfTamed));
+#endif
+    return roster.victory();
+}
+
+void recordGameFinished(Winner winner)
+{ // 게임 종료 지표 기록
+    uint8_t winnerCode = static_cast<uint8_t>(winner == Winner::Citizen ? 1 : winner == Winner::Mafia ? 2 : 0);
+    metricsIncrement(COUNTER_GAMES_FINISHED);
+    if (winner == Winner::Citizen) metricsIncrement(COUNTER_CITIZEN_WINS);
+    else if (winner == Winner::Mafia) metricsIncrement(COUNTER_MAFIA_WINS);
+    else metricsIncrement(COUNTER_DRAWS);
+    auditEvent(currentGameId, currentDay, AUDIT_GAME_END, AUDIT_NO_SEAT, AUDIT_NO_SEAT, winnerCode);
+    if (gameArchive.isEnabled()) archiveGameFinished(winnerCode, currentDay);
+    if (ratingResults.isEnabled()) { // 평점 계산용: 좌석별 이름과 끝난 시점의 마피아 팀
+        vector<string> names;
+        uint8_t mafiaTeam = 0;
+        for (size_t seat = 0; seat < players.size() && seat < RATING_MAX_SEATS; seat++) {
+            names.push_back(players[seat]->getName());
+            RoleTeam team = players[seat]->roleInfo().team;
+            if (team == TEAM_MAFIA || (team == TEAM_WEREWOLF && werewolfTamed)) mafiaTeam |= static_cast<uint8_t>(1u << seat);
+        }
+        ratingResults.record(names, mafiaTeam, winnerCode, currentDay, currentGameId);
+    }
+    saveCheckpoint(CHECKPOINT_FINISHED, winner);
+    publishPublicState(PUBLIC_FINISHED, winner);
+}
+
+void announceFinalVote(const shared_ptr<Player>& candidate, int agree, int disagree)
+{ // 찬반 결과 발표와 처형 반영 (대화형 진행과 소켓 테이블 공통)
+    printMessage(MSG_FINAL_VOTE_RESULT, to_string(agree), to_string(disagree));
+    if (resolveFinalVote(candidate, agree, disagree)) printMessage(MSG_EXECUTED, candidate->getName());
+    else printMessage(MSG_FINAL_VOTE_FAILED);
+}
+
+void announceVoidVote(const VoteTally& tally)
+{ // 찬반 투표 없이 끝난 1차 투표 안내
+    if (tally.maxVotes == 0) printMessage(MSG_NOBODY_VOTED);
+    else printMessage(MSG_VOTE_TIED);
+}
+
+// 게임 진행 함수
+void startVoting()
+{
+    PhaseScope scope(PHASE_VOTING);
+
+    printMessage(MSG_VOTE_HEADER);
+    beginVoting();
+    map<shared_ptr<Player>, int> votes;
+    const vector<shared_ptr<Player>> alivePlayers = roster.aliveRoster(); // 처형 전 생존자
     // 1차 투표 진행
-    for (const auto& voter : players)
+    for (size_t seat = 0; seat < players.size(); seat++)
     {
+        const auto& voter = players[seat];
         if (voter->checkAlive() && voter->getCanVote())
         {
+            TraceSpan seatSpan("vote turn", "seat", currentDay, static_cast<int>(seat));
             system("cls");
             cout << "=== 투표 진행 중 ===\n\n";
             cout << voter->getName() << "의 투표\n\n";
@@ -966,11 +1499,12 @@ void startVoting()
                 cout << "\n투표할 대상을 선택하세요 : ";
                 if (cin >> choice) {
                     if (choice == 0) {
+                        castBallot(votes, voter, nullptr);
                         cout << "투표를 기권했습니다.\n";
                         break;
                     }
                     else if (choice > 0 && choice <= static_cast<int>(alivePlayers.size())) {
-                        votes[alivePlayers[choice - 1]]++;
+                        castBallot(votes, voter, alivePlayers[choice - 1]);
                         break;
                     }
                 }
@@ -981,25 +1515,11 @@ void startVoting()
         }
     }
 
-    // 최다 득표자 확인
-    shared_ptr<Player> maxVotePlayer = nullptr;
-    int maxVotes = 0;
-    bool isDuplicate = false;
-
-    for (const auto& vote : votes) {
-        if (vote.second > maxVotes) {
-            maxVotes = vote.second;
-            maxVotePlayer = vote.first;
-            isDuplicate = false;
-        }
-        else if (vote.second == maxVotes) {
-            isDuplicate = true;
-        }
-    }
+    VoteTally tally = tallyVotes(votes);
 
     // 최다 득표자가 한 명일 경우에만 찬반 투표 진행
-    if (maxVotePlayer && !isDuplicate && maxVotes > 0) {
-        cout << "\n=== " << maxVotePlayer->getName() << "님에 대한 최종 찬반 투표를 진행합니다 ===\n";
+    if (tally.maxVotePlayer && !tally.isDuplicate && tally.maxVotes > 0) {
+        printMessage(MSG_FINAL_VOTE_HEADER, tally.maxVotePlayer->getName());
         int agree = 0, disagree = 0;
 
         for (const auto& voter : players) {
@@ -1011,20 +1531,10 @@ void startVoting()
                 else if (choice == 2) disagree++;
             }
         }
-        cout << "\n=== 찬반 투표 결과 ===\n";
-        cout << "찬성: " << agree << "표\n";
-        cout << "반대: " << disagree << "표\n";
-
-        if (agree > disagree) {
-            cout << maxVotePlayer->getName() << "님이 투표로 처형되었습니다.\n";
-            maxVotePlayer->setAlive(false);
-        }
-        else cout << "과반수를 넘기지 않아 무효처리 되었습니다.\n";
-    }
-    else {
-        if (maxVotes == 0) cout << "\n아무도 투표하지 않았습니다\n";
-        else cout << "투표자 동률 발생으로 인해 투표가 무효처리 되었습니다\n";
+        announceFinalVote(tally.maxVotePlayer, agree, disagree);
     }
+    else announceVoidVote(tally);
+    saveCheckpoint(CHECKPOINT_VOTED);
     cout << "5초 후에 게임이 재개됩니다.\n";
     std::this_thread::sleep_for(std::chrono::seconds(5)); // 결과를 볼 수 있도록 5초의 딜레이
 
@@ -1042,58 +1552,96 @@ void startGame()
     }
 
     cout << "게임이 시작되었습니다\n\n";
-    assignRoles();
-    currentDay = 1;
+    TraceSpan gameSpan("game", "game");
+    GameArenaScope arena;
+    beginGame();
+    saveCheckpoint(CHECKPOINT_DEALT);
+    continueGame(CHECKPOINT_DEALT);
+}
 
+void continueGame(int phase)
+{ // phase: 마지막으로 남긴 체크포인트 단계 (새 게임은 CHECKPOINT_DEALT), 그 다음 단계부터 진행
+    if (phase == CHECKPOINT_NIGHT_RESOLVED) showEachPlayerResults(); // 밤 결과를 보기 전에 멈춘 방
     while (true)
     {
-        startNight(); // 밤 진행 (능력 사용)
+        if (phase < CHECKPOINT_NIGHT_RESOLVED) startNight(); // 밤 진행 (능력 사용)
 
-        if (checkVictoryCondition())
-        { // 밤 행동 후 승리 조건 체크
-            break;
+        if (phase < CHECKPOINT_DAY_APPLIED) {
+            if (checkVictoryCondition())
+            { // 밤 행동 후 승리 조건 체크
+                break;
+            }
+            announceDay(); // 낮 진행 (결과 처리, 생존자 목록)
         }
 
-        startDay(); // 낮 진행 (결과 처리, 생존자 목록, 토론)
+        if (phase < CHECKPOINT_VOTED) discussAndVote(); // 토론과 투표
 
         if (checkVictoryCondition())
         { // 투표 후 승리 조건 체크
             break;
         }
 
+        phase = CHECKPOINT_DEALT;
         currentDay++;
     }
 }
 
+void resumeInterruptedGames()
+{ // 프로그램 시작 시 끝나지 않은 대화형 방마다 이어서 진행할지 물음 (진행하지 않은 방은 끝난 것으로 기록)
+    if (!checkpointLog.isEnabled()) return;
+    vector<GameCheckpoint> unfinished;
+    for (const auto& entry : checkpointLog.recovered()) {
+        const GameCheckpoint& record = entry.second;
+        if (record.room == CHECKPOINT_ROOM_CONSOLE && record.phase != CHECKPOINT_FINISHED) unfinished.push_back(record);
+    }
+
+    for (const GameCheckpoint& record : unfinished) {
+        string names;
+        for (int seat = 0; seat < record.seats; seat++) {
+            if (!names.empty()) names += ", ";
+            names += string(record.names[seat], strnlen(record.names[seat], CHECKPOINT_NAME_BYTES));
+        }
+        printMessage(MSG_CHECKPOINT_FOUND, to_string(record.gameId), to_string(record.day), names);
+        string input = "N";
+        cin >> input;
+        clearInputBuffer();
+        if (input == "Y" || input == "y" || input == "ㅛ") { // 한글 입력 상태의 y
+            TraceSpan gameSpan("game", "game");
+            GameArenaScope arena;
+            restoreCheckpoint(record);
+            printMessage(MSG_CHECKPOINT_RESUMED, to_string(record.gameId), to_string(record.day));
+            continueGame(record.phase);
+        }
+        else {
+            GameCheckpoint closed = record;
+            closed.phase = CHECKPOINT_FINISHED;
+            closed.winner = 0;
+            checkpointLog.commit(closed);
+        }
+    }
+}
+
 bool checkVictoryCondition()
 {
-    int mafiaCount = 0;
-    int citizenCount = 0;
-    for (const auto& player : players)
+    Winner winner;
     {
-        if (player->checkAlive())
-        {
-            if (player->getRole() == "마피아" || (player->getRole() == "늑대인간" && werewolfTamed))
-            {
-                mafiaCount++;
-            }
-            else
-                citizenCount++;
-        }
+        PhaseScope scope(PHASE_VICTORY_CHECK);
+        winner = evaluateVictory();
     }
+    if (winner != Winner::None) recordGameFinished(winner);
 
-    if (mafiaCount == 0)
+    if (winner == Winner::Citizen)
     {
-        cout << "\n시민 팀이 승리했습니다!\n";
+        printMessage(MSG_CITIZEN_WIN);
         cout << "\n 계속하려면 Enter키를 눌러주세요...";
         clearInputBuffer();
         cin.get();
         system("cls");
         return true;
     }
-    else if (mafiaCount >= citizenCount)
+    else if (winner == Winner::Mafia)
     {
-        cout << "\n마피아 팀이 승리했습니다\n";
+        printMessage(MSG_MAFIA_WIN);
         cout << "\n계속하려면 Enter키를 눌러주세요...";
         clearInputBuffer();
         cin.get();
@@ -1105,47 +1653,56 @@ bool checkVictoryCondition()
 
 void startNight()
 {
-    cout << "\n=== " << currentDay << "번째 밤이 되었습니다 ===\n\n";
-    nightResults.clear();
-    mafiaTarget.clear(); // 마피아 타겟 초기화
-    werewolfTarget.clear(); // 늑대인간 타겟 초기화
-    mafiaTargetPlayer = nullptr;
-    previousMafia = nullptr;
+    printMessage(MSG_NIGHT_HEADER, to_string(currentDay));
+    beginNight();
 
     // 단계 1: 살아있는 플레이어의 능력 사용
-    for (const auto& player : players)
     {
-        if (!player->checkAlive())
-            continue; // 죽은 플레이어 스킵
-
-        system("cls");
-        char input;
-        while (true)
+        PhaseScope scope(PHASE_NIGHT_INPUT);
+        for (size_t seat = 0; seat < players.size(); seat++)
         {
-            cout << player->getName() << "님이 맞으시다면 Y를 입력해주세요: ";
-            cin >> input;
-            if (input == 'Y' || input == 'y' || input == 'ㅛ')
-                break;
-            cout << player->getName() << "님이 아닌 것 같습니다. 해당 플레이어가 직접 시도해주세요.\n";
-            clearInputBuffer();
-        }
+            const auto& player = players[seat];
+            if (!player->checkAlive())
+                continue; // 죽은 플레이어 스킵
 
-        // 직업 확인 및 능력 사용
-        cout << "\n=== " << player->getName() << "님의 차례 ===\n";
-        cout << "당신의 직업은 " << player->getRole() << "입니다.\n\n";
+            TraceSpan seatSpan("night turn", "seat", currentDay, static_cast<int>(seat));
+            system("cls");
+            char input;
+            while (true)
+            {
+                cout << player->getName() << "님이 맞으시다면 Y를 입력해주세요: ";
+                cin >> input;
+                if (input == 'Y' || input == 'y' || input == 'ㅛ')
+                    break;
+                cout << player->getName() << "님이 아닌 것 같습니다. 해당 플레이어가 직접 시도해주세요.\n";
+                clearInputBuffer();
+            }
 
-        // 능력 사용
-        yourTurn(player);
+            // 직업 확인 및 능력 사용
+            printMessage(MSG_YOUR_TURN, player->getName(), player->getRole());
 
-        cout << "\n다음 플레이어로 넘어가려면 Enter키를 눌러주세요...";
-        clearInputBuffer();
-        cin.get();
+            // 능력 사용
+            yourTurn(player);
+
+            cout << "\n다음 플레이어로 넘어가려면 Enter키를 눌러주세요...";
+            clearInputBuffer();
+            cin.get();
+        }
     }
 
     // 단계 2: 행동 결과 처리
-    nightManager.processActions();
+    {
+        PhaseScope scope(PHASE_PROCESS_ACTIONS);
+        nightManager.processActions();
+    }
+    saveCheckpoint(CHECKPOINT_NIGHT_RESOLVED); // 결과를 보여 주기 전에 남김
 
     // 단계 3: 각 플레이어별 결과 확인
+    showEachPlayerResults();
+}
+
+void showEachPlayerResults()
+{ // 살아 있는 플레이어가 차례로 본인 확인 후 밤 결과를 봄 (밤 판정 직후, 또는 그 시점에서 이어서 진행할 때)
     for (const auto& player : players)
     {
         if (!player->checkAlive())
@@ -1163,7 +1720,7 @@ void startNight()
             clearInputBuffer();
         }
 
-        cout << "\n=== " << player->getName() << "님의 결과 ===\n";
+        printMessage(MSG_RESULTS_HEADER, player->getName());
         showResults(player->getName());
 
         cout << "\n다음 플레이어로 넘어가려면 아무 키나 누르세요...";
@@ -1172,90 +1729,55 @@ void startNight()
     }
 }
 
-void startDay() {
-    cout << "\n=== " << currentDay << "번째 날이 밝았습니다 ===\n";
+void announceDay()
+{ // 낮 발표: 밤 결과 반영, 사망/방어/치료 안내, 생존자 목록 (대화형 진행과 소켓 테이블 공통)
+    PhaseScope scope(PHASE_DAY_ANNOUNCE);
+    printMessage(MSG_DAY_HEADER, to_string(currentDay));
 
-    bool anyEvent = false;
-    bool anyAttack = false;
-    bool doctorSaved = false;
-    string savedPlayerName;
-    vector<string> deathMessages; // 사망 메시지 수집용
+    DayReport report = resolveDay();
 
     // 방어 성공 시 메시지 출력
-    string defendedName = nightManager.getDefendedPlayerName();
-    if (!defendedName.empty()) {
-        cout << defendedName << "님이 방탄복으로 마피아의 총격을 버텨냈습니다!\n";
-        anyEvent = true;
-        anyAttack = true;
-    }
-
-    for (const auto& result : nightResults) {
-        if (result.playerName == "SYSTEM" && result.message == "DEATH_MARK") {
-            auto target = find_if(players.begin(), players.end(),
-                [&result](const shared_ptr<Player>& p) {
-                    return p->getName() == result.targetName;
-                });
-            // 방어에 성공한 플레이어 제외하고 사망
-            if (target != players.end() && target->get()->getName() != defendedName) {
-                (*target)->setAlive(false);
-                deathMessages.push_back(result.targetName + "님이 사망했습니다.");
-                anyEvent = true;
-                anyAttack = true;
-            }
-        }
-    }
-
-    // 의사 치료 헤크
-    for (const auto& action : nightManager.getActions()) {
-        if (action.actor->getRole() == "마피아" ||
-            (action.actor->getRole() == "늑대인간" &&
-                dynamic_pointer_cast<Werewolf>(action.actor)->isTamed())) {
-            anyAttack = true;
-        }
-        else if (action.actor->getRole() == "의사") {
-            if (action.target->checkAlive() &&
-                any_of(nightManager.getActions().begin(), nightManager.getActions().end(),
-                    [&action](const NightAction& attack) {
-                        return (attack.actor->getRole() == "마피아" ||
-                            (attack.actor->getRole() == "늑대인간" &&
-                                dynamic_pointer_cast<Werewolf>(attack.actor)->isTamed())) &&
-                            attack.target == action.target;
-                    })) {
-                doctorSaved = true;
-                savedPlayerName = action.target->getName();
-            }
-        }
+    if (!report.defendedName.empty()) {
+        printMessage(MSG_ARMOR_DEFENDED, report.defendedName);
     }
 
-    if (doctorSaved) {
-        cout << savedPlayerName << "님이 의사의 치료를 받고 살아났습니다!\n";
-        anyEvent = true;
+    if (!report.savedPlayerName.empty()) {
+        printMessage(MSG_DOCTOR_SAVED, report.savedPlayerName);
     }
 
     // 메시지 출력
-    if (!deathMessages.empty()) {
-        for (const auto& msg : deathMessages) {
+    if (!report.deathMessages.empty()) {
+        for (const auto& msg : report.deathMessages) {
             cout << msg << endl;
         }
     }
-    else if (!anyEvent && !anyAttack) {
-        cout << "아무런 일도 일어나지 않았습니다.\n";
+    else if (!report.anyEvent && !report.anyAttack) {
+        printMessage(MSG_NOTHING_HAPPENED);
     }
 
     nightManager.clear();
+    saveCheckpoint(CHECKPOINT_DAY_APPLIED);
 
     // 생존자 확인
-    cout << "\n=== 생존자 목록 ===\n";
+    printMessage(MSG_SURVIVORS_HEADER);
     for (const auto& player : players) {
         if (player->checkAlive()) {
             cout << player->getName() << "\n";
         }
     }
+}
 
-    cout << "\n토론 시간입니다. 30초 후 투표가 시작됩니다...\n";
+void discussAndVote()
+{ // 토론 시간 후 투표
+    printMessage(MSG_DISCUSSION, "30");
     std::this_thread::sleep_for(std::chrono::seconds(30));
 
     startVoting();
 }
 
-#endif // FUNCTION_H
\ No newline at end of file
+void startDay() {
+    announceDay();
+    discussAndVote();
+}
+
+#endif // FUNCTION_H
@@ -0,0 +1,374 @@
+// fuzz.h
+#ifndef FUZZ_H
+#define FUZZ_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nightcheck.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// 규칙 퍼저: 무작위 배정, 밤 행동, 투표로 만든 사례를 실제 규칙 함수(processActions, resolveDay의 사망 반영,
+// 투표 집계와 처형)로 진행하며 불변식과 예전 순차 판정(referenceNight)을 확인
+// 실패한 사례는 좌석 제거, 행동/투표 제거, 상태 단순화를 반복해 같은 검사가 여전히 실패하는 가장 작은 사례로 줄임
+// 사례 번호마다 난수 스트림이 정해져 있으므로 (시드, 번호)로 같은 사례를 다시 만들 수 있음
+
+struct FuzzCase
+{
+    NightCase night;            // 배정, 생사, 접선, 방탄복, 밤 대상
+    bool doctorBeatsArmor = false;
+    uint8_t ballots[8] = {};    // 좌석별 1차 투표: 0은 기권, k는 투표 시점 생존자 중 (k-1) % 생존자 수 번째
+    uint8_t agree = 0;          // 찬반 투표에서 찬성하는 좌석
+};
+
+bool fuzzCaseOngoing(const NightCase& c)
+{ // 밤이 올 수 있는 상태인지 (evaluateVictory와 같은 기준: 마피아 팀이 남아 있고 시민 팀보다 많음)
+    int mafia = 0, total = 0;
+    for (int seat = 0; seat < c.seats; seat++) {
+        if (!((c.alive >> seat) & 1)) continue;
+        total++;
+        RoleTeam team = roleRegistry[c.roles[seat]].team;
+        if (team == TEAM_MAFIA || (team == TEAM_WEREWOLF && c.tamed)) mafia++;
+    }
+    return mafia > 0 && total - mafia > mafia;
+}
+
+FuzzCase makeFuzzCase(uint64_t seed, uint64_t index)
+{ // 4~8인, 마피아 1~3명, 늑대인간/경찰/의사/사립 탐정 최대 1명, 군인 최대 2명, 나머지 시민
+    GameRng gen(seed, index + 1, RNG_STREAM_DECISION);
+    FuzzCase fc;
+    NightCase& c = fc.night;
+    while (true) {
+        c = NightCase();
+        c.seats = 4 + static_cast<int>(boundedRandom(gen, 5));
+        vector<uint8_t> deck(1 + boundedRandom(gen, 3), ROLE_MAFIA);
+        for (uint8_t role : { ROLE_WEREWOLF, ROLE_POLICE, ROLE_DOCTOR, ROLE_DETECTIVE, ROLE_SOLDIER, ROLE_SOLDIER }) {
+            if (static_cast<int>(deck.size()) < c.seats && (gen() & 1)) deck.push_back(role);
+        }
+        deck.resize(c.seats, ROLE_CITIZEN);
+        for (int i = c.seats - 1; i > 0; i--) swap(deck[i], deck[boundedRandom(gen, i + 1)]);
+        copy(deck.begin(), deck.end(), c.roles);
+
+        uint32_t bits = gen();
+        for (int seat = 0; seat < c.seats; seat++) {
+            if ((bits >> (2 * seat)) & 3) c.alive |= 1u << seat; // 좌석마다 3/4 확률로 생존
+            if (c.roles[seat] == ROLE_WEREWOLF) c.tamed = (bits >> 16) & 1;
+            if (c.roles[seat] == ROLE_SOLDIER && ((bits >> (17 + seat)) & 1)) c.armor |= 1u << seat;
+        }
+        if (fuzzCaseOngoing(c)) break;
+    }
+
+    vector<int> alive;
+    for (int seat = 0; seat < c.seats; seat++) {
+        if ((c.alive >> seat) & 1) alive.push_back(seat);
+    }
+    for (int seat = 0; seat < c.seats; seat++) {
+        bool acts = ((c.alive >> seat) & 1) && roleRegistry[c.roles[seat]].night != NIGHT_NONE;
+        c.target[seat] = static_cast<int8_t>(acts ? alive[boundedRandom(gen, static_cast<uint32_t>(alive.size()))] : -1);
+        fc.ballots[seat] = static_cast<uint8_t>(boundedRandom(gen, 9));
+    }
+    fc.agree = static_cast<uint8_t>(gen());
+    fc.doctorBeatsArmor = gen() & 1;
+    return fc;
+}
+
+uint8_t playerSeatMask(const vector<shared_ptr<Player>>& list)
+{
+    uint8_t mask = 0;
+    for (const auto& player : list) {
+        uint8_t seat = seatOf(player);
+        if (seat < 8) mask |= static_cast<uint8_t>(1u << seat);
+    }
+    return mask;
+}
+
+uint8_t aliveSeatMask()
+{
+    uint8_t mask = 0;
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        if (players[seat]->checkAlive()) mask |= static_cast<uint8_t>(1u << seat);
+    }
+    return mask;
+}
+
+uint8_t armorSeatMask()
+{
+    uint8_t mask = 0;
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        if (players[seat]->roleInfo().armored && static_cast<const Soldier&>(*players[seat]).isArmorActive()) {
+            mask |= static_cast<uint8_t>(1u << seat);
+        }
+    }
+    return mask;
+}
+
+string runFuzzCase(const FuzzCase& fc)
+{ // 실패한 검사 이름과 내용을 반환 (통과했거나 밤이 올 수 없는 사례면 빈 문자열)
+    const NightCase& c = fc.night;
+    if (!fuzzCaseOngoing(c)) return "";
+    while (static_cast<int>(playlist.size()) > c.seats) playlist.pop_back();
+    while (static_cast<int>(playlist.size()) < c.seats) playlist.push_back("P" + to_string(playlist.size() + 1));
+    gameRules.doctorBeatsArmor = fc.doctorBeatsArmor;
+
+    GameArenaScope arena;
+    enterNight(c);
+    if (evaluateVictory() != Winner::None) return "승리 판정: 진행 중인 상태를 게임 종료로 판정";
+    uint8_t alive0 = aliveSeatMask();
+    uint8_t armor0 = armorSeatMask();
+    vector<Player*> mafia0;
+    for (const auto& member : mafiaPlayers) mafia0.push_back(member.get());
+    bool tamed0 = werewolfTamed;
+
+    // 밤
+    submitNightCase(c);
+    NightVerdict v;
+    v.dies = static_cast<uint8_t>(nightManager.pendingDeathSeats());
+    v.defended = static_cast<uint8_t>(nightManager.defendedSeatMask());
+    v.tamed = werewolfTamed;
+    if (v.dies & ~alive0) return "중복 사망: 이미 죽은 좌석이 다시 사망 예정";
+    if (v.defended & ~armor0) return "방탄복 중복 사용: 방탄복이 없는 좌석이 총격을 버팀";
+    if (armorSeatMask() != (armor0 & ~v.defended)) return "방탄복 중복 사용: 방어 좌석과 소모된 방탄복이 다름";
+    if (v.dies & v.defended) return "중복 사망: 방탄복으로 버틴 좌석이 사망 예정";
+    size_t grown = mafiaPlayers.size() - min(mafiaPlayers.size(), mafia0.size());
+    if (mafiaPlayers.size() < mafia0.size() || !equal(mafia0.begin(), mafia0.end(), mafiaPlayers.begin(),
+        [](const Player* before, const shared_ptr<Player>& after) { return before == after.get(); }))
+        return "마피아 팀 변경: 기존 구성원이 바뀜";
+    if (grown != static_cast<size_t>(v.tamed && !tamed0) || (grown && mafiaPlayers.back() != werewolfPlayer))
+        return "마피아 팀 변경: 접선한 늑대인간 외의 합류";
+
+    DayReport report = resolveDay();
+    for (int seat = 0; seat < c.seats; seat++) {
+        if (!report.savedPlayerName.empty() && players[seat]->getName() == report.savedPlayerName) v.saved = seat;
+    }
+    v.anyEvent = report.anyEvent;
+    v.anyAttack = report.anyAttack;
+    nightManager.clear();
+    uint8_t alive1 = aliveSeatMask();
+    if (alive1 != (alive0 & ~v.dies)) return "중복 사망: 낮 발표의 사망자와 밤 판정이 다름";
+    if (report.deathMessages.size() != static_cast<size_t>(__builtin_popcount(v.dies)))
+        return "중복 사망: 사망 발표 수가 사망자 수와 다름";
+    if (!(v == referenceNight(c, fc.doctorBeatsArmor))) return "순차 판정 불일치: 밤 결과가 referenceNight와 다름";
+    if (playerSeatMask(roster.aliveRoster()) != alive1) return "생존자 캐시: 생존자 목록이 좌석 생사와 다름";
+    if (!roster.matchesRebuild(werewolfTamed)) return "생존자 캐시: 팀별 생존 수나 방탄복이 전체 재계산과 다름";
+    if (evaluateVictory() != Winner::None) return "";
+
+    // 투표 (botVoting과 같은 순서, 선택만 사례에서)
+    beginVoting();
+    const vector<shared_ptr<Player>> voters = roster.aliveRoster();
+    map<shared_ptr<Player>, int> votes;
+    int counts[8] = {};
+    for (const auto& voter : voters) {
+        uint8_t ballot = fc.ballots[seatOf(voter)];
+        const shared_ptr<Player>& target = ballot ? voters[(ballot - 1) % voters.size()] : nullptr;
+        castBallot(votes, voter, target);
+        if (target) counts[seatOf(target)]++;
+    }
+    int most = 0, leaders = 0, expected = -1;
+    for (int seat = 0; seat < c.seats; seat++) {
+        if (counts[seat] > most) { most = counts[seat]; leaders = 1; expected = seat; }
+        else if (counts[seat] == most && most > 0) leaders++;
+    }
+    if (leaders != 1) expected = -1;
+    VoteTally tally = tallyVotes(votes);
+    int candidate = tally.maxVotePlayer && !tally.isDuplicate && tally.maxVotes > 0 ? seatOf(tally.maxVotePlayer) : -1;
+    if (candidate != expected) return "투표 집계 불일치: 단독 최다 득표자가 다름";
+    if (candidate < 0) return "";
+
+    int agree = 0, disagree = 0;
+    for (const auto& voter : voters) {
+        if ((fc.agree >> seatOf(voter)) & 1) agree++;
+        else disagree++;
+    }
+    bool executed = resolveFinalVote(tally.maxVotePlayer, agree, disagree);
+    if (executed != (agree > disagree)) return "처형 판정 불일치: 찬성이 과반인데 처형 여부가 다름";
+    if (aliveSeatMask() != (alive1 & ~(executed ? 1u << candidate : 0u))) return "중복 사망: 처형 후 생사가 다름";
+    return "";
+}
+
+string fuzzFailureKind(const string& failure)
+{ // 축소할 때 같은 종류의 실패인지 비교하는 기준 (콜론 앞)
+    return failure.substr(0, failure.find(':'));
+}
+
+vector<FuzzCase> shrinkCandidates(const FuzzCase& fc)
+{ // 더 작은 사례 후보: 좌석 제거, 직업을 시민으로, 부활, 행동/투표/찬성 제거, 접선/방탄복/규칙 해제
+    vector<FuzzCase> out;
+    const NightCase& c = fc.night;
+    for (int removed = c.seats - 1; removed >= 0 && c.seats > 1; removed--) {
+        FuzzCase next;
+        NightCase& n = next.night;
+        next.doctorBeatsArmor = fc.doctorBeatsArmor;
+        n.seats = c.seats - 1;
+        n.tamed = c.tamed;
+        for (int seat = 0, to = 0; seat < c.seats; seat++) {
+            if (seat == removed) continue;
+            n.roles[to] = c.roles[seat];
+            n.alive |= ((c.alive >> seat) & 1) << to;
+            n.armor |= ((c.armor >> seat) & 1) << to;
+            next.agree |= ((fc.agree >> seat) & 1) << to;
+            next.ballots[to] = fc.ballots[seat];
+            int t = c.target[seat];
+            n.target[to] = static_cast<int8_t>(t < 0 || t == removed ? -1 : t > removed ? t - 1 : t);
+            to++;
+        }
+        out.push_back(next);
+    }
+    for (int seat = 0; seat < c.seats; seat++) {
+        FuzzCase next = fc;
+        if (c.roles[seat] != ROLE_CITIZEN) {
+            next.night.roles[seat] = ROLE_CITIZEN;
+            next.night.target[seat] = -1;
+            next.night.armor &= ~(1u << seat);
+            out.push_back(next);
+            next = fc;
+        }
+        if (!((c.alive >> seat) & 1)) {
+            next.night.alive |= 1u << seat;
+            out.push_back(next);
+            next = fc;
+        }
+        if (c.target[seat] >= 0) {
+            next.night.target[seat] = -1;
+            out.push_back(next);
+            next = fc;
+        }
+        if (fc.ballots[seat]) {
+            next.ballots[seat] = 0;
+            out.push_back(next);
+            next = fc;
+        }
+        if ((fc.agree >> seat) & 1) {
+            next.agree &= ~(1u << seat);
+            out.push_back(next);
+        }
+    }
+    if (c.tamed) { out.push_back(fc); out.back().night.tamed = false; }
+    if (c.armor) { out.push_back(fc); out.back().night.armor = 0; }
+    if (fc.doctorBeatsArmor) { out.push_back(fc); out.back().doctorBeatsArmor = false; }
+    return out;
+}
+
+FuzzCase shrinkFuzzCase(FuzzCase fc, const string& kind, int& steps)
+{ // 같은 종류로 실패하는 후보가 없을 때까지 줄임
+    steps = 0;
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (const FuzzCase& next : shrinkCandidates(fc)) {
+            string failure = runFuzzCase(next);
+            if (!failure.empty() && fuzzFailureKind(failure) == kind) {
+                fc = next;
+                steps++;
+                progress = true;
+                break;
+            }
+        }
+    }
+    return fc;
+}
+
+void printFuzzCase(const FuzzCase& fc)
+{
+    const NightCase& c = fc.night;
+    auto seatName = [](int seat) { return "P" + to_string(seat + 1); };
+    for (int seat = 0; seat < c.seats; seat++) {
+        cout << "  " << seatName(seat) << " " << roleTypeName(c.roles[seat]) << ((c.alive >> seat) & 1 ? "" : " (사망)");
+        if ((c.armor >> seat) & 1) cout << " (방탄복)";
+        if (c.target[seat] >= 0) cout << ", 밤 대상 " << seatName(c.target[seat]);
+        cout << ", 투표 " << int(fc.ballots[seat]) << ((fc.agree >> seat) & 1 ? ", 찬성" : ", 반대") << "\n";
+    }
+    cout << "  접선: " << (c.tamed ? "예" : "아니오") << ", 의사 치료가 방탄복보다 먼저: " << (fc.doctorBeatsArmor ? "예" : "아니오") << "\n";
+}
+
+int runFuzzCommand(int argc, char* argv[])
+{ // 사용법: napoly fuzz [사례 수] [--seed S] [--threads N] [--case N]
+    uint64_t cases = 1000000;
+    uint64_t seed = RngService::entropySeed();
+    int threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    long long single = -1;
+    int argi = 2;
+    if (argc > 2 && argv[2][0] != '-') cases = strtoull(argv[argi++], nullptr, 10);
+    for (int i = argi; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (arg == "--case" && i + 1 < argc) single = atoll(argv[++i]);
+        else cases = 0;
+    }
+    if (cases == 0 || threads <= 0) {
+        cout << "사용법: napoly fuzz [사례 수] [--seed S] [--threads N] [--case N]\n";
+        return 1;
+    }
+    GameRules savedRules = gameRules;
+    muteGameOutput = true;
+
+    atomic<uint64_t> nextCase(single >= 0 ? static_cast<uint64_t>(single) : 0);
+    uint64_t endCase = single >= 0 ? static_cast<uint64_t>(single) + 1 : cases;
+    atomic<uint64_t> checked(0);
+    atomic<bool> failed(false);
+    mutex failureLock;
+    uint64_t failedCase = 0;
+    string failure;
+
+    auto worker = [&]() {
+        muteGameOutput = true;
+        const uint64_t CHUNK = 4096;
+        uint64_t done = 0;
+        while (!failed.load(memory_order_relaxed)) {
+            uint64_t first = nextCase.fetch_add(CHUNK);
+            if (first >= endCase) break;
+            uint64_t last = min(first + CHUNK, endCase);
+            for (uint64_t index = first; index < last; index++) {
+                string result = runFuzzCase(makeFuzzCase(seed, index));
+                done++;
+                if (result.empty()) continue;
+                lock_guard<mutex> guard(failureLock);
+                if (!failed.exchange(true) || index < failedCase) { // 여러 스레드가 실패하면 가장 앞선 번호
+                    failedCase = index;
+                    failure = result;
+                }
+                break;
+            }
+        }
+        checked.fetch_add(done);
+        releaseGameState();
+    };
+
+    auto begin = steady_clock::now();
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    double seconds = duration<double>(steady_clock::now() - begin).count();
+
+    cout << "=== 규칙 퍼저 (시드 " << seed << ", " << threads << " 스레드) ===\n";
+    cout << "검사한 사례: " << checked.load() << "개, " << seconds << "초 ("
+        << static_cast<uint64_t>(checked.load() / max(seconds, 1e-9)) << "개/초)\n";
+    if (!failed) {
+        cout << "불변식 위반과 순차 판정 불일치 없음\n";
+        gameRules = savedRules;
+        return 0;
+    }
+
+    FuzzCase original = makeFuzzCase(seed, failedCase);
+    int steps = 0;
+    FuzzCase minimal = shrinkFuzzCase(original, fuzzFailureKind(failure), steps);
+    cout << "실패: 사례 " << failedCase << " — " << failure << "\n";
+    cout << "재현: napoly fuzz --seed " << seed << " --case " << failedCase << "\n";
+    cout << "원래 사례 (" << original.night.seats << "인):\n";
+    printFuzzCase(original);
+    cout << "축소한 사례 (" << steps << "단계, " << minimal.night.seats << "인): " << runFuzzCase(minimal) << "\n";
+    printFuzzCase(minimal);
+    releaseGameState();
+    gameRules = savedRules;
+    return 1;
+}
+
+#endif // FUZZ_H
@@ -9,47 +9,66 @@
 #include <memory>
 #include <map>
 #include <random>
+#include "roles.h"
 
 using namespace std;
 
+thread_local bool muteGameOutput = false; // 시뮬레이션 스레드에서 규칙 처리 중 출력 생략
+
+struct GameRules
+{ // 규칙 선택지 (기본값이 원래 규칙, napoly tune이 후보 구성마다 바꿔 가며 진행)
+    bool doctorBeatsArmor = false;   // 의사가 치료한 군인은 방탄복을 쓰지 않고 살아남음 (기본: 방탄복이 먼저 소모되고 치료는 무효)
+    bool policeSeesWerewolf = false; // 경찰 조사에서 늑대인간도 마피아로 나옴
+};
+
+thread_local GameRules gameRules;
+
+class Player;
+void onAliveChanged(Player& player); // 생사 변경 알림 (function.h의 생존자 캐시 갱신)
+
 class Player {
 protected: // 상속받은 클래스에서 사용하기 위해 protected로 선언
     string name; // 이름
     bool isAlive; // 생존 여부
     bool canVote; // 투표 가능 여부
     bool canUseAbility; // 능력 사용 가능 여부
+    int roleId; // 직업 등록부 번호
 
 public:
-    Player() : isAlive(true), canVote(true), canUseAbility(true) {} // 기본 생성자
-    Player(string n) : name(n), isAlive(true), canVote(true), canUseAbility(true) {}
+    Player() : isAlive(true), canVote(true), canUseAbility(true), roleId(ROLE_CITIZEN) {} // 기본 생성자
+    Player(string n, int type) : name(n), isAlive(true), canVote(true), canUseAbility(true), roleId(type) {}
     virtual ~Player() {}
 
     void setName(string n) { name = n; } // 이름 설정
     string getName() const { return name; }
     bool checkAlive() const { return isAlive; } // 생존 여부
-    void setAlive(bool alive) { isAlive = alive; } // bool 함수로 생사 여부를 확인
+    void setAlive(bool alive) { // bool 함수로 생사 여부를 확인
+        if (isAlive == alive) return;
+        isAlive = alive;
+        onAliveChanged(*this);
+    }
     void setCanVote(bool can) { canVote = can; } // bool 함수로 투표 가능 여부를 확인
     bool getCanVote() const { return canVote; }
     void setCanUseAbility(bool can) { canUseAbility = can; } // bool 함수로 고유 능력 사용 여부를 확인
     bool getCanUseAbility() const { return canUseAbility; }
 
     virtual void action(Player& target) = 0; // 직업 고유 능력을 구현하기 위한 가상함수 설정
-    virtual string getRole() const = 0; // 정체를 드러내기 위한 가상 함수
+    int roleType() const { return roleId; }
+    const RoleInfo& roleInfo() const { return roleRegistry[roleId]; }
+    string getRole() const { return roleInfo().name; } // 정체를 드러내기 위한 함수 (이름은 등록부에서)
 };
 
 class Mafia : public Player { // 마피아
 public:
-    Mafia(string n) : Player(n) {}
+    Mafia(string n) : Player(n, ROLE_MAFIA) {}
 
     void action(Player& target) override {
         if (!canUseAbility) return;
         if (target.checkAlive()) {
             target.setAlive(false);
-            cout << target.getName() << " (이)가 총을 맞고 '처치'됐습니다.\n";
+            if (!muteGameOutput) cout << target.getName() << " (이)가 총을 맞고 '처치'됐습니다.\n";
         }
     }
-
-    string getRole() const override { return "마피아"; }
 };
 
 class Werewolf : public Player { // 늑대인간
@@ -57,7 +76,7 @@ private:
     bool tamed; // 길들여졌는지 여부
 
 public:
-    Werewolf(string n) : Player(n), tamed(false) {}
+    Werewolf(string n, int type = ROLE_WEREWOLF) : Player(n, type), tamed(false) {}
 
     void action(Player& target) override {
         if (!canUseAbility) return;
@@ -68,18 +87,20 @@ public:
 
     void setTamed(bool isTamed) { tamed = isTamed; }
     bool isTamed() const { return tamed; }
-    string getRole() const override { return "늑대인간"; }
 };
 
 class Police : public Player { // 경찰
 public:
-    Police(string n) : Player(n) {}
+    Police(string n) : Player(n, ROLE_POLICE) {}
 
-    void action(Player& target) override {
-        cout << target.getName() << " (은)는 " << (dynamic_cast<Mafia*>(&target) ? "마피아 입니다." : "마피아가 아닙니다.") << "\n";
+    static bool revealsAsMafia(const Player& target) { // 등록부의 조사 규칙
+        RoleReveal reveal = target.roleInfo().reveal;
+        return reveal == REVEAL_MAFIA || (reveal == REVEAL_BY_RULE && gameRules.policeSeesWerewolf);
     }
 
-    string getRole() const override { return "경찰"; }
+    void action(Player& target) override {
+        if (!muteGameOutput) cout << target.getName() << " (은)는 " << (revealsAsMafia(target) ? "마피아 입니다." : "마피아가 아닙니다.") << "\n";
+    }
 };
 
 class Doctor : public Player { // 의사
@@ -87,7 +108,7 @@ private:
     Player* protectedTarget; // 보호할 플레이어를 포인터로 선언
 
 public:
-    Doctor(string n) : Player(n), protectedTarget(nullptr) {}
+    Doctor(string n) : Player(n, ROLE_DOCTOR), protectedTarget(nullptr) {}
 
     void action(Player& target) override {
         if (!canUseAbility) return;
@@ -103,8 +124,6 @@ public:
             target.setAlive(true);
         }
     }
-
-    string getRole() const override { return "의사"; }
 };
 
 class Soldier : public Player { // 군인
@@ -112,7 +131,7 @@ private:
     bool armorActive;
 
 public:
-    Soldier(string n) : Player(n), armorActive(true) {}
+    Soldier(string n, int type = ROLE_SOLDIER) : Player(n, type), armorActive(true) {}
 
     void action(Player& target) override {
         // 군인은 능동적인 행동이 없음
@@ -127,16 +146,40 @@ public:
         }
         return false;
     }
-
-    string getRole() const override { return "군인"; }
 };
 
 class Citizen : public Player {
 public:
-    Citizen(string n) : Player(n) {}
+    Citizen(string n) : Player(n, ROLE_CITIZEN) {}
 
     void action(Player&) override {}
-    string getRole() const override { return "시민"; }
 };
 
+class Detective : public Player { // 사립 탐정 (결과는 모든 밤 행동이 정해진 뒤 processActions에서 알려 줌)
+public:
+    Detective(string n) : Player(n, ROLE_DETECTIVE) {}
+
+    void action(Player&) override {}
+};
+
+class RegisteredRole : public Player { // 전용 클래스 없이 등록부에만 추가한 직업 (능동 행동 없음)
+public:
+    RegisteredRole(string n, int type) : Player(n, type) {}
+
+    void action(Player&) override {}
+};
+
+template <typename T>
+shared_ptr<Player> makeRole(const string& name, int)
+{
+    return make_shared<T>(name);
+}
+
+shared_ptr<Player> makeRegisteredRole(const string& name, int roleType)
+{ // 방탄복과 접선 상태는 Soldier, Werewolf가 가지므로 해당 직업은 그 클래스로 생성
+    if (roleRegistry[roleType].armored) return make_shared<Soldier>(name, roleType);
+    if (roleRegistry[roleType].night == NIGHT_HUNT) return make_shared<Werewolf>(name, roleType);
+    return make_shared<RegisteredRole>(name, roleType);
+}
+
 #endif // JOBS_H
\ No newline at end of file
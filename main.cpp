@@ -1,9 +1,121 @@
 // main.cpp
 #include "jobs.h"
 #include "function.h"
+#include "simulation.h"
+#include "shard.h"
+#include "tuner.h"
+#include "nightcheck.h"
+#include "fuzz.h"
+#include "matchmaker.h"
+#include "table.h"
+#include "whatif.h"
 using namespace std;
 
-int main() {
+int main(int argc, char* argv[]) {
+
+    if (argc > 1 && string(argv[1]) == "simulate") { // 봇 시뮬레이션 모드
+        return runSimulateCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "merge") { // 샤드 결과 병합
+        return runMergeCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "tune") { // 직업 구성/규칙 균형 조정
+        return runTuneCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "audit") { // 감사 로그 조회
+        return runAuditCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "query") { // 기록 보관소 조회
+        return runQueryCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "dealaudit") { // 직업 배정 공정성 검사
+        return runDealAuditCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "deckbench") { // 인원별 고정 덱 처리량 비교
+        return runDeckBenchCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "nightcheck") { // 밤 충돌 표와 예전 순차 판정 비교
+        return runNightCheckCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "fuzz") { // 밤/투표 규칙 퍼저
+        return runFuzzCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "matchbench") { // 대기열 매칭 벤치마크
+        return runMatchBenchCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "ratings") { // 결과 기록으로 플레이어 평점 계산
+        return runRatingsCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "ratebench") { // 평점 재계산 벤치마크
+        return runRateBenchCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "rolebench") { // 직업 수에 따른 밤 판정 비용
+        return runRoleBenchCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "spectatebench") { // 관전자 이벤트 방송 벤치마크
+        return runSpectateBenchCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "join") { // 소켓 테이블에 자기 터미널로 접속
+        return runJoinCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "whatif") { // 밤 행동 조합과 처형별 결과 표
+        return runWhatIfCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "checkpointbench") { // 그룹 커밋 체크포인트 처리량
+        return runCheckpointBenchCommand(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "statestress") { // 공개 상태 seqlock 부하 검사
+        return runPublicStateStressCommand(argc, argv);
+    }
+
+    if (const char* seed = getenv("NAPOLY_SEED")) { // 직업 배정 재현용 실행 시드
+        rngService.reseed(strtoull(seed, nullptr, 0));
+    }
+
+    if (const char* lang = getenv("NAPOLY_LANG")) { // 게임 문구 언어 (catalog.h의 catalogs)
+        if (!selectCatalog(lang)) cerr << "알 수 없는 언어입니다: " << lang << " (기본 문구 사용)\n";
+    }
+
+    if (const char* arena = getenv("NAPOLY_ARENA")) { // 0이면 게임별 아레나 대신 malloc (비교용)
+        gameArenaEnabled = atoi(arena) != 0;
+    }
+
+    if (const char* statsPath = getenv("NAPOLY_STATS_FILE")) { // 운영 지표 파일 (SIGUSR1 덤프는 항상 가능)
+        metricsReporter.start(statsPath);
+    }
+    else {
+        metricsReporter.start("");
+    }
+
+    if (const char* tracePath = getenv("NAPOLY_TRACE_FILE")) { // 대화형 세션 트레이스
+        traceSession.start(tracePath);
+    }
+
+    if (const char* auditPath = getenv("NAPOLY_AUDIT_FILE")) { // 분쟁 대응용 감사 로그
+        auditLog.start(auditPath);
+    }
+
+    if (const char* resultsPath = getenv("NAPOLY_RESULTS_FILE")) { // 평점 계산용 게임 결과 기록
+        ratingResults.start(resultsPath);
+    }
+
+    if (const char* checkpointPath = getenv("NAPOLY_CHECKPOINT_FILE")) { // 단계별 체크포인트 (중단된 방을 이어서 진행)
+        if (!openCheckpoints(checkpointPath)) cerr << "체크포인트 파일을 열 수 없습니다: " << checkpointPath << "\n";
+    }
+
+    interactiveRoom.attach(); // 대화형 게임은 단계마다 공개 상태와 이벤트를 게시
+
+    if (argc > 1 && string(argv[1]) == "table") { // 소켓 테이블: 좌석마다 동시에 입력 (지표, 기록은 대화형과 같게)
+        int status = runTableCommand(argc, argv);
+        metricsReporter.stop();
+        traceSession.stop();
+        auditLog.stop();
+        ratingResults.stop();
+        checkpointLog.stop();
+        return status;
+    }
+
+    resumeInterruptedGames();
 
     int select; // 번호 선택
 
@@ -33,6 +145,11 @@ int main() {
             break;
         case 4:
             cout << "게임을 종료합니다.\n";
+            metricsReporter.stop();
+            traceSession.stop();
+            auditLog.stop();
+            ratingResults.stop();
+            checkpointLog.stop();
             return 0;
         default:
             cout << "잘못된 입력입니다. 1-4 사이의 숫자를 입력해주세요.\n\n";
@@ -0,0 +1,353 @@
+// matchmaker.h
+#ifndef MATCHMAKER_H
+#define MATCHMAKER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "function.h"
+#include "sketch.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// 대기열 매칭: 대기 중인 플레이어를 평점이 가까운 6~8인 테이블로 묶음
+// 평점 순 집합과 대기 순 집합을 함께 유지하므로 넣기/빼기는 O(log n), 테이블 하나는 기준 플레이어의 평점 이웃을
+// 가까운 순으로 최대 scanLimit명만 살펴 만듦 (대기열 크기와 무관한 상한)
+// 허용 평점 폭은 기다린 시간만큼 넓어지고, 지연 목표를 넘긴 플레이어는 평점 폭과 동석 회피를 풀고 최소 인원으로라도 시작
+
+struct MatchConfig
+{
+    int minSeats = 6;
+    int maxSeats = 8;
+    double latencyTarget = 60;  // 초: 넘기면 평점 폭과 최근 동석자 회피를 풂
+    double partialAfter = 15;   // 초: 이만큼 기다리면 8인이 안 돼도 6~7인으로 시작
+    double baseWindow = 50;     // 기준 플레이어와의 평점 차 허용 폭
+    double windowGrowth = 10;   // 대기 1초마다 늘어나는 허용 폭
+    int scanLimit = 64;         // 테이블 하나를 만들 때 살펴보는 이웃 수
+    int retryLimit = 256;       // poll 한 번에 다시 시도하는 오래 기다린 플레이어 수
+};
+
+struct MatchTable
+{
+    vector<uint64_t> ids;
+    vector<string> names;
+    vector<double> waits;  // 좌석별 대기 시간 (초)
+    double spread = 0;     // 최고 평점 - 최저 평점
+    bool relaxed = false;  // 지연 목표를 넘겨 조건을 풀고 만든 테이블
+    int repeats = 0;       // 최근 동석자와 다시 만난 쌍 (relaxed일 때만)
+    int skipped = 0;       // 최근 동석자라서 건너뛴 후보
+};
+
+class Matchmaker
+{
+public:
+    static const int RECENT_TABLEMATES = 14; // 플레이어마다 기억하는 최근 동석자 (8인 테이블 두 번)
+
+private:
+    struct Entry
+    {
+        double rating;
+        double since;
+        string name;
+    };
+
+    struct History
+    {
+        uint64_t recent[RECENT_TABLEMATES] = {};
+        int next = 0;
+
+        bool contains(uint64_t id) const
+        {
+            for (uint64_t other : recent) {
+                if (other == id) return true;
+            }
+            return false;
+        }
+
+        void add(uint64_t id)
+        {
+            recent[next] = id;
+            next = (next + 1) % RECENT_TABLEMATES;
+        }
+    };
+
+    MatchConfig config;
+    set<pair<double, uint64_t>> byRating; // (평점, 번호)
+    set<pair<double, uint64_t>> byWait;   // (대기 시작 시각, 번호)
+    unordered_map<uint64_t, Entry> waiting;
+    unordered_map<uint64_t, History> history; // 대기열을 떠난 뒤에도 유지 (번호는 1부터)
+
+    bool metBefore(uint64_t a, uint64_t b) const
+    {
+        auto it = history.find(a);
+        if (it != history.end() && it->second.contains(b)) return true;
+        it = history.find(b);
+        return it != history.end() && it->second.contains(a);
+    }
+
+    void erase(uint64_t id)
+    {
+        auto it = waiting.find(id);
+        byRating.erase({ it->second.rating, id });
+        byWait.erase({ it->second.since, id });
+        waiting.erase(it);
+    }
+
+public:
+    explicit Matchmaker(const MatchConfig& config = MatchConfig()) : config(config) {}
+
+    size_t size() const { return waiting.size(); }
+    bool isWaiting(uint64_t id) const { return waiting.count(id) != 0; }
+
+    bool enqueue(uint64_t id, const string& name, double rating, double now)
+    { // 이미 대기 중이면 false
+        if (id == 0 || !waiting.emplace(id, Entry{ rating, now, name }).second) return false;
+        byRating.insert({ rating, id });
+        byWait.insert({ now, id });
+        return true;
+    }
+
+    bool leave(uint64_t id)
+    {
+        if (!waiting.count(id)) return false;
+        erase(id);
+        return true;
+    }
+
+    bool tryForm(uint64_t anchor, double now, MatchTable& table)
+    { // anchor를 기준으로 평점이 가까운 순서로 좌석을 채움, 인원이 모자라면 대기열을 그대로 둠
+        auto found = waiting.find(anchor);
+        if (found == waiting.end()) return false;
+        const Entry& a = found->second;
+        double wait = now - a.since;
+        bool relaxed = wait >= config.latencyTarget;
+        double window = relaxed ? numeric_limits<double>::infinity() : config.baseWindow + config.windowGrowth * wait;
+        int needed = wait >= config.partialAfter || relaxed ? config.minSeats : config.maxSeats;
+
+        vector<uint64_t> picked{ anchor };
+        int repeats = 0, skipped = 0;
+        auto up = byRating.upper_bound({ a.rating, anchor });
+        auto down = byRating.lower_bound({ a.rating, anchor }); // anchor 자신 (아래쪽은 그 앞부터)
+        for (int scanned = 0; static_cast<int>(picked.size()) < config.maxSeats && scanned < config.scanLimit; scanned++) {
+            bool hasUp = up != byRating.end() && up->first - a.rating <= window;
+            bool hasDown = down != byRating.begin() && a.rating - prev(down)->first <= window;
+            if (!hasUp && !hasDown) break;
+            uint64_t candidate;
+            if (hasUp && (!hasDown || up->first - a.rating <= a.rating - prev(down)->first)) candidate = (up++)->second;
+            else candidate = (--down)->second;
+
+            int met = 0;
+            for (uint64_t member : picked) met += metBefore(member, candidate);
+            if (met && !relaxed) {
+                skipped++;
+                continue;
+            }
+            repeats += met;
+            picked.push_back(candidate);
+        }
+        if (static_cast<int>(picked.size()) < needed) return false;
+
+        table = MatchTable();
+        double low = a.rating, high = a.rating;
+        for (uint64_t id : picked) {
+            const Entry& entry = waiting[id];
+            low = min(low, entry.rating);
+            high = max(high, entry.rating);
+            table.ids.push_back(id);
+            table.names.push_back(entry.name);
+            table.waits.push_back(now - entry.since);
+        }
+        table.spread = high - low;
+        table.relaxed = relaxed;
+        table.repeats = repeats;
+        table.skipped = skipped;
+        for (uint64_t id : picked) {
+            erase(id);
+            History& h = history[id];
+            for (uint64_t other : picked) {
+                if (other != id) h.add(other);
+            }
+        }
+        return true;
+    }
+
+    int poll(double now, vector<MatchTable>& out)
+    { // 주기적으로 호출: 부분 테이블이 허용될 만큼 기다린 플레이어를 오래 기다린 순으로 다시 시도
+        vector<uint64_t> anchors;
+        for (auto it = byWait.begin(); it != byWait.end() && static_cast<int>(anchors.size()) < config.retryLimit; ++it) {
+            if (now - it->first < config.partialAfter) break;
+            anchors.push_back(it->second);
+        }
+        int formed = 0;
+        MatchTable table;
+        for (uint64_t anchor : anchors) {
+            if (tryForm(anchor, now, table)) {
+                out.push_back(move(table));
+                formed++;
+            }
+        }
+        return formed;
+    }
+
+    bool oldest(uint64_t& id) const
+    {
+        if (byWait.empty()) return false;
+        id = byWait.begin()->second;
+        return true;
+    }
+};
+
+void startMatchedTable(const MatchTable& table)
+{ // 매칭된 테이블로 게임 시작 (좌석 순서는 매칭 순서, 직업은 assignRoles가 섞어 배정)
+    playlist = table.names;
+    beginGame();
+}
+
+int runMatchBenchCommand(int argc, char* argv[])
+{ // 사용법: napoly matchbench [--players N] [--rate R] [--minutes M] [--game-minutes G] [--target S] [--seed S]
+  // 1) 대기열 크기별 넣기/테이블 구성 비용, 2) 가상 시계로 도착을 흉내 낸 대기 시간 분위
+    int population = 100000;
+    double rate = 100;        // 초당 대기열 도착
+    double minutes = 60;      // 가상 진행 시간
+    double gameMinutes = 12;  // 한 게임 평균 길이 (끝나면 다시 대기열로 돌아올 수 있음)
+    uint64_t seed = 42;
+    MatchConfig config;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--players" && i + 1 < argc) population = atoi(argv[++i]);
+        else if (arg == "--rate" && i + 1 < argc) rate = atof(argv[++i]);
+        else if (arg == "--minutes" && i + 1 < argc) minutes = atof(argv[++i]);
+        else if (arg == "--game-minutes" && i + 1 < argc) gameMinutes = atof(argv[++i]);
+        else if (arg == "--target" && i + 1 < argc) config.latencyTarget = atof(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else population = 0;
+    }
+    if (population < config.maxSeats || rate <= 0 || minutes <= 0 || gameMinutes <= 0 || config.latencyTarget <= 0) {
+        cout << "사용법: napoly matchbench [--players N] [--rate R] [--minutes M] [--game-minutes G] [--target S] [--seed S]\n";
+        return 1;
+    }
+    config.partialAfter = min(config.partialAfter, config.latencyTarget);
+    muteGameOutput = true;
+    rngService.reseed(seed);
+    GameRng gen(seed, 1, RNG_STREAM_DECISION);
+    vector<double> ratings(population + 1);
+    vector<string> names(population + 1);
+    for (int id = 1; id <= population; id++) {
+        ratings[id] = normalSample(gen, 1500, 300);
+        names[id] = "player" + to_string(id);
+    }
+
+    // 1) 대기열 크기별 비용: 한꺼번에 넣은 뒤 오래 기다린 상태(부분 테이블 허용)로 모두 비움
+    cout << "=== 대기열 매칭 벤치마크 ===\n";
+    cout << "대기 인원  넣기(ns/명)  테이블 구성(ns/명)  테이블 수  남은 인원\n";
+    for (int size : { 1000, 10000, population }) {
+        if (size > population) continue;
+        Matchmaker queue(config);
+        auto begin = steady_clock::now();
+        for (int id = 1; id <= size; id++) queue.enqueue(id, names[id], ratings[id], 0);
+        double insertSeconds = duration<double>(steady_clock::now() - begin).count();
+
+        size_t tables = 0, seated = 0;
+        MatchTable table;
+        uint64_t anchor;
+        double now = config.partialAfter;
+        begin = steady_clock::now();
+        while (queue.oldest(anchor)) {
+            if (queue.tryForm(anchor, now, table)) {
+                tables++;
+                seated += table.ids.size();
+            }
+            else if (now < config.latencyTarget) now = config.latencyTarget; // 남은 인원은 조건을 풀고 한 번 더
+            else break;
+        }
+        double formSeconds = duration<double>(steady_clock::now() - begin).count();
+        cout << setw(9) << size << fixed << setprecision(0) << setw(13) << insertSeconds * 1e9 / size
+            << setw(20) << formSeconds * 1e9 / max<size_t>(seated, 1) << setw(11) << tables << setw(11) << queue.size() << "\n";
+        cout.unsetf(ios::fixed);
+    }
+
+    // 2) 도착 흐름: 쉬는 플레이어 중 무작위로 초당 rate명이 대기열에 들어오고, 게임이 끝나면 다시 쉬는 상태로
+    Matchmaker queue(config);
+    vector<int> idle(population);
+    for (int i = 0; i < population; i++) idle[i] = i + 1;
+    typedef pair<double, vector<uint64_t>> Finish; // (게임 종료 시각, 좌석)
+    priority_queue<Finish, vector<Finish>, greater<Finish>> playing;
+    TDigest waits(200);
+    size_t bySize[9] = {}, joined = 0, overTarget = 0, relaxedTables = 0, repeats = 0, skipped = 0, peak = 0;
+    double spreadSum = 0, matchSeconds = 0;
+    const double TICK = 0.5;
+    double nextArrival = -log(uniformUnit(gen)) / rate;
+    vector<MatchTable> formed;
+
+    auto seat = [&](MatchTable& table, double now) {
+        GameArenaScope arena;
+        startMatchedTable(table); // 직업 배정까지 (진행은 가상 게임 길이로 대신함)
+        bySize[table.ids.size()]++;
+        spreadSum += table.spread;
+        relaxedTables += table.relaxed;
+        repeats += table.repeats;
+        skipped += table.skipped;
+        for (double wait : table.waits) {
+            waits.add(wait);
+            overTarget += wait > config.latencyTarget;
+        }
+        double length = gameMinutes * 60 * (0.5 + uniformUnit(gen));
+        playing.push({ now + length, move(table.ids) });
+    };
+
+    for (double now = 0; now < minutes * 60; now += TICK) {
+        while (!playing.empty() && playing.top().first <= now) {
+            for (uint64_t id : playing.top().second) idle.push_back(static_cast<int>(id));
+            playing.pop();
+        }
+        for (; nextArrival < now + TICK; nextArrival += -log(uniformUnit(gen)) / rate) {
+            if (idle.empty()) continue; // 모두 게임 중이거나 대기 중이면 도착 없음
+            size_t pick = boundedRandom(gen, static_cast<uint32_t>(idle.size()));
+            int id = idle[pick];
+            idle[pick] = idle.back();
+            idle.pop_back();
+            joined++;
+
+            MatchTable table;
+            auto begin = steady_clock::now();
+            queue.enqueue(id, names[id], ratings[id], nextArrival);
+            bool made = queue.tryForm(id, nextArrival, table);
+            matchSeconds += duration<double>(steady_clock::now() - begin).count();
+            peak = max(peak, queue.size());
+            if (made) seat(table, nextArrival);
+        }
+        auto begin = steady_clock::now();
+        formed.clear();
+        queue.poll(now + TICK, formed);
+        matchSeconds += duration<double>(steady_clock::now() - begin).count();
+        for (auto& table : formed) seat(table, now + TICK);
+    }
+    releaseGameState();
+
+    size_t tables = bySize[6] + bySize[7] + bySize[8];
+    size_t seated = 6 * bySize[6] + 7 * bySize[7] + 8 * bySize[8];
+    cout << fixed << setprecision(0);
+    cout << "\n=== 도착 흐름 (" << population << "명, 초당 " << rate << "명, " << minutes << "분, 지연 목표 "
+        << config.latencyTarget << "초) ===\n";
+    cout << "대기열 진입: " << joined << "명, 테이블: " << tables << "개 (8인 " << bySize[8] << ", 7인 " << bySize[7]
+        << ", 6인 " << bySize[6] << "), 아직 대기: " << queue.size() << "명, 최대 대기열: " << peak << "명\n";
+    cout << setprecision(1);
+    cout << "대기 시간(초): p50 " << waits.quantile(0.5) << ", p90 " << waits.quantile(0.9) << ", p99 " << waits.quantile(0.99)
+        << ", 최대 " << waits.maximum() << ", 목표 초과 " << 100.0 * overTarget / max<size_t>(seated, 1) << "%\n";
+    cout << "테이블 평점 폭 평균: " << spreadSum / max<size_t>(tables, 1) << ", 조건을 푼 테이블: " << relaxedTables
+        << "개, 최근 동석자라서 건너뛴 후보: " << skipped << "명, 다시 만난 쌍: " << repeats << "\n";
+    cout << "매칭 CPU 시간: " << setprecision(0) << matchSeconds * 1e9 / max<size_t>(joined, 1) << "ns/명\n";
+    cout.unsetf(ios::fixed);
+    return 0;
+}
+
+#endif // MATCHMAKER_H
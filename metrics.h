@@ -0,0 +1,374 @@
+// metrics.h
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "arena.h"
+#include "phase.h"
+
+using namespace std;
+using namespace std::chrono;
+
+enum MetricCounter
+{ // 누적 카운터 종류
+    COUNTER_GAMES_STARTED,
+    COUNTER_GAMES_FINISHED,
+    COUNTER_CITIZEN_WINS,
+    COUNTER_MAFIA_WINS,
+    COUNTER_DRAWS,
+    COUNTER_WEREWOLF_TAMINGS,
+    COUNTER_HEAP_ALLOCATIONS,  // 게임 중 malloc으로 간 할당
+    COUNTER_HEAP_BYTES,
+    COUNTER_ARENA_ALLOCATIONS, // 게임 중 아레나에서 받은 할당
+    COUNTER_ARENA_BYTES,
+    COUNTER_ARENA_RETIRED,     // 게임 후에도 할당이 남아 재사용하지 못한 아레나
+    COUNTER_COUNT
+};
+
+enum MetricLatency
+{ // 지연 시간 히스토그램 종류 (앞부분은 GamePhase와 같은 순서)
+    LATENCY_NIGHT_INPUT = PHASE_NIGHT_INPUT,
+    LATENCY_PROCESS_ACTIONS = PHASE_PROCESS_ACTIONS,
+    LATENCY_DAY_ANNOUNCE = PHASE_DAY_ANNOUNCE,
+    LATENCY_VOTING = PHASE_VOTING,
+    LATENCY_VICTORY_CHECK = PHASE_VICTORY_CHECK,
+    LATENCY_VOTE_RESOLUTION = PHASE_COUNT, // tallyVotes (입력 대기 제외)
+    LATENCY_COUNT
+};
+
+const char* counterName(MetricCounter counter)
+{
+    switch (counter)
+    {
+    case COUNTER_GAMES_STARTED: return "games_started";
+    case COUNTER_GAMES_FINISHED: return "games_finished";
+    case COUNTER_CITIZEN_WINS: return "citizen_wins";
+    case COUNTER_MAFIA_WINS: return "mafia_wins";
+    case COUNTER_DRAWS: return "draws";
+    case COUNTER_WEREWOLF_TAMINGS: return "werewolf_tamings";
+    case COUNTER_HEAP_ALLOCATIONS: return "heap_allocations";
+    case COUNTER_HEAP_BYTES: return "heap_bytes";
+    case COUNTER_ARENA_ALLOCATIONS: return "arena_allocations";
+    case COUNTER_ARENA_BYTES: return "arena_bytes";
+    case COUNTER_ARENA_RETIRED: return "arena_retired";
+    default: return "?";
+    }
+}
+
+const char* latencyName(MetricLatency latency)
+{
+    if (latency < LATENCY_VOTE_RESOLUTION) return phaseName(static_cast<GamePhase>(latency));
+    if (latency == LATENCY_VOTE_RESOLUTION) return "vote resolution";
+    return "?";
+}
+
+class LatencyHistogram
+{ // HDR 방식의 로그-선형 버킷 (상대 오차 약 3%), 나노초 단위
+public:
+    static const int SUB_BITS = 5;
+    static const int SUB_COUNT = 1 << SUB_BITS;        // 첫 구간의 선형 버킷 수
+    static const int HALF_COUNT = SUB_COUNT / 2;       // 이후 구간당 버킷 수
+    static const int BUCKET_COUNT = (64 - SUB_BITS + 2) * HALF_COUNT;
+
+    static int bucketIndex(uint64_t value)
+    {
+        if (value < static_cast<uint64_t>(SUB_COUNT)) return static_cast<int>(value);
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - (SUB_BITS - 1);
+        return (shift + 1) * HALF_COUNT + static_cast<int>((value >> shift) - HALF_COUNT);
+    }
+
+    static uint64_t bucketLow(int index)
+    {
+        if (index < SUB_COUNT) return static_cast<uint64_t>(index);
+        int shift = index / HALF_COUNT - 1;
+        return static_cast<uint64_t>(index % HALF_COUNT + HALF_COUNT) << shift;
+    }
+
+    static uint64_t bucketHigh(int index)
+    {
+        if (index < SUB_COUNT) return static_cast<uint64_t>(index);
+        int shift = index / HALF_COUNT - 1;
+        return bucketLow(index) + (static_cast<uint64_t>(1) << shift) - 1;
+    }
+
+    uint64_t buckets[BUCKET_COUNT] = {};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+
+    void record(uint64_t value)
+    {
+        buckets[bucketIndex(value)]++;
+        count++;
+        sum += value;
+        if (value > max) max = value;
+    }
+
+    void merge(const LatencyHistogram& other)
+    {
+        for (int i = 0; i < BUCKET_COUNT; i++) buckets[i] += other.buckets[i];
+        count += other.count;
+        sum += other.sum;
+        if (other.max > max) max = other.max;
+    }
+
+    uint64_t percentile(double q) const
+    { // q는 0~1, 해당 버킷의 중간값 반환
+        if (count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * (count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                uint64_t mid = bucketLow(i) + (bucketHigh(i) - bucketLow(i)) / 2;
+                return mid < max ? mid : max;
+            }
+        }
+        return max;
+    }
+
+    double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+};
+
+class MetricsShard
+{ // 스레드별 기록 영역, 소유 스레드만 쓰고 덤프 스레드는 relaxed로 읽음
+private:
+    struct AtomicHistogram
+    {
+        atomic<uint64_t> buckets[LatencyHistogram::BUCKET_COUNT];
+        atomic<uint64_t> count;
+        atomic<uint64_t> sum;
+        atomic<uint64_t> max;
+    };
+
+    atomic<uint64_t> counters[COUNTER_COUNT];
+    AtomicHistogram histograms[LATENCY_COUNT];
+
+    // 단일 작성자이므로 read-modify-write 대신 load + store (lock 접두어 없음)
+    static void bump(atomic<uint64_t>& cell, uint64_t delta)
+    {
+        cell.store(cell.load(memory_order_relaxed) + delta, memory_order_relaxed);
+    }
+
+public:
+    MetricsShard()
+    {
+        for (auto& counter : counters) counter.store(0, memory_order_relaxed);
+        for (auto& histogram : histograms) {
+            for (auto& bucket : histogram.buckets) bucket.store(0, memory_order_relaxed);
+            histogram.count.store(0, memory_order_relaxed);
+            histogram.sum.store(0, memory_order_relaxed);
+            histogram.max.store(0, memory_order_relaxed);
+        }
+    }
+
+    void increment(MetricCounter counter, uint64_t delta)
+    {
+        bump(counters[counter], delta);
+    }
+
+    void recordLatency(MetricLatency latency, uint64_t nanos)
+    {
+        AtomicHistogram& h = histograms[latency];
+        bump(h.buckets[LatencyHistogram::bucketIndex(nanos)], 1);
+        bump(h.count, 1);
+        bump(h.sum, nanos);
+        if (nanos > h.max.load(memory_order_relaxed)) h.max.store(nanos, memory_order_relaxed);
+    }
+
+    void collect(uint64_t* counterOut, LatencyHistogram* histogramOut) const
+    { // 현재 값을 더해 넣음
+        for (int i = 0; i < COUNTER_COUNT; i++) {
+            counterOut[i] += counters[i].load(memory_order_relaxed);
+        }
+        for (int i = 0; i < LATENCY_COUNT; i++) {
+            LatencyHistogram copy;
+            for (int b = 0; b < LatencyHistogram::BUCKET_COUNT; b++) {
+                copy.buckets[b] = histograms[i].buckets[b].load(memory_order_relaxed);
+            }
+            copy.count = histograms[i].count.load(memory_order_relaxed);
+            copy.sum = histograms[i].sum.load(memory_order_relaxed);
+            copy.max = histograms[i].max.load(memory_order_relaxed);
+            histogramOut[i].merge(copy);
+        }
+    }
+};
+
+struct MetricsSnapshot
+{ // 모든 스레드의 값을 합친 결과
+    uint64_t counters[COUNTER_COUNT] = {};
+    LatencyHistogram histograms[LATENCY_COUNT];
+
+    void writeText(ostream& out) const
+    {
+        out << "# napoly metrics\n";
+        for (int i = 0; i < COUNTER_COUNT; i++) {
+            out << counterName(static_cast<MetricCounter>(i)) << " " << counters[i] << "\n";
+        }
+        out << "# latency_ns: count mean p50 p90 p99 p999 max\n";
+        for (int i = 0; i < LATENCY_COUNT; i++) {
+            const LatencyHistogram& h = histograms[i];
+            out << "latency{" << latencyName(static_cast<MetricLatency>(i)) << "} "
+                << h.count << " "
+                << static_cast<uint64_t>(h.mean()) << " "
+                << h.percentile(0.5) << " "
+                << h.percentile(0.9) << " "
+                << h.percentile(0.99) << " "
+                << h.percentile(0.999) << " "
+                << h.max << "\n";
+        }
+    }
+};
+
+class MetricsRegistry
+{ // 스레드별 샤드 목록, 등록(스레드당 1회)과 덤프만 잠금 사용
+private:
+    mutex shardMutex;
+    vector<unique_ptr<MetricsShard>> shards; // 스레드 종료 후에도 값 보존
+    atomic<bool> latencyEnabled;
+
+    MetricsShard* registerShard()
+    {
+        ArenaBypass bypass; // 게임 중 첫 기록이어도 샤드는 힙에
+        lock_guard<mutex> lock(shardMutex);
+        shards.push_back(unique_ptr<MetricsShard>(new MetricsShard()));
+        return shards.back().get();
+    }
+
+public:
+    MetricsRegistry() : latencyEnabled(true) {}
+
+    MetricsShard& local()
+    {
+        thread_local MetricsShard* shard = nullptr;
+        if (!shard) shard = registerShard();
+        return *shard;
+    }
+
+    void setLatencyEnabled(bool enabled) { latencyEnabled.store(enabled, memory_order_relaxed); }
+    bool isLatencyEnabled() const { return latencyEnabled.load(memory_order_relaxed); }
+
+    MetricsSnapshot snapshot()
+    {
+        MetricsSnapshot result;
+        lock_guard<mutex> lock(shardMutex);
+        for (const auto& shard : shards) {
+            shard->collect(result.counters, result.histograms);
+        }
+        return result;
+    }
+};
+
+MetricsRegistry metricsRegistry;
+
+void metricsIncrement(MetricCounter counter, uint64_t delta = 1)
+{
+    metricsRegistry.local().increment(counter, delta);
+}
+
+class LatencyTimer
+{ // 생성~소멸 구간의 경과 시간을 히스토그램에 기록
+private:
+    MetricLatency latency;
+    bool active;
+    steady_clock::time_point begin;
+
+public:
+    explicit LatencyTimer(MetricLatency l) : latency(l), active(metricsRegistry.isLatencyEnabled())
+    {
+        if (active) begin = steady_clock::now();
+    }
+
+    ~LatencyTimer()
+    {
+        if (active) {
+            auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - begin).count();
+            metricsRegistry.local().recordLatency(latency, static_cast<uint64_t>(elapsed));
+        }
+    }
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+};
+
+// 외부 노출: SIGUSR1 수신 시 텍스트 덤프, 또는 주기적으로 통계 파일 갱신
+atomic<bool> metricsDumpRequested(false);
+
+void onMetricsSignal(int)
+{ // 시그널 핸들러에서는 플래그만 세움
+    metricsDumpRequested.store(true, memory_order_relaxed);
+}
+
+class MetricsReporter
+{
+private:
+    string statsPath;
+    int intervalMs;
+    atomic<bool> running;
+    thread worker;
+
+    void writeStatsFile()
+    { // 임시 파일에 쓴 뒤 rename 하여 읽는 쪽이 반쯤 쓴 파일을 보지 않도록 함
+        string tempPath = statsPath + ".tmp";
+        {
+            ofstream file(tempPath, ios::trunc);
+            if (!file.is_open()) return;
+            metricsRegistry.snapshot().writeText(file);
+        }
+        rename(tempPath.c_str(), statsPath.c_str());
+    }
+
+    void run()
+    {
+        auto lastWrite = steady_clock::now();
+        while (running.load()) {
+            this_thread::sleep_for(milliseconds(100));
+
+            if (metricsDumpRequested.exchange(false)) {
+                metricsRegistry.snapshot().writeText(cerr);
+            }
+            if (!statsPath.empty() && steady_clock::now() - lastWrite >= milliseconds(intervalMs)) {
+                writeStatsFile();
+                lastWrite = steady_clock::now();
+            }
+        }
+        if (!statsPath.empty()) writeStatsFile(); // 종료 시 마지막 값 기록
+    }
+
+public:
+    MetricsReporter() : intervalMs(1000), running(false) {}
+    ~MetricsReporter() { stop(); }
+
+    void start(const string& path, int interval = 1000)
+    {
+        if (running.load()) return;
+        statsPath = path;
+        intervalMs = interval;
+#ifdef SIGUSR1
+        signal(SIGUSR1, onMetricsSignal);
+#endif
+        running.store(true);
+        worker = thread(&MetricsReporter::run, this);
+    }
+
+    void stop()
+    {
+        if (!running.exchange(false)) return;
+        if (worker.joinable()) worker.join();
+    }
+};
+
+MetricsReporter metricsReporter;
+
+#endif // METRICS_H
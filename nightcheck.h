@@ -0,0 +1,258 @@
+// nightcheck.h
+#ifndef NIGHTCHECK_H
+#define NIGHTCHECK_H
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "function.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// 밤 충돌 표 검증: 8인 기본 구성에서 도달 가능한 모든 밤을 진행해, 충돌 표로 판정하는 processActions/resolveDay의 결과가
+// 표 도입 전의 순차 판정(우선순위 표 + 행동별 분기, 아래 referenceNight에 그대로 옮김)과 같은지 비교
+// 도달 가능한 밤: 좌석별 생사, 늑대인간 접선 여부, 군인 방탄복 여부 중 게임이 끝나지 않은 상태에서
+// 살아있는 능력자가 살아있는 좌석을 하나씩 고른 모든 경우 (마피아 행동은 마지막 마피아의 것만 남음)
+// 판정은 좌석 번호를 바꿔도 같으므로 직업 배치는 하나로 고정
+
+struct NightCase
+{
+    int seats = 0;
+    uint8_t roles[8] = {};
+    uint8_t alive = 0;     // 좌석 비트
+    bool tamed = false;    // 밤 시작 시 접선 여부
+    uint8_t armor = 0;     // 방탄복이 남은 군인 좌석
+    int8_t target[8] = {}; // 좌석별 대상 (-1: 행동 없음)
+};
+
+struct NightVerdict
+{
+    uint8_t dies = 0;     // 사망 예정 좌석
+    uint8_t defended = 0; // 방탄복으로 버틴 좌석
+    bool tamed = false;   // 밤이 끝난 뒤 접선 여부
+    int saved = -1;       // 치료로 살아났다고 발표되는 좌석
+    bool anyEvent = false;
+    bool anyAttack = false;
+
+    bool operator==(const NightVerdict& o) const
+    {
+        return dies == o.dies && defended == o.defended && tamed == o.tamed && saved == o.saved &&
+            anyEvent == o.anyEvent && anyAttack == o.anyAttack;
+    }
+};
+
+int lastMafiaSeat(const NightCase& c)
+{ // 행동이 남는 마피아 (좌석 순서로 입력하므로 마지막으로 고른 마피아)
+    int last = -1;
+    for (int seat = 0; seat < c.seats; seat++) {
+        if (c.roles[seat] == ROLE_MAFIA && ((c.alive >> seat) & 1) && c.target[seat] >= 0) last = seat;
+    }
+    return last;
+}
+
+NightVerdict referenceNight(const NightCase& c, bool doctorBeatsArmor)
+{ // 충돌 표 도입 전의 판정: 행동을 우선순위로 정렬해 하나씩 처리하고 좌석별 치료/처치/방어 표시를 갱신
+    static const int priorities[ROLE_TYPE_COUNT] = { 3, 1, 0, 2, 4, 5, 6 }; // 예전 actionPriorities (경찰은 표에 없어 0)
+    struct Action { int actor, target, priority; };
+    vector<Action> actions;
+    int mafiaSeat = lastMafiaSeat(c);
+    int wolfSeat = -1;
+    for (int seat = 0; seat < c.seats; seat++) {
+        if (c.roles[seat] == ROLE_WEREWOLF) wolfSeat = seat;
+        if (c.target[seat] < 0 || (c.roles[seat] == ROLE_MAFIA && seat != mafiaSeat)) continue;
+        actions.push_back({ seat, c.target[seat], priorities[c.roles[seat]] });
+    }
+    sort(actions.begin(), actions.end(), [](const Action& a, const Action& b) { return a.priority < b.priority; });
+    int mafiaTarget = mafiaSeat >= 0 ? c.target[mafiaSeat] : -1;
+
+    bool managerTamed = c.tamed; // NightPhaseManager::werewolfTamed
+    bool wolfTamed = c.tamed;    // Werewolf::isTamed
+    uint8_t armor = c.armor;
+    bool healed[8] = {}, killed[8] = {}, defended[8] = {};
+    bool targetMatch = false;
+    int matched = -1;
+    for (const Action& a : actions) {
+        int t = a.target;
+        switch (c.roles[a.actor]) {
+        case ROLE_MAFIA:
+            if (t == wolfSeat && !managerTamed) { // 늑대인간을 공격하면 즉시 접선
+                managerTamed = wolfTamed = true;
+            }
+            else if (t != wolfSeat) {
+                bool shouldKill = true;
+                if (c.roles[t] == ROLE_SOLDIER && ((armor >> t) & 1) && !(doctorBeatsArmor && healed[t])) {
+                    armor &= ~(1u << t);
+                    defended[t] = true;
+                    healed[t] = false;
+                    shouldKill = false;
+                }
+                if (shouldKill) {
+                    killed[t] = true;
+                    if (t == mafiaTarget) matched = t;
+                }
+            }
+            break;
+        case ROLE_WEREWOLF:
+            if (!wolfTamed && t == mafiaTarget) targetMatch = true;
+            else if (wolfTamed) {
+                killed[t] = true;
+                healed[t] = false;
+            }
+            break;
+        case ROLE_DOCTOR:
+            if (!defended[t]) healed[t] = true;
+            break;
+        }
+    }
+    if (targetMatch && !managerTamed && matched >= 0 && killed[matched] && !healed[matched] && !defended[matched]) {
+        managerTamed = wolfTamed = true;
+    }
+
+    NightVerdict v;
+    for (int seat = 0; seat < c.seats; seat++) {
+        if (killed[seat] && !healed[seat] && !defended[seat]) v.dies |= 1u << seat;
+        if (defended[seat]) v.defended |= 1u << seat;
+    }
+    v.tamed = managerTamed;
+
+    // resolveDay: 방어, 사망, 공격받은 치료 대상
+    v.anyEvent = v.anyAttack = v.defended || v.dies;
+    vector<int> attacked;
+    int healTarget = -1;
+    for (const Action& a : actions) {
+        if (c.roles[a.actor] == ROLE_MAFIA || (c.roles[a.actor] == ROLE_WEREWOLF && wolfTamed)) {
+            v.anyAttack = true;
+            attacked.push_back(a.target);
+        }
+        else if (c.roles[a.actor] == ROLE_DOCTOR) healTarget = a.target;
+    }
+    if (healTarget >= 0 && !((v.dies >> healTarget) & 1) &&
+        find(attacked.begin(), attacked.end(), healTarget) != attacked.end()) {
+        v.saved = healTarget;
+        v.anyEvent = true;
+    }
+    return v;
+}
+
+void enterNight(const NightCase& c)
+{ // c의 상태로 게임을 만들고 밤을 시작 (playlist는 좌석 수만큼 준비되어 있어야 함)
+    beginGame(c.roles, 1);
+    for (int seat = 0; seat < c.seats; seat++) {
+        if (!((c.alive >> seat) & 1)) players[seat]->setAlive(false);
+        if (players[seat]->roleInfo().armored && !((c.armor >> seat) & 1)) {
+            static_cast<Soldier&>(*players[seat]).defendShot();
+            onArmorUsed(players[seat]);
+        }
+    }
+    if (c.tamed) tameWerewolf();
+    beginNight();
+}
+
+void submitNightCase(const NightCase& c)
+{ // 봇 입력과 같은 좌석 순서로 행동 제출 후 판정
+    for (int seat = 0; seat < c.seats; seat++) {
+        if (c.target[seat] >= 0) submitNightAction(players[seat], players[c.target[seat]]);
+    }
+    nightManager.processActions();
+}
+
+NightVerdict playNight(const NightCase& c)
+{ // 실제 규칙 함수로 한 밤 진행 (상태를 만든 뒤 봇 입력과 같은 순서로 행동 제출)
+    enterNight(c);
+    submitNightCase(c);
+
+    NightVerdict v;
+    v.dies = static_cast<uint8_t>(nightManager.pendingDeathSeats());
+    v.defended = static_cast<uint8_t>(nightManager.defendedSeatMask());
+    v.tamed = werewolfTamed;
+    DayReport report = resolveDay();
+    for (int seat = 0; seat < c.seats; seat++) {
+        if (!report.savedPlayerName.empty() && players[seat]->getName() == report.savedPlayerName) v.saved = seat;
+    }
+    v.anyEvent = report.anyEvent;
+    v.anyAttack = report.anyAttack;
+    nightManager.clear();
+    return v;
+}
+
+int runNightCheckCommand(int argc, char* argv[])
+{ // 사용법: napoly nightcheck — 두 규칙 선택지(doctorBeatsArmor) 모두 검사, 불일치가 있으면 1 반환
+    (void)argc;
+    (void)argv;
+    muteGameOutput = true;
+    NightCase base;
+    base.seats = 8;
+    const uint8_t deal[8] = { ROLE_POLICE, ROLE_DOCTOR, ROLE_MAFIA, ROLE_MAFIA, ROLE_WEREWOLF, ROLE_SOLDIER, ROLE_CITIZEN, ROLE_CITIZEN };
+    copy(deal, deal + 8, base.roles);
+    playlist.clear();
+    for (int seat = 0; seat < base.seats; seat++) playlist.push_back("P" + to_string(seat + 1));
+
+    GameRules savedRules = gameRules;
+    uint64_t states = 0, nights = 0, mismatches = 0;
+    auto begin = steady_clock::now();
+    for (int rule = 0; rule < 2; rule++) {
+        gameRules.doctorBeatsArmor = rule != 0;
+        for (int state = 0; state < (1 << (base.seats + 2)); state++) {
+            NightCase c = base;
+            c.alive = static_cast<uint8_t>(state);
+            c.tamed = (state >> base.seats) & 1;
+            c.armor = ((state >> (base.seats + 1)) & 1) << 5; // 군인은 5번 좌석
+
+            // 게임이 끝난 상태는 밤이 오지 않음
+            beginGame(c.roles, 1);
+            for (int seat = 0; seat < c.seats; seat++) {
+                if (!((c.alive >> seat) & 1)) players[seat]->setAlive(false);
+            }
+            if (c.tamed) tameWerewolf();
+            if (evaluateVictory() != Winner::None) continue;
+            states++;
+
+            // 행동자: 살아있는 경찰, 의사, 늑대인간, 마지막 마피아 (앞선 마피아는 같은 대상을 골랐다가 교체됨)
+            vector<int> actors, aliveSeats;
+            int mafiaSeat = lastMafiaSeat(c);
+            for (int seat = 0; seat < c.seats; seat++) {
+                if (!((c.alive >> seat) & 1)) continue;
+                aliveSeats.push_back(seat);
+                if (roleRegistry[c.roles[seat]].night != NIGHT_NONE && (c.roles[seat] != ROLE_MAFIA || seat == mafiaSeat)) {
+                    actors.push_back(seat);
+                }
+            }
+            vector<size_t> choice(actors.size(), 0);
+            while (true) {
+                fill(c.target, c.target + 8, -1);
+                for (size_t i = 0; i < actors.size(); i++) c.target[actors[i]] = static_cast<int8_t>(aliveSeats[choice[i]]);
+                for (int seat = 0; seat < c.seats; seat++) { // 앞선 마피아
+                    if (c.roles[seat] == ROLE_MAFIA && seat != mafiaSeat && ((c.alive >> seat) & 1)) c.target[seat] = c.target[mafiaSeat];
+                }
+
+                NightVerdict expected = referenceNight(c, gameRules.doctorBeatsArmor);
+                NightVerdict actual = playNight(c);
+                nights++;
+                if (!(expected == actual) && mismatches++ < 10) {
+                    cout << "불일치: 규칙 " << rule << ", 생존 0x" << hex << int(c.alive) << dec
+                        << ", 접선 " << c.tamed << ", 방탄복 " << (c.armor != 0) << ", 대상";
+                    for (int seat = 0; seat < c.seats; seat++) cout << " " << int(c.target[seat]);
+                    cout << " / 사망 " << int(expected.dies) << ":" << int(actual.dies)
+                        << " 방어 " << int(expected.defended) << ":" << int(actual.defended)
+                        << " 접선 " << expected.tamed << ":" << actual.tamed
+                        << " 치료 " << expected.saved << ":" << actual.saved << "\n";
+                }
+
+                size_t i = 0; // 다음 대상 조합
+                while (i < choice.size() && ++choice[i] == aliveSeats.size()) choice[i++] = 0;
+                if (i == choice.size()) break;
+            }
+        }
+    }
+    double seconds = duration<double>(steady_clock::now() - begin).count();
+    gameRules = savedRules;
+    releaseGameState();
+
+    cout << "=== 밤 충돌 표 검증 (8인 기본 구성, 규칙 선택지 2가지) ===\n";
+    cout << "진행 중인 상태: " << states << "개, 밤: " << nights << "개, 불일치: " << mismatches << "개 (" << seconds << "초)\n";
+    return mismatches ? 1 : 0;
+}
+
+#endif // NIGHTCHECK_H
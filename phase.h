@@ -0,0 +1,28 @@
+// phase.h
+#ifndef PHASE_H
+#define PHASE_H
+
+enum GamePhase
+{ // 계측(하드웨어 카운터, 지연 시간) 대상 게임 단계
+    PHASE_NIGHT_INPUT,      // 밤 능력 입력 (startNight 단계 1)
+    PHASE_PROCESS_ACTIONS,  // processActions
+    PHASE_DAY_ANNOUNCE,     // 낮 결과 발표 (startDay)
+    PHASE_VOTING,           // 투표 (startVoting)
+    PHASE_VICTORY_CHECK,    // 승리 조건 체크
+    PHASE_COUNT
+};
+
+const char* phaseName(GamePhase phase)
+{
+    switch (phase)
+    {
+    case PHASE_NIGHT_INPUT: return "night input";
+    case PHASE_PROCESS_ACTIONS: return "processActions";
+    case PHASE_DAY_ANNOUNCE: return "day announce";
+    case PHASE_VOTING: return "voting";
+    case PHASE_VICTORY_CHECK: return "victory check";
+    default: return "?";
+    }
+}
+
+#endif // PHASE_H
@@ -0,0 +1,171 @@
+// profiler.h
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "phase.h"
+
+using namespace std;
+
+struct PerfCounters
+{ // 한 번에 읽어오는 카운터 묶음
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cacheMisses = 0;
+    uint64_t branchMisses = 0;
+};
+
+class PhaseProfiler
+{ // perf_event_open 기반 단계별 카운터 (리눅스 전용, 기본 비활성)
+private:
+    static const int COUNTER_COUNT = 4;
+    bool enabled;
+    int fds[COUNTER_COUNT];
+    PerfCounters totals[PHASE_COUNT];
+    uint64_t calls[PHASE_COUNT];
+
+#ifdef __linux__
+    static int openCounter(uint64_t config, int groupFd)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = (groupFd == -1) ? 1 : 0; // 그룹 리더만 꺼진 상태로 시작
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+#endif
+
+public:
+    PhaseProfiler() : enabled(false)
+    {
+        for (int i = 0; i < COUNTER_COUNT; i++) fds[i] = -1;
+        reset();
+    }
+
+    ~PhaseProfiler() { disable(); }
+
+    bool enable()
+    { // 카운터 그룹 열기, 실패 시 false
+        if (enabled) return true;
+#ifdef __linux__
+        const uint64_t configs[COUNTER_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES };
+
+        for (int i = 0; i < COUNTER_COUNT; i++) {
+            fds[i] = openCounter(configs[i], i == 0 ? -1 : fds[0]);
+            if (fds[i] < 0) {
+                disable();
+                return false;
+            }
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        enabled = true;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void disable()
+    {
+        for (int i = 0; i < COUNTER_COUNT; i++) {
+#ifdef __linux__
+            if (fds[i] >= 0) close(fds[i]);
+#endif
+            fds[i] = -1;
+        }
+        enabled = false;
+    }
+
+    bool isEnabled() const { return enabled; }
+
+    void reset()
+    {
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            totals[i] = PerfCounters();
+            calls[i] = 0;
+        }
+    }
+
+    bool read(PerfCounters& out) const
+    { // 그룹 전체를 한 번의 read로 읽음
+#ifdef __linux__
+        uint64_t buffer[1 + COUNTER_COUNT];
+        if (::read(fds[0], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) ||
+            buffer[0] != COUNTER_COUNT)
+            return false;
+        out.cycles = buffer[1];
+        out.instructions = buffer[2];
+        out.cacheMisses = buffer[3];
+        out.branchMisses = buffer[4];
+        return true;
+#else
+        (void)out;
+        return false;
+#endif
+    }
+
+    void record(GamePhase phase, const PerfCounters& begin, const PerfCounters& end)
+    {
+        totals[phase].cycles += end.cycles - begin.cycles;
+        totals[phase].instructions += end.instructions - begin.instructions;
+        totals[phase].cacheMisses += end.cacheMisses - begin.cacheMisses;
+        totals[phase].branchMisses += end.branchMisses - begin.branchMisses;
+        calls[phase]++;
+    }
+
+    void printTable(ostream& out) const
+    { // 단계별 IPC 및 천 명령어당 미스 수(MPKI) 출력
+        out << "\n=== 단계별 하드웨어 카운터 ===\n";
+        out << left << setw(16) << "phase"
+            << right << setw(10) << "calls"
+            << setw(16) << "cycles"
+            << setw(16) << "instructions"
+            << setw(8) << "IPC"
+            << setw(14) << "cache MPKI"
+            << setw(14) << "branch MPKI" << "\n";
+
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            const PerfCounters& t = totals[i];
+            double ipc = t.cycles ? static_cast<double>(t.instructions) / t.cycles : 0.0;
+            double kiloInstructions = t.instructions / 1000.0;
+            double cacheMpki = kiloInstructions > 0 ? t.cacheMisses / kiloInstructions : 0.0;
+            double branchMpki = kiloInstructions > 0 ? t.branchMisses / kiloInstructions : 0.0;
+
+            out << left << setw(16) << phaseName(static_cast<GamePhase>(i))
+                << right << setw(10) << calls[i]
+                << setw(16) << t.cycles
+                << setw(16) << t.instructions
+                << fixed << setprecision(2)
+                << setw(8) << ipc
+                << setw(14) << cacheMpki
+                << setw(14) << branchMpki << "\n";
+        }
+        out.unsetf(ios::fixed);
+    }
+};
+
+PhaseProfiler phaseProfiler;
+
+#endif // PROFILER_H
@@ -0,0 +1,241 @@
+// publicstate.h
+#ifndef PUBLICSTATE_H
+#define PUBLICSTATE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+// 관전자/진행자/대시보드용 공개 상태
+// 게임 스레드가 단계가 바뀔 때마다 고정 크기 스냅샷을 seqlock으로 게시하고,
+// 읽는 쪽은 잠금 없이 복사한 뒤 순번이 그대로면 채택 (쓰는 쪽은 읽는 쪽을 기다리지 않음)
+
+enum PublicPhase : uint8_t
+{
+    PUBLIC_NONE,
+    PUBLIC_NIGHT,
+    PUBLIC_DAY,      // 밤 결과 발표 후
+    PUBLIC_VOTE,     // 투표 시작
+    PUBLIC_FINISHED,
+    PUBLIC_PHASE_COUNT
+};
+
+enum PublicDeathCause : uint8_t
+{
+    DEATH_NONE,
+    DEATH_NIGHT,     // 밤 사이 사망 (공개 발표된 사망)
+    DEATH_EXECUTION  // 투표로 처형
+};
+
+const int PUBLIC_MAX_SEATS = 8;  // playerModify의 최대 인원
+const int PUBLIC_NAME_BYTES = 24; // UTF-8, 넘치면 잘림
+
+struct PublicState
+{ // 공개 정보만 담은 스냅샷 (직업, 밤 대상은 포함하지 않음)
+    uint64_t gameId;
+    uint64_t version;     // 게시 순번 (게임 스레드 기준 단조 증가)
+    uint64_t eventCount;  // 이 스냅샷에 반영된 방송 이벤트 수 (broadcast.h, 이후 이벤트부터 이어 읽음)
+    int32_t day;
+    uint8_t phase;        // PublicPhase
+    uint8_t seatCount;
+    uint8_t aliveMask;    // 좌석 비트
+    uint8_t winner;       // 0 없음/무승부, 1 시민, 2 마피아 (PUBLIC_FINISHED에서만 의미)
+    uint8_t deathDay[PUBLIC_MAX_SEATS];   // 0이면 생존
+    uint8_t deathCause[PUBLIC_MAX_SEATS]; // PublicDeathCause
+    char names[PUBLIC_MAX_SEATS][PUBLIC_NAME_BYTES];
+};
+
+static_assert(is_trivially_copyable<PublicState>::value, "seqlock은 바이트 복사로 전달");
+static_assert(sizeof(PublicState) % sizeof(uint64_t) == 0, "워드 단위 복사");
+
+const char* publicPhaseName(uint8_t phase)
+{
+    static const char* names[PUBLIC_PHASE_COUNT] = { "none", "night", "day", "vote", "finished" };
+    return phase < PUBLIC_PHASE_COUNT ? names[phase] : "?";
+}
+
+class PublicStateChannel
+{ // 단일 작성자 seqlock, 읽는 쪽 수에 제한 없음
+private:
+    static const size_t WORDS = sizeof(PublicState) / sizeof(uint64_t);
+
+    alignas(64) atomic<uint64_t> sequence; // 홀수면 쓰는 중
+    alignas(64) atomic<uint64_t> words[WORDS]; // 데이터 경쟁이 없도록 워드마다 relaxed 원자 접근
+
+public:
+    PublicStateChannel() : sequence(0)
+    {
+        for (auto& word : words) word.store(0, memory_order_relaxed);
+    }
+
+    PublicStateChannel(const PublicStateChannel&) = delete;
+    PublicStateChannel& operator=(const PublicStateChannel&) = delete;
+
+    void publish(const PublicState& state)
+    { // 게임 스레드 전용, 대기 없음
+        uint64_t buffer[WORDS];
+        memcpy(buffer, &state, sizeof(state));
+
+        uint64_t seq = sequence.load(memory_order_relaxed);
+        sequence.store(seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) words[i].store(buffer[i], memory_order_relaxed);
+        sequence.store(seq + 2, memory_order_release);
+    }
+
+    bool tryRead(PublicState& out) const
+    { // 한 번 시도: 쓰는 도중이었거나 그 사이 게시가 있었으면 false
+        uint64_t before = sequence.load(memory_order_acquire);
+        if (before & 1) return false;
+
+        uint64_t buffer[WORDS];
+        for (size_t i = 0; i < WORDS; i++) buffer[i] = words[i].load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (sequence.load(memory_order_relaxed) != before) return false;
+
+        memcpy(&out, buffer, sizeof(out));
+        return true;
+    }
+
+    int read(PublicState& out) const
+    { // 일관된 스냅샷을 얻을 때까지 재시도, 재시도 횟수 반환
+        int retries = 0;
+        while (!tryRead(out)) {
+            retries++;
+            if ((retries & 63) == 0) this_thread::yield(); // 작성자가 선점된 경우
+        }
+        return retries;
+    }
+
+    uint64_t published() const { return sequence.load(memory_order_acquire) / 2; }
+};
+
+thread_local PublicStateChannel* publicChannel = nullptr; // 현재 스레드의 게시 대상 (nullptr이면 게시 생략)
+
+// 찢어진 읽기 검사: 작성자는 모든 필드를 게시 번호 하나에서 만들고, 읽는 쪽은 다시 계산해 비교
+PublicState makeStressState(uint64_t n)
+{
+    PublicState state;
+    memset(&state, 0, sizeof(state));
+    state.gameId = n * 0x9E3779B97F4A7C15ull;
+    state.version = n;
+    state.day = static_cast<int32_t>(n);
+    state.phase = static_cast<uint8_t>(n % PUBLIC_PHASE_COUNT);
+    state.seatCount = static_cast<uint8_t>(6 + n % 3);
+    state.aliveMask = static_cast<uint8_t>(n >> 3);
+    state.winner = static_cast<uint8_t>(n % 3);
+    for (int seat = 0; seat < PUBLIC_MAX_SEATS; seat++) {
+        state.deathDay[seat] = static_cast<uint8_t>(n + seat);
+        state.deathCause[seat] = static_cast<uint8_t>((n + seat) % 3);
+        memset(state.names[seat], 'a' + static_cast<int>((n + seat) % 26), PUBLIC_NAME_BYTES - 1);
+    }
+    return state;
+}
+
+bool isConsistentStressState(const PublicState& state)
+{
+    if (state.version == 0) return true; // 아직 게시 전 (전부 0)
+    PublicState expected = makeStressState(state.version);
+    return memcmp(&expected, &state, sizeof(state)) == 0;
+}
+
+int runPublicStateStressCommand(int argc, char* argv[])
+{ // 사용법: napoly statestress [읽기 스레드 수] [--seconds S]
+    int readers = 64;
+    double seconds = 2.0;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) seconds = atof(argv[++i]);
+        else readers = atoi(arg.c_str());
+    }
+    if (readers < 0 || seconds <= 0) {
+        cout << "사용법: napoly statestress [읽기 스레드 수] [--seconds S]\n";
+        return 1;
+    }
+
+    PublicStateChannel channel;
+    atomic<bool> readersStarted(false), readersRunning(true);
+    atomic<uint64_t> totalReads(0), totalRetries(0), tornReads(0), regressions(0);
+
+    // 1) 읽는 쪽 없이 작성자만: 기준 게시 속도
+    auto runWriter = [&channel](double length, uint64_t first, uint64_t& published, uint64_t& worstNs) {
+        auto begin = steady_clock::now();
+        auto deadline = begin + duration_cast<steady_clock::duration>(duration<double>(length));
+        uint64_t n = first;
+        worstNs = 0;
+        while (true) {
+            PublicState state = makeStressState(n++);
+            if ((n & 63) == 0) { // 가끔만 시간을 재어 측정 자체의 비용을 줄임
+                auto t0 = steady_clock::now();
+                channel.publish(state);
+                uint64_t ns = static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now() - t0).count());
+                if (ns > worstNs) worstNs = ns;
+                if (steady_clock::now() >= deadline) break;
+            }
+            else {
+                channel.publish(state);
+            }
+        }
+        published = n - first;
+        return duration<double>(steady_clock::now() - begin).count();
+    };
+
+    uint64_t basePublished = 0, baseWorst = 0;
+    double baseSeconds = runWriter(seconds / 4, 1, basePublished, baseWorst);
+
+    // 2) 읽는 쪽 다수 + 작성자 하나
+    vector<thread> threads;
+    threads.reserve(readers);
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&]() {
+            uint64_t reads = 0, retries = 0, torn = 0, regress = 0, last = 0;
+            PublicState state;
+            while (!readersStarted.load(memory_order_acquire)) this_thread::yield(); // 모두 만든 뒤 동시에 시작
+            while (readersRunning.load(memory_order_relaxed)) {
+                retries += channel.read(state);
+                reads++;
+                if (!isConsistentStressState(state)) torn++;
+                if (state.version < last) regress++;
+                last = state.version;
+            }
+            totalReads += reads;
+            totalRetries += retries;
+            tornReads += torn;
+            regressions += regress;
+        });
+    }
+
+    readersStarted.store(true, memory_order_release);
+    uint64_t published = 0, worst = 0;
+    double writerSeconds = runWriter(seconds, basePublished + 1, published, worst);
+    readersRunning.store(false);
+    for (auto& t : threads) t.join();
+
+    double baseRate = basePublished / baseSeconds;
+    double rate = published / writerSeconds;
+    cout << "=== 공개 상태 seqlock 부하 검사 (읽기 " << readers << "개, 작성 1개, "
+        << seconds << "초) ===\n";
+    cout << fixed << setprecision(1);
+    // 코어 수보다 읽는 쪽이 많으면 게시 횟수는 CPU 몫에 따라 줄지만, 게시 한 번의 시간은 그대로여야 함
+    cout << "게시: " << published << "회 (" << rate / 1e3 << "k/s, 읽는 쪽 없을 때 "
+        << baseRate / 1e3 << "k/s), 최장 게시 " << worst << "ns (읽는 쪽 없을 때 " << baseWorst << "ns)\n";
+    cout << "읽기: " << totalReads.load() << "회 (" << totalReads.load() / writerSeconds / 1e6
+        << "M/s), 재시도 " << totalRetries.load() << "회\n";
+    cout << "찢어진 읽기: " << tornReads.load() << ", 순번 역행: " << regressions.load()
+        << (tornReads.load() == 0 && regressions.load() == 0 ? "  -> 정상\n" : "  -> 실패\n");
+    cout.unsetf(ios::fixed);
+    return tornReads.load() == 0 && regressions.load() == 0 ? 0 : 1;
+}
+
+#endif // PUBLICSTATE_H
@@ -0,0 +1,67 @@
+// randombot.c
+// 예제 봇 플러그인: 같은 팀으로 아는 좌석은 피하고, 나머지 결정은 (시드, 게임 번호, 날짜, 좌석, 종류)의 해시로 고름
+// 결정이 묶음 구성과 무관하므로 같은 시드면 스레드 수와 상관없이 같은 결과
+// 빌드: cc -O2 -shared -fPIC randombot.c -o randombot.so
+// 실행: napoly simulate 1000000 --bot ./randombot.so
+
+#include <stdlib.h>
+#include "botabi.h"
+
+typedef struct RandomBot
+{
+    uint64_t seed;
+} RandomBot;
+
+static uint64_t mix(uint64_t h)
+{ // splitmix64 마무리 단계
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+static int pickSeat(uint8_t mask, uint64_t h)
+{ // mask의 좌석 중 하나 (비었으면 NAPOLY_NO_SEAT)
+    int count = __builtin_popcount(mask);
+    if (count == 0) return NAPOLY_NO_SEAT;
+    int k = (int)(((h >> 32) * (uint64_t)count) >> 32);
+    for (; k > 0; k--) mask &= (uint8_t)(mask - 1);
+    return __builtin_ctz(mask);
+}
+
+static void* create(uint64_t seed)
+{
+    RandomBot* bot = (RandomBot*)malloc(sizeof(RandomBot));
+    if (bot) bot->seed = seed;
+    return bot;
+}
+
+static void destroy(void* bot)
+{
+    free(bot);
+}
+
+static void decide(void* self, const NapolyDecisionBatch* b)
+{
+    uint64_t seed = ((const RandomBot*)self)->seed;
+    for (uint32_t i = 0; i < b->count; i++) {
+        uint64_t h = mix(seed ^ mix(b->gameId[i] * 4 + b->kind) ^ ((uint64_t)b->day[i] << 8 | b->seat[i]));
+        uint8_t others = b->alive[i] & (uint8_t)~b->allies[i];
+        switch (b->kind) {
+        case NAPOLY_DECIDE_NIGHT: // 마피아와 늑대인간은 같은 팀이 아닌 생존자, 의사는 아무 생존자
+            b->choice[i] = (uint8_t)pickSeat(b->role[i] == NAPOLY_ROLE_DOCTOR ? b->alive[i] : others, h);
+            break;
+        case NAPOLY_DECIDE_VOTE: // 8분의 1은 기권
+            b->choice[i] = (h & 7) == 0 ? NAPOLY_NO_SEAT : (uint8_t)pickSeat(others, h);
+            break;
+        default: // 같은 팀이면 반대, 아니면 찬성
+            b->choice[i] = (b->allies[i] >> b->candidate[i]) & 1 ? 0 : 1;
+            break;
+        }
+    }
+}
+
+NAPOLY_BOT_EXPORT const NapolyBotApi* napoly_bot_api(void)
+{
+    static const NapolyBotApi api = { NAPOLY_BOT_ABI_VERSION, sizeof(NapolyBotApi), "randombot", create, destroy, decide };
+    return &api;
+}
@@ -0,0 +1,679 @@
+// rating.h
+#ifndef RATING_H
+#define RATING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "archive.h"
+#include "rng.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// 플레이어 평점: startGame으로 진행한 게임의 결과 기록(NAPOLY_RESULTS_FILE)을 시간 순서대로 읽어 팀 단위 TrueSkill 방식으로 갱신
+// 평점은 시민 팀으로 뛴 게임과 마피아 팀(마피아 + 끝난 시점에 접선한 늑대인간)으로 뛴 게임을 따로 유지
+// 전체 재계산은 기록을 시간 순 구간으로 나누어 구간마다 (플레이어, 팀) 평점 의존 관계로 단계를 매기고(같은 단계의 게임끼리는
+// 겹치는 평점이 없음), 단계별로 여러 스레드가 나눠 갱신하므로 결과는 파일 순서대로 하나씩 갱신한 것과 비트 단위로 같음
+
+const int RATING_MAX_SEATS = 8;
+const uint32_t RATING_NO_PLAYER = 0xFFFFFFFFu;
+const uint32_t RATING_STATE_MAGIC = 0x5452504E; // "NPRT"
+const uint32_t RATING_STATE_FORMAT = 1;
+
+enum RatingSide
+{
+    SIDE_CITIZEN,
+    SIDE_MAFIA,
+    RATING_SIDES
+};
+
+struct RatingResult
+{ // 48바이트 고정 크기, 파일 순서가 끝난 순서
+    uint32_t players[RATING_MAX_SEATS]; // 이름 목록(결과파일.names)의 줄 번호, 빈 좌석은 RATING_NO_PLAYER
+    uint64_t gameId;
+    uint32_t finishedAt; // epoch 이후 초
+    uint8_t seats;
+    uint8_t mafiaTeam;   // 끝난 시점에 마피아 팀인 좌석 비트
+    uint8_t winner;      // 0 무승부, 1 시민, 2 마피아 (기록 보관소와 같음)
+    uint8_t days;
+};
+static_assert(sizeof(RatingResult) == 48, "RatingResult must stay 48 bytes");
+
+string ratingNamesPath(const string& resultsPath) { return resultsPath + ".names"; }
+
+vector<string> loadRatingNames(const string& resultsPath)
+{ // 한 줄에 이름 하나, 줄 번호가 플레이어 번호
+    vector<string> names;
+    ifstream in(ratingNamesPath(resultsPath));
+    string line;
+    while (getline(in, line)) names.push_back(line);
+    return names;
+}
+
+class RatingResultLog
+{ // 끝난 게임의 결과를 한 게임씩 덧붙여 기록 (대화형 게임은 드물게 끝나므로 게임마다 flush)
+private:
+    atomic<bool> enabled;
+    mutex writeMutex;
+    FILE* file;
+    FILE* namesFile;
+    unordered_map<string, uint32_t> ids;
+    uint64_t gamesWritten;
+
+    uint32_t playerId(const string& name)
+    { // 처음 보는 이름은 이름 목록 끝에 추가
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(ids.size());
+        ids.emplace(name, id);
+        fprintf(namesFile, "%s\n", name.c_str());
+        return id;
+    }
+
+public:
+    RatingResultLog() : enabled(false), file(nullptr), namesFile(nullptr), gamesWritten(0) {}
+    ~RatingResultLog() { stop(); }
+
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+
+    bool start(const string& path)
+    { // 기존 기록과 이름 목록 뒤에 이어 씀
+        if (file) return true;
+        vector<string> names = loadRatingNames(path);
+        ids.clear();
+        for (size_t i = 0; i < names.size(); i++) ids.emplace(names[i], static_cast<uint32_t>(i));
+        file = fopen(path.c_str(), "ab");
+        namesFile = fopen(ratingNamesPath(path).c_str(), "ab");
+        if (!file || !namesFile) {
+            stop();
+            return false;
+        }
+        enabled.store(true, memory_order_release);
+        return true;
+    }
+
+    void stop()
+    {
+        enabled.store(false, memory_order_release);
+        if (file) fclose(file);
+        if (namesFile) fclose(namesFile);
+        file = namesFile = nullptr;
+    }
+
+    void record(const vector<string>& names, uint8_t mafiaTeam, uint8_t winner, int days, uint64_t gameId)
+    {
+        RatingResult r;
+        memset(&r, 0xFF, sizeof(r.players));
+        r.gameId = gameId;
+        r.finishedAt = static_cast<uint32_t>(duration_cast<seconds>(system_clock::now().time_since_epoch()).count());
+        r.seats = static_cast<uint8_t>(min<size_t>(names.size(), RATING_MAX_SEATS));
+        r.mafiaTeam = mafiaTeam;
+        r.winner = winner;
+        r.days = static_cast<uint8_t>(min(days, 255));
+
+        lock_guard<mutex> lock(writeMutex);
+        if (!file) return;
+        for (int seat = 0; seat < r.seats; seat++) r.players[seat] = playerId(names[seat]);
+        fflush(namesFile); // 결과보다 이름이 먼저 디스크에 있도록
+        fwrite(&r, sizeof(r), 1, file);
+        fflush(file);
+        gamesWritten++;
+    }
+};
+
+RatingResultLog ratingResults;
+
+struct RatingParams
+{ // TrueSkill 기본값 (평점 25, 불확실성 25/3)
+    double mu0 = 25.0;
+    double sigma0 = 25.0 / 3;
+    double beta = 25.0 / 6;  // 한 게임 성과의 흔들림
+    double tau = 25.0 / 300; // 게임마다 더하는 실력 변화
+};
+
+struct RatingRunStats
+{
+    uint64_t games = 0;      // 반영한 결과 기록 수
+    uint64_t rated = 0;      // 평점이 바뀐 게임
+    uint64_t draws = 0;
+    uint64_t invalid = 0;    // 한쪽 팀이 비었거나 좌석 수가 맞지 않는 기록
+    size_t partitions = 0;
+    size_t levels = 0;       // 모든 구간의 단계 수 합 (스레드 동기화 횟수)
+    double scheduleSeconds = 0;
+    double applySeconds = 0;
+};
+
+struct RatingSchedule
+{ // 시간 순 구간 하나를 단계 순서로 정렬한 것
+    size_t first = 0;
+    size_t count = 0;
+    vector<uint32_t> order;      // 구간 안 게임 번호 (단계 순, 같은 단계 안에서는 파일 순)
+    vector<uint32_t> levelStart; // 단계 k는 order[levelStart[k], levelStart[k + 1])
+    uint64_t rated = 0, draws = 0, invalid = 0;
+};
+
+class RatingBarrier
+{ // 단계 사이 동기화 (C++17에 std::barrier가 없어 세대 번호로 구현)
+private:
+    mutex lock;
+    condition_variable released;
+    int parties;
+    int waiting = 0;
+    uint64_t generation = 0;
+
+public:
+    explicit RatingBarrier(int count) : parties(count) {}
+
+    void wait()
+    {
+        unique_lock<mutex> guard(lock);
+        uint64_t arrived = generation;
+        if (++waiting == parties) {
+            waiting = 0;
+            generation++;
+            released.notify_all();
+            return;
+        }
+        released.wait(guard, [&] { return generation != arrived; });
+    }
+};
+
+class RatingEngine
+{
+public:
+    static constexpr size_t PARTITION_GAMES = 1 << 20; // 구간 크기: 단계 계산용 표가 구간마다 새로 쓰이지 않도록 충분히 큼
+
+    RatingParams params;
+    vector<double> mu, sigma;  // (플레이어 * 2 + 팀) 순서
+    vector<uint32_t> games;
+    uint64_t processed = 0;    // 지금까지 반영한 결과 기록 수 (기록 파일 안 위치)
+
+    static size_t key(uint32_t player, int side) { return static_cast<size_t>(player) * RATING_SIDES + side; }
+    size_t playerCount() const { return mu.size() / RATING_SIDES; }
+
+    void reset()
+    {
+        mu.clear();
+        sigma.clear();
+        games.clear();
+        processed = 0;
+    }
+
+    void reserve(size_t players)
+    { // 새 플레이어는 기본 평점으로 시작
+        if (players <= playerCount()) return;
+        mu.resize(players * RATING_SIDES, params.mu0);
+        sigma.resize(players * RATING_SIDES, params.sigma0);
+        games.resize(players * RATING_SIDES, 0);
+    }
+
+    static int classify(const RatingResult& r)
+    { // 1 평점 갱신, 0 무승부, -1 잘못된 기록
+        if (r.seats < 2 || r.seats > RATING_MAX_SEATS || r.winner > 2) return -1;
+        uint8_t all = static_cast<uint8_t>((1u << r.seats) - 1);
+        uint8_t mafia = r.mafiaTeam & all;
+        if (mafia == 0 || mafia == all) return -1;
+        for (int seat = 0; seat < r.seats; seat++) {
+            if (r.players[seat] == RATING_NO_PLAYER) return -1;
+        }
+        return r.winner == 0 ? 0 : 1;
+    }
+
+    static double winGain(double t)
+    { // v(t) = φ(t) / Φ(t): 예상 밖의 승리일수록 큼
+        double cdf = 0.5 * erfc(-t / sqrt(2.0));
+        if (cdf < 1e-300) return -t;
+        return exp(-0.5 * t * t) / sqrt(2 * M_PI) / cdf;
+    }
+
+    void apply(const RatingResult& r)
+    { // 한 게임 반영 (classify가 1인 기록만), 평점이 겹치지 않는 게임끼리는 동시에 호출해도 됨
+      // 팀 성과는 구성원 성과의 평균 (마피아 팀은 2~3명, 시민 팀은 4~6명이라 합으로 두면 인원 차가 평점에 섞임)
+        const int n = r.seats;
+        size_t keys[RATING_MAX_SEATS];
+        double variance[RATING_MAX_SEATS], weight[RATING_MAX_SEATS];
+        int side[RATING_MAX_SEATS];
+        int mafiaCount = 0;
+        for (int seat = 0; seat < n; seat++) mafiaCount += (r.mafiaTeam >> seat) & 1;
+        double teamMu[RATING_SIDES] = {}, c2 = 0;
+        for (int seat = 0; seat < n; seat++) {
+            side[seat] = (r.mafiaTeam >> seat) & 1 ? SIDE_MAFIA : SIDE_CITIZEN;
+            keys[seat] = key(r.players[seat], side[seat]);
+            weight[seat] = 1.0 / (side[seat] == SIDE_MAFIA ? mafiaCount : n - mafiaCount);
+            variance[seat] = sigma[keys[seat]] * sigma[keys[seat]] + params.tau * params.tau;
+            teamMu[side[seat]] += weight[seat] * mu[keys[seat]];
+            c2 += weight[seat] * weight[seat] * (variance[seat] + params.beta * params.beta);
+        }
+        double c = sqrt(c2);
+        int winnerSide = r.winner == 2 ? SIDE_MAFIA : SIDE_CITIZEN;
+        double t = (teamMu[winnerSide] - teamMu[1 - winnerSide]) / c;
+        double v = winGain(t);
+        double w = v * (v + t);
+        for (int seat = 0; seat < n; seat++) {
+            size_t k = keys[seat];
+            double gain = weight[seat] * variance[seat] / c * v;
+            mu[k] += side[seat] == winnerSide ? gain : -gain;
+            double shrink = 1 - weight[seat] * weight[seat] * variance[seat] / c2 * w;
+            sigma[k] = sqrt(variance[seat] * max(shrink, 1e-4));
+            games[k]++;
+        }
+    }
+
+    uint32_t maxPlayer(const RatingResult* records, size_t count) const
+    {
+        uint32_t top = 0;
+        for (size_t i = 0; i < count; i++) {
+            for (int seat = 0; seat < min<int>(records[i].seats, RATING_MAX_SEATS); seat++) {
+                if (records[i].players[seat] != RATING_NO_PLAYER) top = max(top, records[i].players[seat] + 1);
+            }
+        }
+        return top;
+    }
+
+    void update(const RatingResult* records, size_t count, RatingRunStats* stats = nullptr)
+    { // 새로 끝난 게임을 파일 순서대로 하나씩 반영 (증분 갱신, 비교 기준)
+        reserve(maxPlayer(records, count));
+        for (size_t i = 0; i < count; i++) {
+            int kind = classify(records[i]);
+            if (kind > 0) apply(records[i]);
+            if (stats) {
+                stats->rated += kind > 0;
+                stats->draws += kind == 0;
+                stats->invalid += kind < 0;
+            }
+        }
+        processed += count;
+        if (stats) stats->games += count;
+    }
+
+    void buildSchedule(const RatingResult* records, RatingSchedule& s, vector<uint64_t>& last, uint32_t stamp) const
+    { // 게임의 단계 = 그 게임이 쓰는 평점들을 마지막으로 쓴 단계 + 1
+      // last[키]는 (구간 도장 << 32 | 단계 + 1), 도장이 다르면 이 구간에서 아직 쓰이지 않은 평점 (구간마다 표를 비우지 않음)
+        vector<uint32_t> level(s.count);
+        uint32_t levels = 0;
+        s.rated = s.draws = s.invalid = 0;
+        for (size_t i = 0; i < s.count; i++) {
+            const RatingResult& r = records[s.first + i];
+            int kind = classify(r);
+            s.rated += kind > 0;
+            s.draws += kind == 0;
+            s.invalid += kind < 0;
+            if (kind <= 0) { level[i] = UINT32_MAX; continue; }
+            uint32_t at = 0;
+            for (int seat = 0; seat < r.seats; seat++) {
+                uint64_t entry = last[key(r.players[seat], (r.mafiaTeam >> seat) & 1)];
+                if ((entry >> 32) == stamp) at = max(at, static_cast<uint32_t>(entry));
+            }
+            for (int seat = 0; seat < r.seats; seat++) {
+                last[key(r.players[seat], (r.mafiaTeam >> seat) & 1)] = static_cast<uint64_t>(stamp) << 32 | (at + 1);
+            }
+            level[i] = at;
+            levels = max(levels, at + 1);
+        }
+        s.levelStart.assign(levels + 1, 0);
+        for (size_t i = 0; i < s.count; i++) {
+            if (level[i] != UINT32_MAX) s.levelStart[level[i] + 1]++;
+        }
+        for (uint32_t l = 0; l < levels; l++) s.levelStart[l + 1] += s.levelStart[l];
+        s.order.resize(s.levelStart[levels]);
+        vector<uint32_t> fill(s.levelStart.begin(), s.levelStart.end() - 1);
+        for (size_t i = 0; i < s.count; i++) {
+            if (level[i] != UINT32_MAX) s.order[fill[level[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    void run(const RatingResult* records, size_t count, int threads, RatingRunStats& stats)
+    { // 현재 평점에 이어서 records를 반영: 구간별 단계 계산(병렬) 후 구간 순서대로 단계마다 병렬 갱신
+        if (threads <= 1) { // 단계를 나눌 이유가 없으면 파일 순서대로 (결과는 같음)
+            auto begin = steady_clock::now();
+            update(records, count, &stats);
+            stats.applySeconds += duration<double>(steady_clock::now() - begin).count();
+            return;
+        }
+        reserve(maxPlayer(records, count));
+        auto begin = steady_clock::now();
+        vector<RatingSchedule> schedules((count + PARTITION_GAMES - 1) / PARTITION_GAMES);
+        for (size_t p = 0; p < schedules.size(); p++) {
+            schedules[p].first = p * PARTITION_GAMES;
+            schedules[p].count = min(PARTITION_GAMES, count - schedules[p].first);
+        }
+        atomic<size_t> nextPartition(0);
+        auto scheduler = [&]() {
+            vector<uint64_t> last(mu.size(), 0);
+            for (size_t p; (p = nextPartition.fetch_add(1)) < schedules.size();) {
+                buildSchedule(records, schedules[p], last, static_cast<uint32_t>(p + 1));
+            }
+        };
+        vector<thread> pool;
+        for (int t = 1; t < threads && t < static_cast<int>(schedules.size()); t++) pool.emplace_back(scheduler);
+        scheduler();
+        for (auto& t : pool) t.join();
+        pool.clear();
+        auto scheduled = steady_clock::now();
+
+        RatingBarrier barrier(threads);
+        auto worker = [&](int index) {
+            for (const RatingSchedule& s : schedules) {
+                for (size_t l = 0; l + 1 < s.levelStart.size(); l++) {
+                    size_t from = s.levelStart[l], to = s.levelStart[l + 1];
+                    if (to - from < 64) { // 작은 단계는 한 스레드가 처리
+                        if (index == 0) for (size_t i = from; i < to; i++) apply(records[s.first + s.order[i]]);
+                    }
+                    else {
+                        size_t span = to - from;
+                        size_t lo = from + span * index / threads, hi = from + span * (index + 1) / threads;
+                        for (size_t i = lo; i < hi; i++) apply(records[s.first + s.order[i]]);
+                    }
+                    barrier.wait();
+                }
+            }
+        };
+        for (int t = 1; t < threads; t++) pool.emplace_back(worker, t);
+        worker(0);
+        for (auto& t : pool) t.join();
+        auto applied = steady_clock::now();
+
+        for (const RatingSchedule& s : schedules) {
+            stats.rated += s.rated;
+            stats.draws += s.draws;
+            stats.invalid += s.invalid;
+            stats.levels += s.levelStart.size() - 1;
+        }
+        stats.games += count;
+        stats.partitions += schedules.size();
+        stats.scheduleSeconds += duration<double>(scheduled - begin).count();
+        stats.applySeconds += duration<double>(applied - scheduled).count();
+        processed += count;
+    }
+
+    void recompute(const RatingResult* records, size_t count, int threads, RatingRunStats& stats)
+    { // 전체 기록으로 처음부터 다시 계산
+        reset();
+        run(records, count, threads, stats);
+    }
+
+    uint64_t digest() const
+    { // 평점 상태의 FNV-1a (순차/병렬 결과 비교용)
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&](const void* data, size_t bytes) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < bytes; i++) h = (h ^ p[i]) * 1099511628211ull;
+        };
+        mix(mu.data(), mu.size() * sizeof(double));
+        mix(sigma.data(), sigma.size() * sizeof(double));
+        mix(games.data(), games.size() * sizeof(uint32_t));
+        return h;
+    }
+
+    bool save(const string& path) const
+    { // 헤더(매직, 형식, 반영한 기록 수, 플레이어 수) + 평점/불확실성/게임 수 배열
+        FILE* out = fopen(path.c_str(), "wb");
+        if (!out) return false;
+        uint64_t header[3] = { static_cast<uint64_t>(RATING_STATE_FORMAT) << 32 | RATING_STATE_MAGIC, processed, playerCount() };
+        bool ok = fwrite(header, sizeof(header), 1, out) == 1 &&
+            fwrite(mu.data(), sizeof(double), mu.size(), out) == mu.size() &&
+            fwrite(sigma.data(), sizeof(double), sigma.size(), out) == sigma.size() &&
+            fwrite(games.data(), sizeof(uint32_t), games.size(), out) == games.size();
+        return fclose(out) == 0 && ok;
+    }
+
+    bool load(const string& path)
+    {
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return false;
+        uint64_t header[3];
+        bool ok = fread(header, sizeof(header), 1, in) == 1 &&
+            header[0] == (static_cast<uint64_t>(RATING_STATE_FORMAT) << 32 | RATING_STATE_MAGIC);
+        if (ok) {
+            reset();
+            reserve(header[2]);
+            ok = fread(mu.data(), sizeof(double), mu.size(), in) == mu.size() &&
+                fread(sigma.data(), sizeof(double), sigma.size(), in) == sigma.size() &&
+                fread(games.data(), sizeof(uint32_t), games.size(), in) == games.size();
+            processed = header[1];
+        }
+        fclose(in);
+        if (!ok) reset();
+        return ok;
+    }
+};
+
+void printRatingStats(const RatingRunStats& stats, int threads)
+{
+    double seconds = stats.scheduleSeconds + stats.applySeconds;
+    cout << fixed << setprecision(2);
+    cout << "반영: " << stats.games << "게임 (평점 갱신 " << stats.rated << ", 무승부 " << stats.draws << ", 잘못된 기록 "
+        << stats.invalid << "), " << seconds << "초, " << setprecision(1) << stats.games / max(seconds, 1e-9) / 1e6
+        << "M games/s (" << threads << " 스레드)\n";
+    if (stats.partitions) cout << "  구간 " << stats.partitions << "개, 단계 " << stats.levels << "개 (단계당 평균 "
+        << setprecision(0) << (stats.levels ? static_cast<double>(stats.rated) / stats.levels : 0.0) << "게임), 단계 계산 "
+        << setprecision(2) << stats.scheduleSeconds << "초 + 갱신 " << stats.applySeconds << "초\n";
+    cout.unsetf(ios::fixed);
+}
+
+int runRatingsCommand(int argc, char* argv[])
+{ // 사용법: napoly ratings 결과파일 [--state 상태파일] [--threads N] [--top K] [--min-games N]
+  // 상태 파일이 있으면 거기서 이어서 새로 끝난 게임만 반영하고, 없거나 기록이 줄었으면 전체 재계산
+    const char* usage = "사용법: napoly ratings 결과파일 [--state 상태파일] [--threads N] [--top K] [--min-games N]\n";
+    if (argc < 3) {
+        cout << usage;
+        return 1;
+    }
+    string path = argv[2], statePath;
+    int threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    int top = 10;
+    uint32_t minGames = 10;
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--state" && i + 1 < argc) statePath = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (arg == "--top" && i + 1 < argc) top = atoi(argv[++i]);
+        else if (arg == "--min-games" && i + 1 < argc) minGames = static_cast<uint32_t>(atoi(argv[++i]));
+        else threads = 0;
+    }
+    if (threads <= 0) {
+        cout << usage;
+        return 1;
+    }
+
+    ArchiveMapping mapping;
+    if (!mapping.open(path)) {
+        cout << "결과 기록을 열 수 없습니다: " << path << "\n";
+        return 1;
+    }
+    size_t count = mapping.size() / sizeof(RatingResult);
+    vector<RatingResult> copied;
+    const RatingResult* records = reinterpret_cast<const RatingResult*>(mapping.data());
+    if (reinterpret_cast<uintptr_t>(records) % alignof(RatingResult)) { // 매핑이 없어 통째로 읽은 경우 대비
+        copied.resize(count);
+        memcpy(copied.data(), mapping.data(), count * sizeof(RatingResult));
+        records = copied.data();
+    }
+    vector<string> names = loadRatingNames(path);
+
+    RatingEngine engine;
+    RatingRunStats stats;
+    bool resumed = !statePath.empty() && engine.load(statePath) && engine.processed <= count;
+    cout << "=== 플레이어 평점: " << path << " (" << count << "게임, 플레이어 " << names.size() << "명) ===\n";
+    if (mapping.size() % sizeof(RatingResult)) cout << "(마지막 기록이 잘려 무시함)\n";
+    if (resumed) {
+        cout << "상태 파일에서 이어서 계산: 이미 반영한 " << engine.processed << "게임 이후 " << count - engine.processed << "게임\n";
+        engine.run(records + engine.processed, count - engine.processed, threads, stats);
+    }
+    else engine.recompute(records, count, threads, stats);
+    printRatingStats(stats, threads);
+    if (!statePath.empty()) {
+        if (engine.save(statePath)) cout << "상태 저장: " << statePath << "\n";
+        else cout << "상태 파일을 쓸 수 없습니다: " << statePath << "\n";
+    }
+
+    for (int side = 0; side < RATING_SIDES; side++) {
+        vector<uint32_t> ranked;
+        for (uint32_t p = 0; p < engine.playerCount(); p++) {
+            if (engine.games[RatingEngine::key(p, side)] >= minGames) ranked.push_back(p);
+        }
+        auto conservative = [&](uint32_t p) { // 평점 - 3 * 불확실성
+            size_t k = RatingEngine::key(p, side);
+            return engine.mu[k] - 3 * engine.sigma[k];
+        };
+        sort(ranked.begin(), ranked.end(), [&](uint32_t a, uint32_t b) { return conservative(a) > conservative(b); });
+        cout << "\n" << (side == SIDE_MAFIA ? "마피아 팀" : "시민 팀") << " 상위 (" << minGames << "게임 이상, "
+            << ranked.size() << "명)\n순위\t이름\t평점\t불확실성\t보수적 평점\t게임\n";
+        cout << fixed << setprecision(2);
+        for (int i = 0; i < top && i < static_cast<int>(ranked.size()); i++) {
+            uint32_t p = ranked[i];
+            size_t k = RatingEngine::key(p, side);
+            cout << i + 1 << "\t" << (p < names.size() ? names[p] : "#" + to_string(p)) << "\t" << engine.mu[k] << "\t"
+                << engine.sigma[k] << "\t" << conservative(p) << "\t" << engine.games[k] << "\n";
+        }
+        cout.unsetf(ios::fixed);
+    }
+    return 0;
+}
+
+double spearman(const vector<double>& a, const vector<double>& b)
+{ // 순위 상관 (동점은 드물어 무시)
+    size_t n = a.size();
+    if (n < 2) return 0;
+    auto ranks = [n](const vector<double>& x) {
+        vector<uint32_t> order(n);
+        for (size_t i = 0; i < n; i++) order[i] = static_cast<uint32_t>(i);
+        sort(order.begin(), order.end(), [&](uint32_t i, uint32_t j) { return x[i] < x[j]; });
+        vector<double> rank(n);
+        for (size_t i = 0; i < n; i++) rank[order[i]] = static_cast<double>(i);
+        return rank;
+    };
+    vector<double> ra = ranks(a), rb = ranks(b);
+    double d2 = 0;
+    for (size_t i = 0; i < n; i++) d2 += (ra[i] - rb[i]) * (ra[i] - rb[i]);
+    return 1 - 6 * d2 / (static_cast<double>(n) * (static_cast<double>(n) * n - 1));
+}
+
+int runRateBenchCommand(int argc, char* argv[])
+{ // 사용법: napoly ratebench [--games N] [--players P] [--threads N] [--seed S]
+  // 숨은 실력을 가진 가상 플레이어의 결과 기록을 만들어 전체 재계산(병렬), 순차 재계산, 증분 갱신을 비교하고
+  // 추정 평점과 숨은 실력의 순위 상관을 출력
+    size_t gameCount = 5000000;
+    uint32_t population = 100000;
+    int threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    uint64_t seed = 42;
+    bool valid = true;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--games" && i + 1 < argc) gameCount = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--players" && i + 1 < argc) population = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (arg == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else valid = false;
+    }
+    if (!valid || gameCount < 100 || population < RATING_MAX_SEATS || threads <= 0) {
+        cout << "사용법: napoly ratebench [--games N] [--players P] [--threads N] [--seed S]\n";
+        return 1;
+    }
+
+    // 숨은 실력: 팀마다 따로 두되 서로 상관 (마피아 실력 = 0.6 * 시민 실력 + 0.8 * 독립 성분)
+    GameRng gen(seed, 1, RNG_STREAM_DECISION);
+    vector<double> skill(static_cast<size_t>(population) * RATING_SIDES);
+    for (uint32_t p = 0; p < population; p++) {
+        double citizen = normalSample(gen, 0, 1);
+        skill[RatingEngine::key(p, SIDE_CITIZEN)] = citizen;
+        skill[RatingEngine::key(p, SIDE_MAFIA)] = 0.6 * citizen + 0.8 * normalSample(gen, 0, 1);
+    }
+
+    // 결과 기록: 6~8인 테이블에 무작위 플레이어, 마피아 팀은 2명 (+ 7인 이상은 30%로 접선한 늑대인간)
+    // 마피아 팀 승률은 팀 평균 실력 차의 로지스틱 (같으면 40%), 1%는 무승부
+    auto generateBegin = steady_clock::now();
+    vector<RatingResult> records(gameCount);
+    for (size_t g = 0; g < gameCount; g++) {
+        RatingResult& r = records[g];
+        memset(&r, 0xFF, sizeof(r.players));
+        r.gameId = g + 1;
+        r.finishedAt = static_cast<uint32_t>(1700000000 + g / 100);
+        uint32_t roll = boundedRandom(gen, 10);
+        r.seats = static_cast<uint8_t>(roll < 6 ? 8 : roll < 8 ? 7 : 6);
+        for (int seat = 0; seat < r.seats; seat++) {
+            uint32_t p;
+            do p = boundedRandom(gen, population);
+            while (find(r.players, r.players + seat, p) != r.players + seat);
+            r.players[seat] = p;
+        }
+        int mafiaCount = 2 + (r.seats >= 7 && boundedRandom(gen, 10) < 3);
+        r.mafiaTeam = static_cast<uint8_t>((1u << mafiaCount) - 1); // 좌석은 무작위이므로 앞쪽을 마피아 팀으로
+        double team[RATING_SIDES] = {};
+        for (int seat = 0; seat < r.seats; seat++) {
+            int side = seat < mafiaCount ? SIDE_MAFIA : SIDE_CITIZEN;
+            team[side] += skill[RatingEngine::key(r.players[seat], side)] / (side == SIDE_MAFIA ? mafiaCount : r.seats - mafiaCount);
+        }
+        double mafiaWins = 1 / (1 + exp(-(log(0.4 / 0.6) + 1.5 * (team[SIDE_MAFIA] - team[SIDE_CITIZEN]))));
+        double u = uniformUnit(gen);
+        r.winner = static_cast<uint8_t>(u < 0.01 ? 0 : u < 0.01 + 0.99 * mafiaWins ? 2 : 1);
+        r.days = static_cast<uint8_t>(2 + boundedRandom(gen, 4));
+    }
+    double generateSeconds = duration<double>(steady_clock::now() - generateBegin).count();
+    cout << "=== 평점 재계산 벤치마크 (" << gameCount << "게임, 플레이어 " << population << "명, 시드 " << seed << ") ===\n";
+    cout << "가상 결과 기록 생성: " << fixed << setprecision(2) << generateSeconds << "초 ("
+        << gameCount * sizeof(RatingResult) / 1e6 << "MB)\n";
+    cout.unsetf(ios::fixed);
+
+    cout << "\n[전체 재계산, 구간별 단계 병렬]\n";
+    RatingEngine parallel;
+    RatingRunStats parallelStats;
+    parallel.recompute(records.data(), gameCount, threads, parallelStats);
+    printRatingStats(parallelStats, threads);
+
+    cout << "\n[전체 재계산, 파일 순서대로 순차]\n";
+    RatingEngine sequential;
+    RatingRunStats sequentialStats;
+    auto sequentialBegin = steady_clock::now();
+    sequential.update(records.data(), gameCount, &sequentialStats);
+    sequentialStats.applySeconds = duration<double>(steady_clock::now() - sequentialBegin).count();
+    printRatingStats(sequentialStats, 1);
+    bool same = parallel.digest() == sequential.digest();
+    cout << "평점 상태 일치: " << (same ? "예" : "아니오") << " (" << hex << parallel.digest() << " / " << sequential.digest() << dec << ")\n";
+
+    // 증분: 99%를 재계산한 상태에서 나머지를 끝난 순서대로 한 게임씩 반영
+    cout << "\n[증분 갱신]\n";
+    size_t head = gameCount - gameCount / 100;
+    RatingEngine incremental;
+    RatingRunStats headStats;
+    incremental.recompute(records.data(), head, threads, headStats);
+    auto incrementalBegin = steady_clock::now();
+    for (size_t g = head; g < gameCount; g++) incremental.update(&records[g], 1);
+    double incrementalSeconds = duration<double>(steady_clock::now() - incrementalBegin).count();
+    bool incrementalSame = incremental.digest() == sequential.digest();
+    cout << fixed << setprecision(3) << gameCount - head << "게임을 하나씩 반영: 게임당 "
+        << incrementalSeconds / max<size_t>(gameCount - head, 1) * 1e6 << "us, 전체 재계산과 일치: "
+        << (incrementalSame ? "예" : "아니오") << "\n";
+
+    cout << "\n[정확도: 추정 평점과 숨은 실력의 순위 상관]\n";
+    for (int side = 0; side < RATING_SIDES; side++) {
+        vector<double> truth, estimate;
+        for (uint32_t p = 0; p < population; p++) {
+            size_t k = RatingEngine::key(p, side);
+            if (parallel.games[k] < 20) continue;
+            truth.push_back(skill[k]);
+            estimate.push_back(parallel.mu[k]);
+        }
+        cout << (side == SIDE_MAFIA ? "마피아 팀" : "시민 팀") << ": " << spearman(truth, estimate) << " (20게임 이상 "
+            << truth.size() << "명)\n";
+    }
+    cout.unsetf(ios::fixed);
+    return same && incrementalSame ? 0 : 1;
+}
+
+#endif // RATING_H
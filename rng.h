@@ -0,0 +1,294 @@
+// rng.h
+#ifndef RNG_H
+#define RNG_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NAPOLY_RNG_AVX2 1
+#endif
+
+using namespace std;
+
+// 카운터 기반 난수 (Philox4x32-10)
+// 출력은 (실행 시드, 게임 번호, 스트림 종류, 블록 번호)만으로 결정되므로
+// 어느 스레드가 어떤 순서로 게임을 진행해도 같은 게임은 같은 난수열을 받음
+//   키    = 실행 시드 (64비트)
+//   카운터 = { 블록 번호, 스트림 종류, 게임 번호 하위 32비트, 게임 번호 상위 32비트 }
+
+enum RngStream
+{ // 한 게임 안의 용도별 스트림
+    RNG_STREAM_DEAL,      // 직업 배정
+    RNG_STREAM_DECISION,  // 봇의 밤 행동 및 투표
+    RNG_STREAM_COUNT
+};
+
+namespace philox
+{
+    const uint32_t M0 = 0xD2511F53u;
+    const uint32_t M1 = 0xCD9E8D57u;
+    const uint32_t W0 = 0x9E3779B9u;
+    const uint32_t W1 = 0xBB67AE85u;
+    const int ROUNDS = 10;
+
+    inline void block(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3,
+        uint32_t k0, uint32_t k1, uint32_t* out)
+    { // 블록 하나(32비트 x 4) 생성
+        for (int r = 0; r < ROUNDS; r++) {
+            uint64_t p0 = static_cast<uint64_t>(M0) * c0;
+            uint64_t p1 = static_cast<uint64_t>(M1) * c2;
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(p1);
+            c3 = static_cast<uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += W0;
+            k1 += W1;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+    inline void fillScalar(const uint32_t* c0, const uint32_t* c1, const uint32_t* c2, const uint32_t* c3,
+        uint32_t k0, uint32_t k1, uint32_t* out, size_t blocks)
+    {
+        for (size_t b = 0; b < blocks; b++) {
+            block(c0[b], c1[b], c2[b], c3[b], k0, k1, out + 4 * b);
+        }
+    }
+
+#ifdef NAPOLY_RNG_AVX2
+    __attribute__((target("avx2")))
+    inline void mulhilo(__m256i x, __m256i m, __m256i& hi, __m256i& lo)
+    { // 32x32 -> 64 곱셈 8개 (짝수/홀수 레인을 나눠 계산 후 합침)
+        __m256i even = _mm256_mul_epu32(x, m);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), m);
+        lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    }
+
+    __attribute__((target("avx2")))
+    inline void fillAvx2(const uint32_t* c0p, const uint32_t* c1p, const uint32_t* c2p, const uint32_t* c3p,
+        uint32_t k0, uint32_t k1, uint32_t* out, size_t blocks)
+    { // 블록 8개를 한 번에 계산한 뒤 블록 순서(AoS)로 전치해 저장
+        const __m256i m0 = _mm256_set1_epi32(static_cast<int>(M0));
+        const __m256i m1 = _mm256_set1_epi32(static_cast<int>(M1));
+        size_t b = 0;
+        for (; b + 8 <= blocks; b += 8) {
+            __m256i c0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c0p + b));
+            __m256i c1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c1p + b));
+            __m256i c2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c2p + b));
+            __m256i c3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c3p + b));
+            uint32_t rk0 = k0, rk1 = k1;
+            for (int r = 0; r < ROUNDS; r++) {
+                __m256i hi0, lo0, hi1, lo1;
+                mulhilo(c0, m0, hi0, lo0);
+                mulhilo(c2, m1, hi1, lo1);
+                c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(static_cast<int>(rk0)));
+                c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(static_cast<int>(rk1)));
+                c1 = lo1;
+                c3 = lo0;
+                rk0 += W0;
+                rk1 += W1;
+            }
+            __m256i t0 = _mm256_unpacklo_epi32(c0, c1);
+            __m256i t1 = _mm256_unpackhi_epi32(c0, c1);
+            __m256i t2 = _mm256_unpacklo_epi32(c2, c3);
+            __m256i t3 = _mm256_unpackhi_epi32(c2, c3);
+            __m256i u0 = _mm256_unpacklo_epi64(t0, t2); // 블록 0 | 4
+            __m256i u1 = _mm256_unpackhi_epi64(t0, t2); // 블록 1 | 5
+            __m256i u2 = _mm256_unpacklo_epi64(t1, t3); // 블록 2 | 6
+            __m256i u3 = _mm256_unpackhi_epi64(t1, t3); // 블록 3 | 7
+            __m256i* dst = reinterpret_cast<__m256i*>(out + 4 * b);
+            _mm256_storeu_si256(dst + 0, _mm256_permute2x128_si256(u0, u1, 0x20));
+            _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(u2, u3, 0x20));
+            _mm256_storeu_si256(dst + 2, _mm256_permute2x128_si256(u0, u1, 0x31));
+            _mm256_storeu_si256(dst + 3, _mm256_permute2x128_si256(u2, u3, 0x31));
+        }
+        fillScalar(c0p + b, c1p + b, c2p + b, c3p + b, k0, k1, out + 4 * b, blocks - b);
+    }
+
+    inline bool hasAvx2()
+    {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+#endif
+
+    inline void fill(const uint32_t* c0, const uint32_t* c1, const uint32_t* c2, const uint32_t* c3,
+        uint32_t k0, uint32_t k1, uint32_t* out, size_t blocks)
+    { // 카운터 배열(SoA) -> 출력 블록 배열, CPU가 지원하면 AVX2 경로 사용
+#ifdef NAPOLY_RNG_AVX2
+        if (blocks >= 8 && hasAvx2()) {
+            fillAvx2(c0, c1, c2, c3, k0, k1, out, blocks);
+            return;
+        }
+#endif
+        fillScalar(c0, c1, c2, c3, k0, k1, out, blocks);
+    }
+}
+
+template <typename Rng>
+uint32_t boundedRandom(Rng& gen, uint32_t range)
+{ // [0, range) 균등 난수 (Lemire의 곱셈 방식, 나눗셈은 드물게만 수행)
+  // 표준 분포 클래스와 달리 구현에 따라 결과가 달라지지 않음
+    uint64_t product = static_cast<uint64_t>(static_cast<uint32_t>(gen())) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < range) {
+        uint32_t limit = static_cast<uint32_t>(-range) % range;
+        while (low < limit) {
+            product = static_cast<uint64_t>(static_cast<uint32_t>(gen())) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+template <typename Rng>
+double uniformUnit(Rng& gen)
+{ // (0, 1)
+    return (static_cast<uint32_t>(gen()) + 0.5) / 4294967296.0;
+}
+
+template <typename Rng>
+double normalSample(Rng& gen, double mean, double deviation)
+{ // 박스-뮬러
+    double u = uniformUnit(gen), v = uniformUnit(gen);
+    return mean + deviation * sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+class GameRng
+{ // 한 게임의 한 스트림, UniformRandomBitGenerator 요건을 만족함
+public:
+    typedef uint32_t result_type;
+    static const size_t BUFFER_BLOCKS = 8;
+    static const size_t BUFFER_WORDS = BUFFER_BLOCKS * 4;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    GameRng(uint64_t seed, uint64_t game, uint32_t stream)
+        : key0(static_cast<uint32_t>(seed)), key1(static_cast<uint32_t>(seed >> 32)),
+        gameLow(static_cast<uint32_t>(game)), gameHigh(static_cast<uint32_t>(game >> 32)),
+        kind(stream), nextBlock(0), used(BUFFER_WORDS) {}
+
+    GameRng(uint64_t seed, uint64_t game, uint32_t stream, const uint32_t* firstBlock)
+        : GameRng(seed, game, stream)
+    { // 묶음으로 미리 계산한 0번 블록을 이어받음
+        memcpy(buffer + BUFFER_WORDS - 4, firstBlock, 4 * sizeof(uint32_t));
+        used = BUFFER_WORDS - 4;
+        nextBlock = 1;
+    }
+
+    result_type operator()()
+    {
+        if (used == BUFFER_WORDS) refill();
+        return buffer[used++];
+    }
+
+    uint64_t position() const
+    { // 지금까지 꺼낸 난수 개수 (결정 번호)
+        return static_cast<uint64_t>(nextBlock) * 4 - (BUFFER_WORDS - used);
+    }
+
+    void seek(uint64_t position)
+    { // position개를 꺼낸 직후 상태로 (체크포인트에서 이어서 진행할 때)
+        nextBlock = static_cast<uint32_t>(position / 4);
+        refill();
+        used = static_cast<size_t>(position % 4);
+    }
+
+private:
+    uint32_t key0, key1;
+    uint32_t gameLow, gameHigh;
+    uint32_t kind;
+    uint32_t nextBlock;
+    size_t used;
+    uint32_t buffer[BUFFER_WORDS];
+
+    void refill()
+    {
+        uint32_t c0[BUFFER_BLOCKS], c1[BUFFER_BLOCKS], c2[BUFFER_BLOCKS], c3[BUFFER_BLOCKS];
+        for (size_t b = 0; b < BUFFER_BLOCKS; b++) {
+            c0[b] = nextBlock + static_cast<uint32_t>(b);
+            c1[b] = kind;
+            c2[b] = gameLow;
+            c3[b] = gameHigh;
+        }
+        philox::fill(c0, c1, c2, c3, key0, key1, buffer, BUFFER_BLOCKS);
+        nextBlock += BUFFER_BLOCKS;
+        used = 0;
+    }
+};
+
+class RngService
+{ // 실행 시드를 보관하고 게임별 스트림을 만들어 줌
+private:
+    uint64_t runSeed;
+
+public:
+    RngService() : runSeed(entropySeed()) {}
+    explicit RngService(uint64_t seed) : runSeed(seed) {}
+
+    static uint64_t entropySeed()
+    {
+        random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    void reseed(uint64_t seed) { runSeed = seed; }
+    uint64_t seed() const { return runSeed; }
+
+    GameRng stream(uint64_t gameId, RngStream kind) const
+    {
+        return GameRng(runSeed, gameId, kind);
+    }
+
+    void fill(uint64_t gameId, RngStream kind, uint32_t firstBlock, uint32_t* out, size_t blocks) const
+    { // 한 스트림의 연속 블록 (out에 4 * blocks 워드)
+        const size_t CHUNK = 64;
+        uint32_t c0[CHUNK], c1[CHUNK], c2[CHUNK], c3[CHUNK];
+        for (size_t done = 0; done < blocks; done += CHUNK) {
+            size_t count = min(CHUNK, blocks - done);
+            for (size_t b = 0; b < count; b++) {
+                c0[b] = firstBlock + static_cast<uint32_t>(done + b);
+                c1[b] = kind;
+                c2[b] = static_cast<uint32_t>(gameId);
+                c3[b] = static_cast<uint32_t>(gameId >> 32);
+            }
+            philox::fill(c0, c1, c2, c3, static_cast<uint32_t>(runSeed),
+                static_cast<uint32_t>(runSeed >> 32), out + 4 * done, count);
+        }
+    }
+
+    void fillGames(uint64_t firstGame, size_t games, RngStream kind, uint32_t* out) const
+    { // 연속된 게임들의 0번 블록 (시뮬레이터의 묶음 직업 배정용, out에 4 * games 워드)
+        const size_t CHUNK = 64;
+        uint32_t c0[CHUNK], c1[CHUNK], c2[CHUNK], c3[CHUNK];
+        for (size_t done = 0; done < games; done += CHUNK) {
+            size_t count = min(CHUNK, games - done);
+            for (size_t g = 0; g < count; g++) {
+                uint64_t game = firstGame + done + g;
+                c0[g] = 0;
+                c1[g] = kind;
+                c2[g] = static_cast<uint32_t>(game);
+                c3[g] = static_cast<uint32_t>(game >> 32);
+            }
+            philox::fill(c0, c1, c2, c3, static_cast<uint32_t>(runSeed),
+                static_cast<uint32_t>(runSeed >> 32), out + 4 * done, count);
+        }
+    }
+};
+
+RngService rngService;
+
+#endif // RNG_H
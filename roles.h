@@ -0,0 +1,145 @@
+// roles.h
+#ifndef ROLES_H
+#define ROLES_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 직업 등록부: 직업마다 팀, 밤 행동 우선순위, 밤 행동 종류, 조사/정보 공개 규칙을 데이터로 선언
+// 규칙 처리(processActions, submitNightAction, yourTurn, resolveDay, 승리 판정)는 직업 이름 대신
+// 번호로 이 표를 한 번 읽고 행동 종류로 분기하므로, 직업을 추가해도 행동당 비용이 늘지 않음
+
+enum RoleType
+{ // createRole의 번호 체계 (내장 직업, 등록부의 앞쪽 번호)
+    ROLE_MAFIA,
+    ROLE_WEREWOLF,
+    ROLE_POLICE,
+    ROLE_DOCTOR,
+    ROLE_SOLDIER,
+    ROLE_CITIZEN,
+    ROLE_DETECTIVE,
+    ROLE_TYPE_COUNT
+};
+
+enum RoleTeam : uint8_t
+{
+    TEAM_CITIZEN,
+    TEAM_MAFIA,
+    TEAM_WEREWOLF, // 접선 전에는 시민 팀, 접선 후에는 마피아 팀으로 셈
+};
+
+enum NightKind : uint8_t
+{ // 밤 행동 종류 (규칙 처리의 분기 기준)
+    NIGHT_NONE,        // 밤 행동 없음
+    NIGHT_KILL,        // 총격 (팀 대상 하나, 마지막 선택만 유효)
+    NIGHT_HUNT,        // 늑대인간: 접선 전에는 마피아 대상과 일치 여부, 접선 후에는 치료를 무시하는 살육
+    NIGHT_HEAL,        // 총격 대상 치료
+    NIGHT_INVESTIGATE, // 대상이 마피아인지 조사
+    NIGHT_TRACK,       // 대상이 이번 밤 누구를 지목했는지 확인 (모든 행동이 정해진 뒤 판정)
+};
+
+enum RoleReveal : uint8_t
+{ // 경찰 조사에 어떻게 보이는지
+    REVEAL_CITIZEN,
+    REVEAL_MAFIA,
+    REVEAL_BY_RULE,    // GameRules::policeSeesWerewolf를 따름
+};
+
+enum RoleSight : uint8_t
+{ // 밤 차례에 볼 수 있는 팀 정보
+    SIGHT_NONE,
+    SIGHT_MAFIA,             // 다른 마피아와 접선한 늑대인간
+    SIGHT_MAFIA_WHEN_TAMED,  // 접선한 뒤에만 마피아
+};
+
+class Player;
+
+struct RoleInfo
+{
+    const char* name;
+    RoleTeam team;
+    int priority;           // 밤 행동 처리 순서 (작을수록 먼저)
+    NightKind night;
+    RoleReveal reveal;
+    RoleSight sight;
+    bool armored;           // 총격을 한 번 버팀
+    shared_ptr<Player> (*create)(const string& name, int roleType);
+};
+
+// 내장 직업 클래스의 생성 함수 (jobs.h에서 정의)
+template <typename T>
+shared_ptr<Player> makeRole(const string& name, int roleType);
+shared_ptr<Player> makeRegisteredRole(const string& name, int roleType);
+class Mafia;
+class Werewolf;
+class Police;
+class Doctor;
+class Soldier;
+class Citizen;
+class Detective;
+
+class RoleRegistry
+{ // 번호 = 등록 순서, 게임 시작 전에만 추가 (진행 중에는 읽기만 하므로 잠금 없음)
+private:
+    vector<RoleInfo> roles;
+
+public:
+    RoleRegistry()
+    { // 우선순위는 예전 actionPriorities 표와 같음 (경찰은 표에 없어 0이던 값), 사립 탐정은 모든 행동 뒤
+        roles = {
+            { "마피아", TEAM_MAFIA, 3, NIGHT_KILL, REVEAL_MAFIA, SIGHT_MAFIA, false, makeRole<Mafia> },
+            { "늑대인간", TEAM_WEREWOLF, 1, NIGHT_HUNT, REVEAL_BY_RULE, SIGHT_MAFIA_WHEN_TAMED, false, makeRole<Werewolf> },
+            { "경찰", TEAM_CITIZEN, 0, NIGHT_INVESTIGATE, REVEAL_CITIZEN, SIGHT_NONE, false, makeRole<Police> },
+            { "의사", TEAM_CITIZEN, 2, NIGHT_HEAL, REVEAL_CITIZEN, SIGHT_NONE, false, makeRole<Doctor> },
+            { "군인", TEAM_CITIZEN, 4, NIGHT_NONE, REVEAL_CITIZEN, SIGHT_NONE, true, makeRole<Soldier> },
+            { "시민", TEAM_CITIZEN, 5, NIGHT_NONE, REVEAL_CITIZEN, SIGHT_NONE, false, makeRole<Citizen> },
+            { "사립 탐정", TEAM_CITIZEN, 6, NIGHT_TRACK, REVEAL_CITIZEN, SIGHT_NONE, false, makeRole<Detective> },
+        };
+    }
+
+    int add(RoleInfo info)
+    { // 새 직업 번호 반환 (전용 클래스가 없으면 능동 행동 없는 기본 플레이어로 생성)
+        if (!info.create) info.create = makeRegisteredRole;
+        roles.push_back(info);
+        return static_cast<int>(roles.size()) - 1;
+    }
+
+    void truncate(size_t count)
+    { // 벤치마크가 추가한 직업 제거
+        if (count >= ROLE_TYPE_COUNT && count < roles.size()) roles.resize(count);
+    }
+
+    const RoleInfo& operator[](int roleType) const
+    { // 범위 밖 번호는 시민
+        return roles[roleType >= 0 && roleType < static_cast<int>(roles.size()) ? roleType : ROLE_CITIZEN];
+    }
+
+    int size() const { return static_cast<int>(roles.size()); }
+
+    int find(const string& name) const
+    { // 이름으로 번호 찾기 (설정 해석용, 공백 무시, 없으면 -1)
+        auto squeeze = [](const string& text) {
+            string out;
+            for (char ch : text) if (ch != ' ') out += ch;
+            return out;
+        };
+        string key = squeeze(name);
+        for (size_t i = 0; i < roles.size(); i++) {
+            if (key == squeeze(roles[i].name)) return static_cast<int>(i);
+        }
+        return -1;
+    }
+};
+
+RoleRegistry roleRegistry;
+
+const char* roleTypeName(int roleType)
+{
+    return roleType >= 0 && roleType < roleRegistry.size() ? roleRegistry[roleType].name : "?";
+}
+
+#endif // ROLES_H
@@ -0,0 +1,349 @@
+// shard.h
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "simulation.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// 샤드 결과 파일: 전체 게임 번호 구간 중 한 조각을 진행한 결과 (여러 노드/프로세스가 파일로만 공유)
+// 카운터, 직업별 집계, 진행 일수의 HDR 버킷과 t-digest를 담고, napoly merge가 순서와 무관하게 합침
+// 프레임: magic, 형식 번호, 본문 길이, CRC32 (각 4바이트) + 가변 길이 정수로 기록한 본문
+
+const uint32_t SHARD_MAGIC = 0x4853504E; // "NPSH"
+const uint32_t SHARD_FORMAT = 1;
+
+struct ShardRange
+{ // 진행한 게임 번호 [first, last]
+    uint64_t first;
+    uint64_t last;
+};
+
+struct ShardResult
+{
+    uint64_t seed = 0;
+    int players = 0;
+    int maxDays = 0;
+    uint64_t totalGames = 0;   // 샤드로 나누기 전 전체 게임 수
+    vector<ShardRange> ranges; // 번호 순, 겹치지 않음
+    SimulationStats stats;
+
+    uint64_t games() const
+    {
+        uint64_t n = 0;
+        for (const auto& r : ranges) n += r.last - r.first + 1;
+        return n;
+    }
+};
+
+namespace shardcodec
+{
+    using auditcodec::putVarint;
+    using auditcodec::getVarint;
+
+    void putDouble(vector<uint8_t>& out, double value)
+    {
+        uint8_t bytes[sizeof(double)];
+        memcpy(bytes, &value, sizeof(bytes));
+        out.insert(out.end(), bytes, bytes + sizeof(bytes));
+    }
+
+    bool getDouble(const uint8_t*& p, const uint8_t* end, double& value)
+    {
+        if (end - p < static_cast<ptrdiff_t>(sizeof(double))) return false;
+        memcpy(&value, p, sizeof(double));
+        p += sizeof(double);
+        return true;
+    }
+
+    void encode(const ShardResult& result, vector<uint8_t>& out)
+    {
+        putVarint(out, result.seed);
+        putVarint(out, static_cast<uint64_t>(result.players));
+        putVarint(out, static_cast<uint64_t>(result.maxDays));
+        putVarint(out, result.totalGames);
+        putVarint(out, result.ranges.size());
+        for (const auto& r : result.ranges) {
+            putVarint(out, r.first);
+            putVarint(out, r.last - r.first);
+        }
+
+        const SimulationStats& s = result.stats;
+        putVarint(out, static_cast<uint64_t>(s.citizenWins));
+        putVarint(out, static_cast<uint64_t>(s.mafiaWins));
+        putVarint(out, static_cast<uint64_t>(s.draws));
+        putVarint(out, static_cast<uint64_t>(s.totalDays));
+        putVarint(out, s.resultHash);
+        putVarint(out, ROLE_TYPE_COUNT);
+        for (const auto& tally : s.roles) {
+            putVarint(out, static_cast<uint64_t>(tally.seats));
+            putVarint(out, static_cast<uint64_t>(tally.teamWins));
+            putVarint(out, static_cast<uint64_t>(tally.survived));
+        }
+
+        // HDR: 0이 아닌 버킷만 (앞 버킷과의 번호 차, 개수)
+        const LatencyHistogram& h = s.lengthHistogram;
+        putVarint(out, h.count);
+        putVarint(out, h.sum);
+        putVarint(out, h.max);
+        int used = 0;
+        for (uint64_t bucket : h.buckets) used += bucket != 0;
+        putVarint(out, static_cast<uint64_t>(used));
+        int previous = 0;
+        for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; i++) {
+            if (!h.buckets[i]) continue;
+            putVarint(out, static_cast<uint64_t>(i - previous));
+            putVarint(out, h.buckets[i]);
+            previous = i;
+        }
+
+        // t-digest: 중심 (평균, 무게), 무게는 정수 개수의 합
+        TDigest digest = s.lengthDigest;
+        const vector<TDigest::Centroid>& centroids = digest.list();
+        out.push_back(digest.isExact() ? 1 : 0);
+        putDouble(out, digest.minimum());
+        putDouble(out, digest.maximum());
+        putVarint(out, centroids.size());
+        for (const auto& c : centroids) {
+            putDouble(out, c.mean);
+            putVarint(out, static_cast<uint64_t>(c.weight));
+        }
+    }
+
+    bool decode(const uint8_t* p, const uint8_t* end, ShardResult& result)
+    {
+        uint64_t v, count;
+        if (!getVarint(p, end, result.seed)) return false;
+        if (!getVarint(p, end, v)) return false;
+        result.players = static_cast<int>(v);
+        if (!getVarint(p, end, v)) return false;
+        result.maxDays = static_cast<int>(v);
+        if (!getVarint(p, end, result.totalGames) || !getVarint(p, end, count)) return false;
+        result.ranges.clear();
+        for (uint64_t i = 0; i < count; i++) {
+            ShardRange r;
+            if (!getVarint(p, end, r.first) || !getVarint(p, end, v)) return false;
+            r.last = r.first + v;
+            result.ranges.push_back(r);
+        }
+
+        SimulationStats& s = result.stats;
+        uint64_t fields[4];
+        for (auto& field : fields) if (!getVarint(p, end, field)) return false;
+        s.citizenWins = static_cast<long long>(fields[0]);
+        s.mafiaWins = static_cast<long long>(fields[1]);
+        s.draws = static_cast<long long>(fields[2]);
+        s.totalDays = static_cast<long long>(fields[3]);
+        if (!getVarint(p, end, s.resultHash) || !getVarint(p, end, count) || count > ROLE_TYPE_COUNT) return false;
+        for (uint64_t role = 0; role < count; role++) { // 직업이 늘기 전 파일은 뒤쪽 직업이 0
+            RoleTally& tally = s.roles[role];
+            uint64_t seats, wins, survived;
+            if (!getVarint(p, end, seats) || !getVarint(p, end, wins) || !getVarint(p, end, survived)) return false;
+            tally.seats = static_cast<long long>(seats);
+            tally.teamWins = static_cast<long long>(wins);
+            tally.survived = static_cast<long long>(survived);
+        }
+
+        LatencyHistogram& h = s.lengthHistogram;
+        h = LatencyHistogram();
+        if (!getVarint(p, end, h.count) || !getVarint(p, end, h.sum) || !getVarint(p, end, h.max)) return false;
+        if (!getVarint(p, end, count)) return false;
+        uint64_t index = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            if (!getVarint(p, end, v)) return false;
+            index += v;
+            if (index >= static_cast<uint64_t>(LatencyHistogram::BUCKET_COUNT) || !getVarint(p, end, h.buckets[index])) return false;
+        }
+
+        if (p >= end) return false;
+        bool exact = *p++ != 0;
+        double minimum, maximum;
+        if (!getDouble(p, end, minimum) || !getDouble(p, end, maximum) || !getVarint(p, end, count)) return false;
+        vector<TDigest::Centroid> centroids(static_cast<size_t>(min<uint64_t>(count, static_cast<uint64_t>(end - p))));
+        if (centroids.size() != count) return false;
+        for (auto& c : centroids) {
+            if (!getDouble(p, end, c.mean) || !getVarint(p, end, v)) return false;
+            c.weight = static_cast<double>(v);
+        }
+        s.lengthDigest.restore(centroids, minimum, maximum, exact);
+        return p == end;
+    }
+}
+
+bool writeShardResult(const string& path, const ShardResult& result)
+{ // 임시 파일에 쓴 뒤 이름을 바꿈 (읽는 쪽이 쓰다 만 파일을 보지 않도록)
+    vector<uint8_t> frame(16);
+    shardcodec::encode(result, frame);
+    uint32_t header[4] = {
+        SHARD_MAGIC,
+        SHARD_FORMAT,
+        static_cast<uint32_t>(frame.size() - 16),
+        auditcodec::crc32(frame.data() + 16, frame.size() - 16) };
+    memcpy(frame.data(), header, sizeof(header));
+
+    string temporary = path + ".tmp";
+    FILE* out = fopen(temporary.c_str(), "wb");
+    if (!out) return false;
+    bool written = fwrite(frame.data(), 1, frame.size(), out) == frame.size() && fflush(out) == 0;
+#ifndef _WIN32
+    written = written && fsync(fileno(out)) == 0;
+#endif
+    fclose(out);
+    if (!written) {
+        remove(temporary.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    remove(path.c_str());
+#endif
+    return rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool writeShardResult(const string& path, const SimulationConfig& config, const SimulationStats& stats)
+{ // simulate --out: 이 실행이 진행한 구간 하나
+    ShardResult result;
+    result.seed = config.seed;
+    result.players = config.playerCount;
+    result.maxDays = config.maxDays;
+    result.totalGames = config.totalGames ? config.totalGames : static_cast<uint64_t>(config.games);
+    if (config.games > 0) result.ranges.push_back({ config.firstGame + 1, config.firstGame + config.games });
+    result.stats = stats;
+    return writeShardResult(path, result);
+}
+
+bool readShardResult(const string& path, ShardResult& result)
+{
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) return false;
+    uint32_t header[4];
+    vector<uint8_t> body;
+    bool ok = fread(header, 1, sizeof(header), in) == sizeof(header) &&
+        header[0] == SHARD_MAGIC && header[1] == SHARD_FORMAT;
+    if (ok) {
+        body.resize(header[2]);
+        ok = fread(body.data(), 1, body.size(), in) == body.size() &&
+            auditcodec::crc32(body.data(), body.size()) == header[3];
+    }
+    fclose(in);
+    return ok && shardcodec::decode(body.data(), body.data() + body.size(), result);
+}
+
+void printShardResult(ShardResult& result, ostream& out)
+{
+    const SimulationStats& s = result.stats;
+    uint64_t games = result.games();
+    double total = games ? static_cast<double>(games) : 1.0;
+    out << fixed << setprecision(2);
+    out << "시민 팀 승리: " << s.citizenWins << " (" << 100.0 * s.citizenWins / total << "%)\n";
+    out << "마피아 팀 승리: " << s.mafiaWins << " (" << 100.0 * s.mafiaWins / total << "%)\n";
+    out << "무승부: " << s.draws << "\n";
+    out << "평균 진행 일수: " << s.totalDays / total << "\n";
+    out << "시드: " << result.seed << ", 결과 해시: " << hex << setw(16) << setfill('0')
+        << s.resultHash << dec << setfill(' ') << "\n";
+
+    TDigest& digest = result.stats.lengthDigest;
+    const double quantiles[] = { 0.5, 0.9, 0.99 };
+    out << "진행 일수 분위 (HDR / t-digest" << (digest.isExact() ? ", 정확" : ", 근사") << "):";
+    out << setprecision(1);
+    for (double q : quantiles) {
+        out << " p" << static_cast<int>(q * 100) << " " << s.lengthHistogram.percentile(q) << " / " << digest.quantile(q);
+    }
+    out << ", 최대 " << s.lengthHistogram.max << "\n";
+
+    out << "직업\t좌석 수\t팀 승률\t생존율\n" << setprecision(2);
+    for (int role = 0; role < ROLE_TYPE_COUNT; role++) {
+        const RoleTally& tally = s.roles[role];
+        if (!tally.seats) continue;
+        out << roleTypeName(role) << "\t" << tally.seats << "\t" << 100.0 * tally.teamWins / tally.seats << "%\t"
+            << 100.0 * tally.survived / tally.seats << "%\n";
+    }
+    out.unsetf(ios::fixed);
+}
+
+int runMergeCommand(int argc, char* argv[])
+{ // 사용법: napoly merge 샤드 파일... [--out 파일]
+    vector<string> inputs;
+    string outPath;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+        else inputs.push_back(arg);
+    }
+    if (inputs.empty()) {
+        cout << "사용법: napoly merge 샤드 파일... [--out 파일]\n";
+        return 1;
+    }
+
+    ShardResult merged;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        ShardResult shard;
+        if (!readShardResult(inputs[i], shard)) {
+            cout << "샤드 결과 파일을 읽을 수 없습니다: " << inputs[i] << "\n";
+            return 1;
+        }
+        if (i == 0) {
+            merged.seed = shard.seed;
+            merged.players = shard.players;
+            merged.maxDays = shard.maxDays;
+            merged.totalGames = shard.totalGames;
+        }
+        else if (shard.seed != merged.seed || shard.players != merged.players ||
+            shard.maxDays != merged.maxDays || shard.totalGames != merged.totalGames) {
+            cout << "설정(시드, 인원, 최대 일수, 전체 게임 수)이 다른 샤드입니다: " << inputs[i] << "\n";
+            return 1;
+        }
+        merged.ranges.insert(merged.ranges.end(), shard.ranges.begin(), shard.ranges.end());
+        merged.stats.merge(shard.stats);
+    }
+
+    // 같은 게임을 두 번 세지 않도록 구간 겹침 검사, 맞닿은 구간은 하나로
+    sort(merged.ranges.begin(), merged.ranges.end(), [](const ShardRange& a, const ShardRange& b) { return a.first < b.first; });
+    vector<ShardRange> ranges;
+    for (const auto& r : merged.ranges) {
+        if (!ranges.empty() && r.first <= ranges.back().last) {
+            cout << "게임 번호 구간이 겹칩니다: " << r.first << "~" << min(r.last, ranges.back().last) << "\n";
+            return 1;
+        }
+        if (!ranges.empty() && r.first == ranges.back().last + 1) ranges.back().last = r.last;
+        else ranges.push_back(r);
+    }
+    merged.ranges.swap(ranges);
+
+    uint64_t games = merged.games();
+    cout << "=== 샤드 병합 (파일 " << inputs.size() << "개, " << merged.players << "인, 게임 "
+        << games << "/" << merged.totalGames << ") ===\n";
+    if (games < merged.totalGames) { // 빠진 구간 안내
+        cout << "빠진 게임 번호:";
+        uint64_t next = 1;
+        for (const auto& r : merged.ranges) {
+            if (r.first > next) cout << " " << next << "~" << r.first - 1;
+            next = r.last + 1;
+        }
+        if (next <= merged.totalGames) cout << " " << next << "~" << merged.totalGames;
+        cout << "\n";
+    }
+    printShardResult(merged, cout);
+
+    if (!outPath.empty()) {
+        if (!writeShardResult(outPath, merged)) {
+            cout << "병합 결과 파일을 쓸 수 없습니다: " << outPath << "\n";
+            return 1;
+        }
+        cout << "병합 결과: " << outPath << "\n";
+    }
+    return 0;
+}
+
+#endif // SHARD_H
@@ -0,0 +1,907 @@
+// simulation.h
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <thread>
+#include "function.h"
+#include "batch.h"
+#include "sketch.h"
+
+using namespace std;
+
+// 시뮬레이션 설정
+struct SimulationConfig
+{
+    int games = 1000;       // 진행할 게임 수
+    int playerCount = 8;    // 6~8명
+    int maxDays = 100;      // 이 날짜를 넘기면 무승부 처리
+    int threads = 1;        // 게임을 나눠 진행할 스레드 수
+    uint64_t seed = 0;      // 실행 시드 (같은 시드면 스레드 수와 무관하게 같은 결과)
+    uint64_t firstGame = 0; // 이 실행의 첫 게임 번호 - 1 (샤드: 앞선 샤드들의 게임 수)
+    uint64_t totalGames = 0; // 샤드로 나누기 전 전체 게임 수 (0이면 games)
+    int shardIndex = 0;     // --shard I/K
+    int shardCount = 1;
+    const RoleComposition* roles = nullptr; // 직업 구성 (nullptr이면 assignRoles 규칙, napoly tune 전용)
+    bool batch = false;     // 일괄 엔진(SoA + SIMD)으로 진행
+    bool runtimeDeck = false; // 일괄 엔진에서 인원별 고정 덱 대신 실행 시간 덱 사용 (비교용)
+    bool arena = true;      // 게임별 아레나 할당 (끄면 malloc, 비교용)
+    bool perf = false;      // 단계별 하드웨어 카운터 측정
+    bool metrics = false;   // 종료 시 지표 덤프 출력
+    string statsPath;       // 주기적으로 갱신할 통계 파일
+    string tracePath;       // Chrome/Perfetto 트레이스 파일
+    string auditPath;       // 감사 로그 파일
+    string archivePath;     // 끝난 게임 기록 보관소 (napoly query로 조회)
+    string outPath;         // 샤드 결과 파일 (napoly merge로 합침)
+    string checkpointPath;  // 단계별 체크포인트 (중단된 실행을 같은 명령으로 다시 돌리면 이어서 진행)
+    bool checkpointSync = false; // 체크포인트마다 fsync를 기다림 (napoly checkpointbench, 대화형 진행과 같은 조건)
+    BotPlugin* bot = nullptr; // 봇 입력을 대신하는 플러그인 (일괄 엔진 전용)
+};
+
+struct RoleTally
+{ // 직업별 좌석 수, 팀 승리, 생존
+    long long seats = 0;
+    long long teamWins = 0;
+    long long survived = 0;
+};
+
+struct SimulationStats
+{
+    long long citizenWins = 0;
+    long long mafiaWins = 0;
+    long long draws = 0;
+    long long totalDays = 0;
+    uint64_t resultHash = 0; // 게임별 결과 해시의 합 (진행 순서와 무관)
+    RoleTally roles[ROLE_TYPE_COUNT];
+    LatencyHistogram lengthHistogram;  // 진행 일수 (HDR 버킷)
+    TDigest lengthDigest{ 200 };       // 진행 일수 (maxDays 100까지는 값마다 중심 하나라 정확)
+
+    void add(uint64_t gameId, Winner winner, int days, const DealOutcome& outcome)
+    {
+        if (winner == Winner::Citizen) citizenWins++;
+        else if (winner == Winner::Mafia) mafiaWins++;
+        else draws++;
+        totalDays += days;
+        lengthHistogram.record(static_cast<uint64_t>(days));
+        lengthDigest.add(days);
+
+        // 좌석별 분기 없이 셈 (승패와 생존은 게임마다 달라 분기 예측이 맞지 않음)
+        const int citizenWon = winner == Winner::Citizen, mafiaWon = winner == Winner::Mafia;
+        for (int seat = 0; seat < outcome.seats; seat++) {
+            int role = outcome.role(seat);
+            int mafiaTeam = (role == ROLE_MAFIA) | ((role == ROLE_WEREWOLF) & outcome.tamed);
+            RoleTally& tally = roles[role < ROLE_TYPE_COUNT ? role : ROLE_CITIZEN];
+            tally.seats++;
+            tally.teamWins += mafiaTeam ? mafiaWon : citizenWon;
+            tally.survived += (outcome.alive >> seat) & 1;
+        }
+
+        uint64_t h = gameId * 0x9E3779B97F4A7C15ull ^ (static_cast<uint64_t>(winner) << 56) ^ static_cast<uint64_t>(days);
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        resultHash += h ^ (h >> 31);
+    }
+
+    void merge(const SimulationStats& other)
+    {
+        citizenWins += other.citizenWins;
+        mafiaWins += other.mafiaWins;
+        draws += other.draws;
+        totalDays += other.totalDays;
+        resultHash += other.resultHash;
+        for (int role = 0; role < ROLE_TYPE_COUNT; role++) {
+            roles[role].seats += other.roles[role].seats;
+            roles[role].teamWins += other.roles[role].teamWins;
+            roles[role].survived += other.roles[role].survived;
+        }
+        lengthHistogram.merge(other.lengthHistogram);
+        lengthDigest.merge(other.lengthDigest);
+    }
+};
+
+// 봇 행동
+bool hasNightAbility(const shared_ptr<Player>& player)
+{
+    return player->roleInfo().night != NIGHT_NONE;
+}
+
+void botNightInput(GameRng& gen)
+{ // 살아있는 능력자가 무작위 생존자를 대상으로 지정
+    const vector<shared_ptr<Player>>& validTargets = roster.aliveRoster();
+    uint32_t targetCount = static_cast<uint32_t>(validTargets.size());
+
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        const auto& player = players[seat];
+        if (!player->checkAlive() || !player->getCanUseAbility() || !hasNightAbility(player))
+            continue;
+        TraceSpan seatSpan("night turn", "seat", currentDay, static_cast<int>(seat));
+        submitNightAction(player, validTargets[boundedRandom(gen, targetCount)]);
+    }
+}
+
+void botVoting(GameRng& gen)
+{ // 1차 투표(기권 포함)와 찬반 투표를 무작위로 진행
+    beginVoting();
+    const vector<shared_ptr<Player>>& alivePlayers = roster.aliveRoster(); // 처형은 마지막에만 일어남
+
+    map<shared_ptr<Player>, int> votes;
+    uint32_t choices = static_cast<uint32_t>(alivePlayers.size()) + 1; // 0: 기권
+    for (size_t index = 0; index < alivePlayers.size(); index++) {
+        const auto& voter = alivePlayers[index];
+        if (!voter->getCanVote()) continue;
+        TraceSpan seatSpan("vote turn", "seat", currentDay, seatOf(voter));
+        uint32_t choice = boundedRandom(gen, choices);
+        castBallot(votes, voter, choice > 0 ? alivePlayers[choice - 1] : nullptr);
+    }
+
+    VoteTally tally = tallyVotes(votes);
+    if (tally.maxVotePlayer && !tally.isDuplicate && tally.maxVotes > 0) {
+        int agree = 0, disagree = 0;
+        for (const auto& voter : alivePlayers) {
+            if (!voter->getCanVote()) continue;
+            if (gen() >> 31) agree++;
+            else disagree++;
+        }
+        resolveFinalVote(tally.maxVotePlayer, agree, disagree);
+    }
+}
+
+Winner runSimulatedGame(GameRng& gen, const SimulationConfig& config, const uint8_t* deal, uint64_t gameId,
+    DealOutcome* outcome = nullptr, const GameCheckpoint* resume = nullptr)
+{ // startGame과 같은 순서로 한 게임 진행 (입력은 봇이 대신함), outcome이 있으면 끝난 시점의 생존 좌석과 접선 여부를 채움
+  // resume이 있으면 beginGame 대신 그 체크포인트의 상태와 난수 위치에서 다음 단계부터 진행
+    TraceSpan gameSpan("game", "game");
+    GameArenaScope arena;
+    int phase = CHECKPOINT_DEALT; // 배정은 게임 번호로 다시 만들 수 있으므로 배정 직후는 남기지 않음
+    if (resume) {
+        restoreCheckpoint(*resume);
+        gen.seek(resume->rngPosition);
+        phase = resume->phase;
+    }
+    else beginGame(deal, gameId);
+
+    Winner winner = Winner::None;
+    while (true)
+    {
+        if (phase < CHECKPOINT_NIGHT_RESOLVED) {
+            {
+                PhaseScope scope(PHASE_NIGHT_INPUT);
+                beginNight();
+                botNightInput(gen);
+            }
+            {
+                PhaseScope scope(PHASE_PROCESS_ACTIONS);
+                nightManager.processActions();
+            }
+            saveCheckpoint(CHECKPOINT_NIGHT_RESOLVED, Winner::None, gen.position(), config.checkpointSync);
+        }
+        if (phase < CHECKPOINT_DAY_APPLIED) {
+            {
+                PhaseScope scope(PHASE_VICTORY_CHECK);
+                winner = evaluateVictory();
+            }
+            if (winner != Winner::None) break;
+
+            {
+                PhaseScope scope(PHASE_DAY_ANNOUNCE);
+                resolveDay();
+                nightManager.clear();
+            }
+            saveCheckpoint(CHECKPOINT_DAY_APPLIED, Winner::None, gen.position(), config.checkpointSync);
+        }
+        if (phase < CHECKPOINT_VOTED) {
+            {
+                PhaseScope scope(PHASE_VOTING);
+                botVoting(gen);
+            }
+            saveCheckpoint(CHECKPOINT_VOTED, Winner::None, gen.position(), config.checkpointSync);
+        }
+        {
+            PhaseScope scope(PHASE_VICTORY_CHECK);
+            winner = evaluateVictory();
+        }
+        if (winner != Winner::None) break;
+
+        phase = CHECKPOINT_DEALT;
+        if (++currentDay > config.maxDays) break;
+    }
+
+    if (outcome) { // 게임 상태는 아레나와 함께 곧 비워짐, 밤 직후 끝났으면 그 밤의 사망자도 사망으로 셈 (일괄 엔진과 같은 기준)
+        outcome->alive = static_cast<uint8_t>(roster.aliveSeats() & ~nightManager.pendingDeathSeats());
+        outcome->tamed = werewolfTamed;
+    }
+    saveCheckpoint(CHECKPOINT_FINISHED, winner, gen.position(), config.checkpointSync);
+    return winner;
+}
+
+const GameCheckpoint* findSimulatedGame(const SimulationConfig& config, uint64_t gameId, const uint8_t* deal)
+{ // 이전 실행이 남긴 이 게임의 마지막 체크포인트 (같은 시드, 같은 배정일 때만)
+    if (config.checkpointPath.empty()) return nullptr;
+    const map<uint64_t, GameCheckpoint>& recovered = checkpointLog.recovered();
+    auto it = recovered.find(gameId);
+    if (it == recovered.end()) return nullptr;
+    const GameCheckpoint& record = it->second;
+    if (record.room != CHECKPOINT_ROOM_SIMULATION || record.seed != rngService.seed() || record.seats != config.playerCount ||
+        memcmp(record.roles, deal, config.playerCount) != 0) return nullptr;
+    return &record;
+}
+
+void runSimulationWorker(const SimulationConfig& config, atomic<uint64_t>& nextGame, SimulationStats& stats)
+{ // 게임 번호를 묶음 단위로 가져가 진행, 각 게임의 난수는 게임 번호로만 결정됨
+    playlist.clear();
+    for (int i = 0; i < config.playerCount; i++) {
+        playlist.push_back("P" + to_string(i + 1));
+    }
+    muteGameOutput = true;
+    checkpointRoom = CHECKPOINT_ROOM_SIMULATION;
+
+    // 직업 배정은 묶음 단위로 미리 생성 (게임별 배정 스트림의 0번 블록을 한 번에 계산)
+    const uint64_t DEAL_BATCH = 1024;
+    const uint64_t games = static_cast<uint64_t>(config.games);
+    DealGenerator generator(config.playerCount);
+    if (config.roles) generator.reset(*config.roles, config.playerCount);
+    vector<uint32_t> dealBlocks(DEAL_BATCH * 4);
+    vector<uint8_t> deals(DEAL_BATCH * config.playerCount);
+
+    while (true) {
+        uint64_t first = nextGame.fetch_add(DEAL_BATCH);
+        if (first >= games) break;
+        size_t count = static_cast<size_t>(min(DEAL_BATCH, games - first));
+
+        // 게임 번호는 1부터 (0은 '새 번호 발급'을 뜻함), 샤드는 자기 구간의 번호만 진행
+        uint64_t base = config.firstGame + first + 1;
+        rngService.fillGames(base, count, RNG_STREAM_DEAL, dealBlocks.data());
+        for (size_t d = 0; d < count; d++) {
+            GameRng dealRng(rngService.seed(), base + d, RNG_STREAM_DEAL, dealBlocks.data() + 4 * d);
+            generator.deal(deals.data() + d * config.playerCount, dealRng);
+        }
+
+        for (size_t d = 0; d < count; d++) {
+            uint64_t gameId = base + d;
+            GameRng gen = rngService.stream(gameId, RNG_STREAM_DECISION);
+            const uint8_t* deal = deals.data() + d * config.playerCount;
+            DealOutcome outcome;
+            outcome.roles = packDeal(deal, config.playerCount);
+            outcome.seats = static_cast<uint8_t>(config.playerCount);
+            const GameCheckpoint* resume = findSimulatedGame(config, gameId, deal); // 끝난 게임은 압축 때 버려지므로 처음부터 다시 진행
+            Winner winner = runSimulatedGame(gen, config, deal, gameId, &outcome, resume);
+            recordGameFinished(winner);
+            stats.add(gameId, winner, currentDay, outcome);
+        }
+    }
+    flushArchiveBuffer();
+}
+
+template <typename Deck>
+void runBatchSimulationWorker(const SimulationConfig& config, const Deck& deck, atomic<uint64_t>& nextGame, SimulationStats& stats)
+{ // 일괄 엔진: 묶음으로 가져온 게임을 레인에 채우고, 끝난 레인은 다음 날 시작 전에 새 게임으로 채움
+    const uint64_t DEAL_BATCH = 1024;
+    const size_t BATCH_LANES = 512;
+    const uint64_t games = static_cast<uint64_t>(config.games);
+    vector<uint32_t> dealBlocks(DEAL_BATCH * 4);
+    vector<uint8_t> deal(config.playerCount);
+    GameBatch batch(deck.seats(), BATCH_LANES);
+    unique_ptr<BotDecisions> bot;
+    if (config.bot) { // 스레드마다 인스턴스 하나, 결정 열은 레인 수 x 좌석 수
+        bot.reset(new BotDecisions(*config.bot, rngService.seed(), BATCH_LANES * BatchColumns::MAX_SEATS));
+        batch.setBot(bot.get());
+    }
+
+    uint64_t first = 0;
+    size_t pending = 0, next = 0;
+    while (true) {
+        while (!batch.full()) {
+            if (next == pending) { // 다음 묶음의 배정 스트림 0번 블록을 한 번에 계산
+                first = nextGame.fetch_add(DEAL_BATCH);
+                if (first >= games) break;
+                pending = static_cast<size_t>(min(DEAL_BATCH, games - first));
+                next = 0;
+                rngService.fillGames(config.firstGame + first + 1, pending, RNG_STREAM_DEAL, dealBlocks.data());
+            }
+            uint64_t gameId = config.firstGame + first + 1 + next;
+            GameRng dealRng(rngService.seed(), gameId, RNG_STREAM_DEAL, dealBlocks.data() + 4 * next);
+            deck.deal(deal.data(), dealRng);
+            batch.add(gameId, deal.data(), rngService.stream(gameId, RNG_STREAM_DECISION));
+            next++;
+        }
+        if (batch.size() == 0) break;
+
+        batch.step(config.maxDays, [&stats](uint64_t gameId, uint8_t winner, int days, const DealOutcome& outcome) {
+            currentGameId = gameId;
+            currentDay = days;
+            recordGameFinished(static_cast<Winner>(winner));
+            stats.add(gameId, static_cast<Winner>(winner), days, outcome);
+        });
+    }
+}
+
+template <typename Worker>
+SimulationStats runSimulationThreads(const SimulationConfig& config, Worker worker)
+{ // worker(nextGame, stats)를 스레드마다 실행하고 결과를 합침
+    atomic<uint64_t> nextGame(0);
+    int threadCount = max(1, config.threads);
+    vector<SimulationStats> partial(threadCount);
+
+    if (threadCount == 1) {
+        worker(nextGame, partial[0]);
+    }
+    else {
+        vector<thread> workers;
+        for (int t = 0; t < threadCount; t++) {
+            workers.emplace_back([&worker, &nextGame, &partial, t]() { worker(nextGame, partial[t]); });
+        }
+        for (auto& thread : workers) thread.join();
+    }
+
+    SimulationStats stats;
+    for (const auto& part : partial) stats.merge(part);
+    return stats;
+}
+
+template <typename Deck>
+SimulationStats runBatchSimulation(const SimulationConfig& config, const Deck& deck)
+{
+    return runSimulationThreads(config, [&config, &deck](atomic<uint64_t>& nextGame, SimulationStats& stats) {
+        runBatchSimulationWorker(config, deck, nextGame, stats);
+    });
+}
+
+SimulationStats runSimulation(const SimulationConfig& config)
+{
+    rngService.reseed(config.seed);
+
+    if (!config.batch) {
+        return runSimulationThreads(config, [&config](atomic<uint64_t>& nextGame, SimulationStats& stats) {
+            runSimulationWorker(config, nextGame, stats);
+        });
+    }
+    if (config.roles) return runBatchSimulation(config, RuntimeDeck(*config.roles));
+    if (!config.runtimeDeck) { // 배포 환경의 덱은 인원별로 컴파일 타임에 특수화
+        switch (config.playerCount) {
+        case 6: return runBatchSimulation(config, FixedDeck<6>());
+        case 7: return runBatchSimulation(config, FixedDeck<7>());
+        case 8: return runBatchSimulation(config, FixedDeck<8>());
+        default: break;
+        }
+    }
+    return runBatchSimulation(config, RuntimeDeck(config.playerCount));
+}
+
+template <typename Deck>
+double measureDeals(const Deck& deck, uint64_t deals, uint64_t& checksum)
+{ // 배정기 단독 처리량 (deals/s), checksum은 두 배정기의 결과 비교용
+    GameRng gen = rngService.stream(0, RNG_STREAM_DEAL);
+    uint8_t out[BatchColumns::MAX_SEATS];
+    auto begin = steady_clock::now();
+    for (uint64_t d = 0; d < deals; d++) {
+        deck.deal(out, gen);
+        checksum = checksum * 31 + out[d % deck.seats()];
+    }
+    return deals / duration<double>(steady_clock::now() - begin).count();
+}
+
+int runDeckBenchCommand(int argc, char* argv[])
+{ // 사용법: napoly deckbench [게임 수] — 인원별 고정 덱과 실행 시간 덱의 처리량 비교
+    SimulationConfig config;
+    config.games = argc > 2 ? atoi(argv[2]) : 1000000;
+    config.batch = true;
+    config.seed = 42;
+    if (config.games <= 0) {
+        cout << "사용법: napoly deckbench [게임 수]\n";
+        return 1;
+    }
+    rngService.reseed(config.seed);
+    muteGameOutput = true;
+
+    cout << "=== 인원별 고정 덱 벤치마크 (" << config.games << "게임, 일괄 엔진 "
+        << batchkernel::backendName() << ") ===\n";
+    cout << "인원  배정(실행 시간)  배정(고정)  배정 일치  게임(실행 시간)  게임(고정)  결과 일치\n";
+    for (int players = 6; players <= 8; players++) {
+        config.playerCount = players;
+        uint64_t deals = static_cast<uint64_t>(config.games) * 10;
+        uint64_t runtimeSum = 0, fixedSum = 0;
+        double runtimeDeals = measureDeals(RuntimeDeck(players), deals, runtimeSum);
+        double fixedDeals = players == 6 ? measureDeals(FixedDeck<6>(), deals, fixedSum)
+            : players == 7 ? measureDeals(FixedDeck<7>(), deals, fixedSum)
+            : measureDeals(FixedDeck<8>(), deals, fixedSum);
+
+        double seconds[2];
+        uint64_t hashes[2];
+        for (int fixed = 0; fixed < 2; fixed++) {
+            config.runtimeDeck = !fixed;
+            auto begin = steady_clock::now();
+            SimulationStats stats = runSimulation(config);
+            seconds[fixed] = duration<double>(steady_clock::now() - begin).count();
+            hashes[fixed] = stats.resultHash;
+        }
+
+        cout << fixed << setprecision(1)
+            << setw(4) << players
+            << setw(14) << runtimeDeals / 1e6 << "M/s"
+            << setw(9) << fixedDeals / 1e6 << "M/s"
+            << setw(10) << (runtimeSum == fixedSum ? "예" : "아니오")
+            << setw(14) << config.games / seconds[0] / 1e6 << "M/s"
+            << setw(9) << config.games / seconds[1] / 1e6 << "M/s"
+            << setw(10) << (hashes[0] == hashes[1] ? "예" : "아니오") << "\n";
+    }
+    cout.unsetf(ios::fixed);
+    return 0;
+}
+
+volatile uint64_t benchSink = 0; // 벤치마크 계산이 최적화로 사라지지 않도록
+
+double measureNightResolution(int nights, bool byName, const vector<string>& names)
+{ // 좌석마다 밤 행동 하나를 등록하고 processActions까지 진행한 시간 (행동당 ns)
+  // byName이면 예전 방식처럼 행동마다 직업 이름으로 우선순위 표를 찾고 이름 비교 분기를 거침
+    static const int OFFSET = 2; // 마피아 -> 의사, 늑대인간 -> 경찰: 접선이나 방탄복처럼 상태가 바뀌는 판정은 피함
+    map<string, int> priorities;
+    for (size_t i = 0; i < names.size(); i++) priorities[names[i]] = roleRegistry[static_cast<int>(i)].priority;
+
+    int seats = static_cast<int>(players.size());
+    uint64_t sink = 0;
+    auto begin = steady_clock::now();
+    for (int night = 0; night < nights; night++) {
+        nightManager.clear();
+        nightResults.clear();
+        for (int seat = 0; seat < seats; seat++) {
+            const shared_ptr<Player>& actor = players[seat];
+            if (byName) {
+                string role = actor->getRole();
+                sink += priorities[role];
+                for (const string& name : names) { // 직업마다 늘어나던 if (getRole() == "...") 분기
+                    if (role == name) break;
+                    sink++;
+                }
+            }
+            nightManager.addAction(actor, players[(seat + OFFSET) % seats], actor->getRole());
+        }
+        nightManager.processActions();
+    }
+    double seconds = duration<double>(steady_clock::now() - begin).count();
+    benchSink = benchSink + sink;
+    return seconds * 1e9 / (static_cast<double>(nights) * seats);
+}
+
+int runRoleBenchCommand(int argc, char* argv[])
+{ // 사용법: napoly rolebench [밤 횟수] — 등록된 직업 수에 따른 밤 판정 비용
+    int nights = argc > 2 ? atoi(argv[2]) : 200000;
+    if (nights <= 0) {
+        cout << "사용법: napoly rolebench [밤 횟수]\n";
+        return 1;
+    }
+    muteGameOutput = true;
+    static deque<string> extraNames; // RoleInfo::name이 가리키는 저장소 (원소가 옮겨지지 않는 컨테이너)
+
+    cout << "=== 직업 등록부 밤 판정 벤치마크 (" << nights << "밤, 8좌석 x 행동 1개) ===\n";
+    cout << "등록 직업 수  등록부(ns/행동)  이름 분기(ns/행동, 예전 방식 재현)\n";
+    const int sizes[] = { ROLE_TYPE_COUNT, 16, 64, 256 }; // 좌석의 직업 번호는 uint8_t
+    for (int size : sizes) {
+        while (roleRegistry.size() < size) { // 경찰과 같은 조사 행동, 우선순위는 모두 다름
+            extraNames.push_back("추가 직업 " + to_string(roleRegistry.size()));
+            roleRegistry.add({ extraNames.back().c_str(), TEAM_CITIZEN, 10 + roleRegistry.size(), NIGHT_INVESTIGATE,
+                REVEAL_CITIZEN, SIGHT_NONE, false, nullptr });
+        }
+
+        // 마피아, 늑대인간, 의사, 경찰, 사립 탐정 + 가장 나중에 등록한 조사 직업 3개 (기본 등록부면 경찰)
+        vector<uint8_t> deal = { ROLE_MAFIA, ROLE_WEREWOLF, ROLE_DOCTOR, ROLE_POLICE, ROLE_DETECTIVE };
+        for (int i = 3; i >= 1; i--) deal.push_back(static_cast<uint8_t>(size > ROLE_TYPE_COUNT ? size - i : ROLE_POLICE));
+        playlist.clear();
+        for (size_t seat = 0; seat < deal.size(); seat++) playlist.push_back("P" + to_string(seat + 1));
+        assignRolesFromDeal(deal.data());
+        roster.rebuild(players, false);
+
+        vector<string> names;
+        for (int role = 0; role < roleRegistry.size(); role++) names.push_back(roleRegistry[role].name);
+        measureNightResolution(nights / 10 + 1, false, names); // 예열
+        double registry = measureNightResolution(nights, false, names);
+        double byName = measureNightResolution(nights, true, names);
+        cout << fixed << setprecision(1) << setw(12) << size << setw(17) << registry << setw(20) << byName << "\n";
+    }
+    cout.unsetf(ios::fixed);
+
+    releaseGameState();
+    roleRegistry.truncate(ROLE_TYPE_COUNT);
+    return 0;
+}
+
+bool samePublicView(const PublicState& a, const PublicState& b)
+{ // 관전자가 이벤트로 재구성한 상태와 방의 스냅샷 비교 (게시 순번 제외)
+    return a.gameId == b.gameId && a.day == b.day && a.phase == b.phase && a.aliveMask == b.aliveMask &&
+        a.winner == b.winner && memcmp(a.deathDay, b.deathDay, sizeof(a.deathDay)) == 0 &&
+        memcmp(a.deathCause, b.deathCause, sizeof(a.deathCause)) == 0;
+}
+
+int runSpectateBenchCommand(int argc, char* argv[])
+{ // 사용법: napoly spectatebench [방당 관전자 수] [--rooms R] [--workers W] [--games N] [--players N]
+  // 관전자 연결은 송신 스레드(workers)가 나눠 맡아 차례로 읽음 (연결마다 스레드를 두지 않음)
+    int spectators = 1000;
+    int rooms = 1;
+    int workers = max(1, static_cast<int>(thread::hardware_concurrency()));
+    SimulationConfig config;
+    config.games = 20000;
+    config.seed = 42;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--rooms" && i + 1 < argc) rooms = atoi(argv[++i]);
+        else if (arg == "--workers" && i + 1 < argc) workers = atoi(argv[++i]);
+        else if (arg == "--games" && i + 1 < argc) config.games = atoi(argv[++i]);
+        else if (arg == "--players" && i + 1 < argc) config.playerCount = atoi(argv[++i]);
+        else spectators = atoi(arg.c_str());
+    }
+    if (spectators < 0 || rooms <= 0 || workers <= 0 || config.games <= 0 || config.playerCount < 6 || config.playerCount > 8) {
+        cout << "사용법: napoly spectatebench [방당 관전자 수] [--rooms R] [--workers W] [--games N] [--players N]\n";
+        return 1;
+    }
+    rngService.reseed(config.seed);
+
+    // 방마다 게임 스레드 하나가 config.games 판을 연속 진행하며 이벤트를 방송
+    auto runRooms = [&config](vector<unique_ptr<SpectatorRoom>>& roomList, atomic<int>& producersLeft) {
+        vector<thread> producers;
+        for (auto& room : roomList) {
+            SpectatorRoom* target = room.get();
+            producers.emplace_back([&config, target, &producersLeft]() {
+                target->attach();
+                atomic<uint64_t> nextGame(0);
+                SimulationStats stats;
+                runSimulationWorker(config, nextGame, stats);
+                producersLeft.fetch_sub(1, memory_order_release);
+            });
+        }
+        return producers;
+    };
+
+    // 1) 관전자 없이: 게임 스레드의 기준 속도
+    double baseSeconds;
+    {
+        vector<unique_ptr<SpectatorRoom>> roomList;
+        for (int r = 0; r < rooms; r++) roomList.emplace_back(new SpectatorRoom());
+        atomic<int> producersLeft(rooms);
+        auto begin = steady_clock::now();
+        vector<thread> producers = runRooms(roomList, producersLeft);
+        for (auto& t : producers) t.join();
+        baseSeconds = duration<double>(steady_clock::now() - begin).count();
+    }
+
+    // 2) 방마다 관전자 다수
+    vector<unique_ptr<SpectatorRoom>> roomList;
+    for (int r = 0; r < rooms; r++) roomList.emplace_back(new SpectatorRoom());
+    atomic<int> producersLeft(rooms);
+    atomic<bool> started(false);
+    atomic<uint64_t> delivered(0), resyncs(0), skipped(0), mismatches(0);
+
+    vector<thread> consumers;
+    for (int w = 0; w < workers; w++) {
+        consumers.emplace_back([&, w]() {
+            while (!started.load(memory_order_acquire)) this_thread::yield();
+            vector<unique_ptr<SpectatorCursor>> cursors; // 이 송신 스레드가 맡은 연결 (방 순서대로 고르게)
+            for (int index = w; index < spectators * rooms; index += workers) {
+                cursors.emplace_back(new SpectatorCursor(*roomList[index % rooms]));
+            }
+            auto ignore = [](const PublicEvent&) {};
+            while (true) {
+                size_t handled = 0;
+                for (auto& cursor : cursors) handled += cursor->poll(ignore);
+                if (handled > 0) continue;
+                if (producersLeft.load(memory_order_acquire) == 0) {
+                    bool caughtUp = true;
+                    for (int index = w, c = 0; index < spectators * rooms; index += workers, c++) {
+                        if (cursors[c]->nextPosition() < roomList[index % rooms]->events.published()) caughtUp = false;
+                    }
+                    if (caughtUp) break;
+                }
+                this_thread::sleep_for(microseconds(100)); // 새 이벤트가 없으면 송신 주기만큼 쉼
+            }
+            for (int index = w, c = 0; index < spectators * rooms; index += workers, c++) {
+                PublicState final;
+                roomList[index % rooms]->state.read(final);
+                if (!samePublicView(cursors[c]->state(), final)) mismatches++;
+                delivered += cursors[c]->received;
+                resyncs += cursors[c]->resyncs;
+                skipped += cursors[c]->skipped;
+            }
+        });
+    }
+
+    auto begin = steady_clock::now();
+    started.store(true, memory_order_release);
+    vector<thread> producers = runRooms(roomList, producersLeft);
+    for (auto& t : producers) t.join();
+    double producerSeconds = duration<double>(steady_clock::now() - begin).count();
+    for (auto& t : consumers) t.join();
+    double seconds = duration<double>(steady_clock::now() - begin).count();
+
+    uint64_t events = 0;
+    for (auto& room : roomList) events += room->events.published();
+    cout << "=== 관전자 방송 벤치마크 (방 " << rooms << "개 x 관전자 " << spectators << "명, 송신 스레드 "
+        << workers << "개, 방당 " << config.games << "게임, " << config.playerCount << "인) ===\n";
+    cout << fixed << setprecision(1);
+    cout << "방송 이벤트: " << events << "개 (게임당 " << static_cast<double>(events) / rooms / config.games << "개)\n";
+    cout << "게임 스레드: " << producerSeconds << "초 (관전자 없을 때 " << baseSeconds << "초)\n";
+    cout << "전달: " << delivered.load() << "건 (" << delivered.load() / seconds / 1e6 << "M/s, 기대 "
+        << events * spectators << "건 중 " << setprecision(2)
+        << 100.0 * delivered.load() / max<uint64_t>(1, events * spectators) << "%)\n";
+    cout << "덮어쓰기 후 재동기화: " << resyncs.load() << "회, 건너뛴 이벤트 " << skipped.load() << "개\n";
+    cout << "최종 상태 불일치: " << mismatches.load() << (mismatches.load() == 0 ? "  -> 정상\n" : "  -> 실패\n");
+    cout.unsetf(ios::fixed);
+    return mismatches.load() == 0 ? 0 : 1;
+}
+
+int runCheckpointBenchCommand(int argc, char* argv[])
+{ // 사용법: napoly checkpointbench [--rooms N] [--seconds S] [--file 경로]
+  // 방마다 스레드 하나가 봇 게임을 연속 진행하며 단계마다 체크포인트의 fsync를 기다림 (대화형 진행과 같은 조건)
+  // 같은 조건에서 그룹 커밋(묶음마다 fsync 한 번)과 레코드마다 fsync를 차례로 잼
+    int rooms = 64;
+    double seconds = 3;
+    string path = "napoly-checkpointbench.ckpt";
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--rooms" && i + 1 < argc) rooms = atoi(argv[++i]);
+        else if (arg == "--seconds" && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (arg == "--file" && i + 1 < argc) path = argv[++i];
+        else rooms = 0;
+    }
+    if (rooms <= 0 || seconds <= 0) {
+        cout << "사용법: napoly checkpointbench [--rooms N] [--seconds S] [--file 경로]\n";
+        return 1;
+    }
+
+    SimulationConfig config;
+    config.seed = 42;
+    config.checkpointSync = true;
+    rngService.reseed(config.seed);
+    cout << "=== 체크포인트 벤치마크 (방 " << rooms << "개, " << config.playerCount << "인, 방식마다 " << seconds << "초, " << path << ") ===\n";
+
+    double groupedRate = 0;
+    for (bool grouped : { true, false }) {
+        remove(path.c_str());
+        if (!openCheckpoints(path, grouped)) {
+            cout << "체크포인트 파일을 열 수 없습니다: " << path << "\n";
+            return 1;
+        }
+        atomic<uint64_t> nextGame(0), games(0);
+        auto deadline = steady_clock::now() + duration_cast<steady_clock::duration>(duration<double>(seconds));
+        auto begin = steady_clock::now();
+        vector<thread> workers;
+        for (int r = 0; r < rooms; r++) {
+            workers.emplace_back([&config, &nextGame, &games, deadline]() {
+                for (int i = 0; i < config.playerCount; i++) playlist.push_back("P" + to_string(i + 1));
+                muteGameOutput = true;
+                checkpointRoom = CHECKPOINT_ROOM_SIMULATION;
+                while (steady_clock::now() < deadline) {
+                    uint64_t gameId = nextGame.fetch_add(1) + 1;
+                    GameRng gen = rngService.stream(gameId, RNG_STREAM_DECISION);
+                    runSimulatedGame(gen, config, nullptr, gameId);
+                    games.fetch_add(1, memory_order_relaxed);
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        double elapsed = duration<double>(steady_clock::now() - begin).count();
+        uint64_t records = checkpointLog.durableRecords(), syncs = checkpointLog.syncCount();
+        checkpointLog.stop();
+
+        double rate = records / elapsed;
+        if (grouped) groupedRate = rate;
+        cout << fixed << setprecision(0);
+        cout << (grouped ? "그룹 커밋: " : "레코드마다 fsync: ") << rate << " 체크포인트/s (게임 "
+            << games.load() / elapsed << "판/s), fsync " << syncs / elapsed << "회/s, 묶음당 평균 "
+            << setprecision(1) << static_cast<double>(records) / max<uint64_t>(syncs, 1) << "건";
+        if (!grouped) cout << " -> 그룹 커밋이 " << groupedRate / max(rate, 1e-9) << "배";
+        cout << "\n";
+        cout.unsetf(ios::fixed);
+    }
+    remove(path.c_str());
+    return 0;
+}
+
+bool writeShardResult(const string& path, const SimulationConfig& config, const SimulationStats& stats); // shard.h
+
+int runSimulateCommand(int argc, char* argv[])
+{ // 사용법: napoly simulate [게임 수] [--players N] [--threads N] [--seed S] [--batch] [--bot 파일] [--no-arena] [--perf] [--metrics] [--stats 파일] [--trace 파일] [--audit 파일] [--archive 파일] [--shard I/K] [--out 파일] [--roles 구성] [--checkpoint 파일]
+    SimulationConfig config;
+    RoleComposition composition;
+    BotPlugin plugin;
+    string botPath;
+    bool validRoles = true;
+    config.seed = RngService::entropySeed();
+
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--perf") {
+            config.perf = true;
+        }
+        else if (arg == "--batch") {
+            config.batch = true;
+        }
+        else if (arg == "--bot" && i + 1 < argc) {
+            botPath = argv[++i];
+        }
+        else if (arg == "--no-arena") {
+            config.arena = false;
+        }
+        else if (arg == "--metrics") {
+            config.metrics = true;
+        }
+        else if (arg == "--players" && i + 1 < argc) {
+            config.playerCount = atoi(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+            if (config.threads == 0) config.threads = static_cast<int>(thread::hardware_concurrency());
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], nullptr, 0);
+        }
+        else if (arg == "--stats" && i + 1 < argc) {
+            config.statsPath = argv[++i];
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            config.tracePath = argv[++i];
+        }
+        else if (arg == "--audit" && i + 1 < argc) {
+            config.auditPath = argv[++i];
+        }
+        else if (arg == "--archive" && i + 1 < argc) {
+            config.archivePath = argv[++i];
+        }
+        else if (arg == "--shard" && i + 1 < argc) { // I/K: 전체 게임 번호 구간을 K개로 나눈 I번째 (0부터)
+            if (sscanf(argv[++i], "%d/%d", &config.shardIndex, &config.shardCount) != 2) config.shardCount = 0;
+        }
+        else if (arg == "--out" && i + 1 < argc) {
+            config.outPath = argv[++i];
+        }
+        else if (arg == "--checkpoint" && i + 1 < argc) {
+            config.checkpointPath = argv[++i];
+        }
+        else if (arg == "--roles" && i + 1 < argc) { // 예: 마피아2,늑대인간,경찰,의사,사립탐정,시민2 (인원은 합계)
+            validRoles = RoleComposition::parse(argv[++i], composition);
+            config.roles = &composition;
+        }
+        else {
+            config.games = atoi(arg.c_str());
+        }
+    }
+
+    // 직접 정한 구성: 인원은 구성의 합계, 샤드 결과 파일에는 구성이 없으므로 --out과 함께 쓸 수 없음
+    bool customRoles = config.roles != nullptr;
+    if (customRoles) config.playerCount = composition.total();
+    if (config.games <= 0 || config.playerCount < (customRoles ? 4 : 6) || config.playerCount > 8 || !validRoles ||
+        (customRoles && (composition.counts[ROLE_MAFIA] == 0 || !config.outPath.empty())) ||
+        config.shardCount < 1 || config.shardCount > config.games || config.shardIndex < 0 || config.shardIndex >= config.shardCount) {
+        cout << "사용법: napoly simulate [게임 수] [--players 6-8] [--threads N] [--seed S] [--batch] [--bot 파일] [--no-arena] [--perf] [--metrics] [--stats 파일] [--trace 파일] [--audit 파일] [--archive 파일] [--shard I/K] [--out 파일] [--roles 구성] [--checkpoint 파일]\n";
+        return 1;
+    }
+
+    // 샤드: 게임 번호 [first + 1, last]만 진행 (난수는 게임 번호로만 정해지므로 샤드를 합치면 전체 실행과 같음)
+    config.totalGames = static_cast<uint64_t>(config.games);
+    config.firstGame = config.totalGames * config.shardIndex / config.shardCount;
+    config.games = static_cast<int>(config.totalGames * (config.shardIndex + 1) / config.shardCount - config.firstGame);
+
+    if (!botPath.empty()) { // 결정을 묶음으로 넘기는 일은 일괄 엔진만 함
+        string error;
+        if (!plugin.load(botPath, error)) {
+            cout << "봇 플러그인을 불러올 수 없습니다: " << botPath << " (" << error << ")\n";
+            return 1;
+        }
+        config.bot = &plugin;
+        config.batch = true;
+    }
+
+    if (config.batch && (config.perf || !config.tracePath.empty() || !config.auditPath.empty() || !config.archivePath.empty() ||
+        !config.checkpointPath.empty())) {
+        cout << "일괄 엔진은 단계/좌석 단위 계측을 하지 않으므로 --perf, --trace, --audit, --archive, --checkpoint를 무시합니다.\n";
+        config.perf = false;
+        config.tracePath.clear();
+        config.auditPath.clear();
+        config.archivePath.clear();
+        config.checkpointPath.clear();
+    }
+
+    if (config.perf && config.threads > 1) {
+        cout << "--perf는 호출 스레드만 측정하므로 단일 스레드로 진행합니다.\n";
+        config.threads = 1;
+    }
+
+    if (config.perf && !phaseProfiler.enable()) {
+        cout << "하드웨어 카운터를 사용할 수 없습니다. (perf_event_open 실패)\n";
+        config.perf = false;
+    }
+
+    gameArenaEnabled = config.arena;
+    metricsReporter.start(config.statsPath);
+    if (!config.tracePath.empty() && !traceSession.start(config.tracePath)) {
+        cout << "트레이스 파일을 열 수 없습니다: " << config.tracePath << "\n";
+    }
+    if (!config.auditPath.empty() && !auditLog.start(config.auditPath)) {
+        cout << "감사 로그 파일을 열 수 없습니다: " << config.auditPath << "\n";
+    }
+    if (!config.archivePath.empty() && !gameArchive.start(config.archivePath, config.seed)) {
+        cout << "기록 보관소 파일을 열 수 없습니다: " << config.archivePath << "\n";
+    }
+    if (!config.checkpointPath.empty() && !openCheckpoints(config.checkpointPath)) {
+        cout << "체크포인트 파일을 열 수 없습니다: " << config.checkpointPath << "\n";
+        config.checkpointPath.clear();
+    }
+    size_t recoveredGames = config.checkpointPath.empty() ? 0 : checkpointLog.recovered().size();
+
+    auto begin = steady_clock::now();
+    SimulationStats stats = runSimulation(config);
+    double seconds = duration<double>(steady_clock::now() - begin).count();
+    traceSession.stop();
+    auditLog.stop();
+    gameArchive.stop();
+    checkpointLog.stop();
+
+    cout << "=== 시뮬레이션 결과 (" << config.playerCount << "인, " << config.games << "게임";
+    if (config.batch) cout << ", 일괄 엔진 " << batchkernel::backendName();
+    if (config.shardCount > 1) {
+        cout << ", 샤드 " << config.shardIndex << "/" << config.shardCount << ": 게임 "
+            << config.firstGame + 1 << "~" << config.firstGame + config.games;
+    }
+    cout << ") ===\n";
+    if (customRoles) cout << "직업 구성: " << composition.describe() << "\n";
+    cout << "시민 팀 승리: " << stats.citizenWins << "\n";
+    cout << "마피아 팀 승리: " << stats.mafiaWins << "\n";
+    cout << "무승부: " << stats.draws << "\n";
+    cout << "평균 진행 일수: " << fixed << setprecision(2)
+        << static_cast<double>(stats.totalDays) / config.games << "\n";
+    cout << "소요 시간: " << seconds << "초 (" << setprecision(0)
+        << config.games / seconds << " games/s, " << max(1, config.threads) << " 스레드)\n";
+    cout.unsetf(ios::fixed);
+    cout << "시드: " << config.seed << ", 결과 해시: " << hex << setw(16) << setfill('0')
+        << stats.resultHash << dec << setfill(' ') << "\n";
+    if (config.bot) {
+        uint64_t decisions = plugin.decisions.load(), batches = plugin.batches.load();
+        double perDecision = 1.0 / max<uint64_t>(decisions, 1);
+        cout << "봇 플러그인 " << plugin.name() << ": 결정 " << decisions << "개 (묶음 " << batches << "개, 묶음당 평균 "
+            << fixed << setprecision(0) << static_cast<double>(decisions) / max<uint64_t>(batches, 1) << "개), 엔진 쪽 "
+            << setprecision(1) << plugin.engineNs.load() * perDecision << "ns/결정, 플러그인 "
+            << plugin.pluginNs.load() * perDecision << "ns/결정\n";
+        cout.unsetf(ios::fixed);
+    }
+    if (!config.batch) { // 일괄 엔진은 게임 단위 할당이 없음
+        MetricsSnapshot snapshot = metricsRegistry.snapshot();
+        double games = static_cast<double>(config.games);
+        cout << "게임당 할당: 힙 " << fixed << setprecision(1)
+            << snapshot.counters[COUNTER_HEAP_ALLOCATIONS] / games << "회 / "
+            << snapshot.counters[COUNTER_HEAP_BYTES] / games << "바이트, 아레나 "
+            << snapshot.counters[COUNTER_ARENA_ALLOCATIONS] / games << "회 / "
+            << snapshot.counters[COUNTER_ARENA_BYTES] / games << "바이트";
+        if (snapshot.counters[COUNTER_ARENA_RETIRED]) {
+            cout << " (재사용 불가 아레나 " << snapshot.counters[COUNTER_ARENA_RETIRED] << "개)";
+        }
+        cout << "\n";
+        cout.unsetf(ios::fixed);
+    }
+
+    if (config.perf) {
+        phaseProfiler.printTable(cout);
+    }
+    if (!config.auditPath.empty()) {
+        auditLog.printSummary(cout);
+    }
+    if (!config.archivePath.empty()) {
+        gameArchive.printSummary(cout);
+    }
+    if (!config.checkpointPath.empty()) {
+        cout << "이전 실행에서 이어받은 게임: " << recoveredGames << "개\n";
+        checkpointLog.printSummary(cout);
+    }
+    if (!config.outPath.empty()) {
+        if (writeShardResult(config.outPath, config, stats)) cout << "샤드 결과: " << config.outPath << "\n";
+        else cout << "샤드 결과 파일을 쓸 수 없습니다: " << config.outPath << "\n";
+    }
+    if (config.metrics) {
+        cout << "\n";
+        metricsRegistry.snapshot().writeText(cout);
+    }
+    metricsReporter.stop();
+    return 0;
+}
+
+#endif // SIMULATION_H
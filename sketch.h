@@ -0,0 +1,189 @@
+// sketch.h
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// 병합형 t-digest (Dunning, k1 척도): 분포의 꼬리 분위를 작은 중심 목록으로 근사
+// 합칠 때는 모든 중심을 (평균, 무게) 순으로 정렬해 압축하므로 입력 순서와 무관한 결과가 나옴
+// 평균이 같은 중심은 먼저 그대로 합치므로 서로 다른 값이 compression개 이하면 근사 없이 정확함
+
+class TDigest
+{
+public:
+    struct Centroid
+    {
+        double mean;
+        double weight;
+    };
+
+private:
+    static const size_t BUFFER_SIZE = 1024; // 이만큼 모이면 압축
+    static const int RECENT_SIZE = 8;       // 최근 값별 무게 (정수 값처럼 같은 값이 반복되면 정렬 없이 합침)
+
+    double compression;
+    vector<Centroid> centroids; // 평균 순
+    vector<Centroid> buffer;    // 아직 압축하지 않은 값
+    Centroid recent[RECENT_SIZE];
+    int recentCount = 0;
+    double total = 0;
+    double minValue = 0;
+    double maxValue = 0;
+    bool exact = true;          // 근사 압축을 한 번도 하지 않음
+
+    double kOfQ(double q) const { return compression / (2 * M_PI) * asin(2 * q - 1); }
+    double qOfK(double k) const { return (sin(k * 2 * M_PI / compression) + 1) / 2; }
+
+    void flushRecent()
+    {
+        buffer.insert(buffer.end(), recent, recent + recentCount);
+        recentCount = 0;
+        if (buffer.size() >= BUFFER_SIZE) compress();
+    }
+
+    void absorb(const Centroid& c)
+    {
+        if (total == 0 || c.mean < minValue) minValue = c.mean;
+        if (total == 0 || c.mean > maxValue) maxValue = c.mean;
+        total += c.weight;
+        buffer.push_back(c);
+    }
+
+public:
+    explicit TDigest(double compression = 100) : compression(compression) {}
+
+    void add(double value, double weight = 1)
+    {
+        for (int i = 0; i < recentCount; i++) {
+            if (recent[i].mean == value) {
+                recent[i].weight += weight;
+                total += weight;
+                return;
+            }
+        }
+        if (recentCount == RECENT_SIZE) flushRecent();
+        if (total == 0 || value < minValue) minValue = value;
+        if (total == 0 || value > maxValue) maxValue = value;
+        total += weight;
+        recent[recentCount++] = { value, weight };
+    }
+
+    void merge(const TDigest& other)
+    { // 압축은 다음 조회 때 한 번에 (여러 개를 합칠 때 중간 압축이 결과를 바꾸지 않도록)
+        for (const auto& c : other.centroids) absorb(c);
+        for (const auto& c : other.buffer) absorb(c);
+        for (int i = 0; i < other.recentCount; i++) absorb(other.recent[i]);
+        exact = exact && other.exact;
+        if (other.total > 0) { // 중심 평균보다 바깥의 실제 최소/최대
+            minValue = min(minValue, other.minValue);
+            maxValue = max(maxValue, other.maxValue);
+        }
+    }
+
+    void compress()
+    {
+        buffer.insert(buffer.end(), recent, recent + recentCount);
+        recentCount = 0;
+        if (buffer.empty()) return;
+        buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+        sort(buffer.begin(), buffer.end(), [](const Centroid& a, const Centroid& b) {
+            return a.mean < b.mean || (a.mean == b.mean && a.weight < b.weight);
+        });
+
+        // 1) 같은 평균은 정확히 합침
+        vector<Centroid> merged;
+        merged.reserve(buffer.size());
+        for (const auto& c : buffer) {
+            if (!merged.empty() && merged.back().mean == c.mean) merged.back().weight += c.weight;
+            else merged.push_back(c);
+        }
+        buffer.clear();
+
+        // 2) 그래도 많으면 k1 척도로 인접 중심을 합침 (중심 하나가 k 척도로 1 이하를 차지)
+        if (merged.size() > static_cast<size_t>(compression)) {
+            exact = false;
+            vector<Centroid> out;
+            out.push_back(merged[0]);
+            double before = 0; // out.back() 앞까지의 무게
+            double qLimit = qOfK(kOfQ(0) + 1);
+            for (size_t i = 1; i < merged.size(); i++) {
+                Centroid& last = out.back();
+                const Centroid& c = merged[i];
+                if ((before + last.weight + c.weight) / total <= qLimit) {
+                    last.mean += (c.mean - last.mean) * c.weight / (last.weight + c.weight);
+                    last.weight += c.weight;
+                }
+                else {
+                    before += last.weight;
+                    qLimit = qOfK(kOfQ(min(before / total, 1.0)) + 1);
+                    out.push_back(c);
+                }
+            }
+            merged.swap(out);
+        }
+        centroids.swap(merged);
+    }
+
+    double quantile(double q)
+    { // q는 0~1
+        compress();
+        if (centroids.empty()) return 0;
+        q = min(max(q, 0.0), 1.0);
+        if (exact) { // 중심 = 서로 다른 값: 누적 무게로 해당 값을 그대로 반환
+            double rank = max(1.0, ceil(q * total));
+            double seen = 0;
+            for (const auto& c : centroids) {
+                seen += c.weight;
+                if (seen >= rank) return c.mean;
+            }
+            return maxValue;
+        }
+        // 근사: 중심의 무게가 평균 좌우로 절반씩 퍼져 있다고 보고 이웃 중심 사이를 선형 보간
+        double index = q * total;
+        const Centroid& first = centroids.front();
+        const Centroid& last = centroids.back();
+        if (index <= first.weight / 2) return minValue + (first.mean - minValue) * index / (first.weight / 2);
+        double seen = first.weight / 2;
+        for (size_t i = 0; i + 1 < centroids.size(); i++) {
+            double step = (centroids[i].weight + centroids[i + 1].weight) / 2;
+            if (seen + step > index) {
+                double t = (index - seen) / step;
+                return centroids[i].mean + (centroids[i + 1].mean - centroids[i].mean) * t;
+            }
+            seen += step;
+        }
+        double tail = last.weight / 2;
+        return last.mean + (maxValue - last.mean) * min(1.0, (index - seen) / tail);
+    }
+
+    bool isExact() const { return exact; }
+
+    const vector<Centroid>& list()
+    {
+        compress();
+        return centroids;
+    }
+
+    double count() const { return total; }
+    double minimum() const { return minValue; }
+    double maximum() const { return maxValue; }
+
+    void restore(const vector<Centroid>& list, double minimum, double maximum, bool exactList)
+    { // 저장된 중심 목록으로 복원 (list는 평균 순)
+        centroids = list;
+        exact = exactList;
+        buffer.clear();
+        recentCount = 0;
+        total = 0;
+        for (const auto& c : centroids) total += c.weight;
+        minValue = minimum;
+        maxValue = maximum;
+    }
+};
+
+#endif // SKETCH_H
@@ -0,0 +1,746 @@
+// table.h
+#ifndef TABLE_H
+#define TABLE_H
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "function.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+// 로컬 소켓 테이블: 플레이어마다 자기 터미널에서 napoly join으로 접속해 밤 행동과 투표를 동시에 보냄
+// 테이블은 보여 줄 글자를 그대로 보내고, 플레이어는 한 줄에 번호 하나로 답함
+// 단계마다 물어본 좌석이 모두 답하거나 마감 시간이 지나면 판정 (답하지 않은 좌석은 행동 없음, 기권)
+// 소켓 입출력은 테이블 스레드의 poll 루프 하나에서 처리하므로 동시에 도착한 답도 도착 순서대로 하나씩 게임 상태에 반영됨
+// 공개 발표(낮 발표, 투표 결과, 승리)는 대화형 진행과 같은 함수가 cout에 쓰고 TableEcho가 모든 좌석에 같이 보냄
+
+const int TABLE_MAX_SEATS = 8;
+const size_t TABLE_LINE_LIMIT = 256;   // 한 줄 최대 길이 (넘는 부분은 버림)
+const size_t TABLE_NAME_LIMIT = 23;    // 이름 최대 바이트 (공개 상태의 이름 칸과 같음)
+const int TABLE_SEND_TIMEOUT_MS = 2000; // 읽지 않는 클라이언트 하나가 테이블을 멈추지 못하도록
+
+struct TableConfig
+{
+    string path;
+    int seats = 8;
+    int nightSeconds = 60;      // 밤 행동 마감
+    int voteSeconds = 45;       // 1차 투표와 찬반 투표 각각의 마감
+    int discussionSeconds = 30;
+    int lobbySeconds = 600;     // 모든 좌석이 찰 때까지 기다리는 시간
+};
+
+bool parseTableChoice(const string& line, int& value)
+{ // 앞뒤 공백을 뺀 0 이상의 정수 하나
+    size_t begin = line.find_first_not_of(" \t");
+    size_t end = line.find_last_not_of(" \t");
+    if (begin == string::npos || end - begin >= 3) return false;
+    value = 0;
+    for (size_t i = begin; i <= end; i++) {
+        if (line[i] < '0' || line[i] > '9') return false;
+        value = value * 10 + (line[i] - '0');
+    }
+    return true;
+}
+
+#ifndef _WIN32
+
+bool tableSendAll(int fd, const char* data, size_t size)
+{
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+class TableServer
+{ // 대기실과 좌석 연결 (테이블 스레드 전용)
+private:
+    struct Connection
+    {
+        int fd = -1;
+        string name;
+        string pending; // 아직 줄바꿈이 오지 않은 입력
+    };
+
+    int listenFd = -1;
+    string path;
+    vector<Connection> seats;
+    uint8_t dropped = 0;    // 끊겼지만 아직 알리지 않은 좌석
+    streambuf* console;     // 호스트 화면 (TableEcho를 걸기 전의 cout)
+
+    bool receive(Connection& connection, vector<string>& lines)
+    { // 읽을 수 있는 만큼 받아 완성된 줄을 lines에 추가, 연결이 끝났으면 false
+        char buffer[512];
+        ssize_t n = recv(connection.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n < 0) return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+        if (n == 0) return false;
+        ArenaBypass bypass; // 연결 버퍼는 게임보다 오래 삶
+        for (ssize_t i = 0; i < n; i++) {
+            char c = buffer[i];
+            if (c == '\n') {
+                lines.push_back(connection.pending);
+                connection.pending.clear();
+            }
+            else if (c != '\r' && connection.pending.size() < TABLE_LINE_LIMIT) {
+                connection.pending.push_back(c);
+            }
+        }
+        return true;
+    }
+
+    void drop(int seat)
+    {
+        Connection& connection = seats[seat];
+        if (connection.fd < 0) return;
+        close(connection.fd);
+        connection.fd = -1;
+        dropped |= static_cast<uint8_t>(1u << seat);
+    }
+
+    bool acceptName(Connection& connection, const string& name)
+    { // 대기실 연결의 첫 줄: 비어 있지 않고 겹치지 않는 이름이면 좌석 배정
+        bool valid = !name.empty() && name.size() <= TABLE_NAME_LIMIT && name.find_first_not_of(" \t") != string::npos;
+        for (const Connection& seat : seats) {
+            if (seat.name == name) valid = false;
+        }
+        if (!valid) {
+            string text = formatMessage(MSG_TABLE_NAME_TAKEN);
+            tableSendAll(connection.fd, text.data(), text.size());
+            return false;
+        }
+        connection.name = name;
+        seats.push_back(move(connection));
+        return true;
+    }
+
+public:
+    TableServer() : console(cout.rdbuf()) {}
+
+    ~TableServer()
+    {
+        for (Connection& connection : seats) {
+            if (connection.fd >= 0) close(connection.fd);
+        }
+        closeLobby();
+    }
+
+    TableServer(const TableServer&) = delete;
+    TableServer& operator=(const TableServer&) = delete;
+
+    bool open(const string& socketPath, string& error)
+    {
+        sockaddr_un address{};
+        if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+            error = "소켓 경로가 너무 깁니다";
+            return false;
+        }
+        struct stat info;
+        if (lstat(socketPath.c_str(), &info) == 0) { // 이전 실행이 남긴 소켓 파일만 지움
+            if (!S_ISSOCK(info.st_mode)) {
+                error = socketPath + "은(는) 소켓이 아닌 파일입니다";
+                return false;
+            }
+            unlink(socketPath.c_str());
+        }
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) {
+            error = strerror(errno);
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            listen(listenFd, TABLE_MAX_SEATS * 2) < 0) {
+            error = strerror(errno);
+            close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        path = socketPath;
+        return true;
+    }
+
+    void closeLobby()
+    { // 좌석이 다 차면 더 받지 않음
+        if (listenFd < 0) return;
+        close(listenFd);
+        listenFd = -1;
+        unlink(path.c_str());
+    }
+
+    bool gather(int count, int lobbySeconds, string& error)
+    { // count명이 접속해 이름을 보낼 때까지 대기 (좌석 번호는 들어온 순서)
+        vector<Connection> lobby; // 이름을 아직 보내지 않은 연결
+        vector<pollfd> fds;
+        vector<string> lines;
+        auto deadline = steady_clock::now() + seconds(lobbySeconds);
+        while (static_cast<int>(seats.size()) < count) {
+            auto left = duration_cast<milliseconds>(deadline - steady_clock::now()).count();
+            if (left <= 0) {
+                error = "대기 시간 안에 모든 좌석이 차지 않았습니다";
+                for (Connection& connection : lobby) close(connection.fd);
+                return false;
+            }
+            fds.assign(1, pollfd{ listenFd, POLLIN, 0 });
+            for (const Connection& connection : lobby) fds.push_back(pollfd{ connection.fd, POLLIN, 0 });
+            if (poll(fds.data(), fds.size(), static_cast<int>(left)) < 0 && errno != EINTR) {
+                error = strerror(errno);
+                return false;
+            }
+
+            for (size_t i = lobby.size(); i-- > 0;) {
+                if (!fds[i + 1].revents) continue;
+                lines.clear();
+                bool open = receive(lobby[i], lines);
+                if (!lines.empty() && static_cast<int>(seats.size()) < count && acceptName(lobby[i], lines[0])) {
+                    int seat = static_cast<int>(seats.size()) - 1;
+                    announce(formatMessage(MSG_TABLE_JOINED, seats[seat].name, to_string(seat + 1),
+                        to_string(seats.size()), to_string(count)));
+                }
+                else if (lines.empty() && open) {
+                    continue;
+                }
+                else {
+                    close(lobby[i].fd);
+                }
+                lobby.erase(lobby.begin() + i);
+            }
+
+            if (fds[0].revents & POLLIN) {
+                int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (fd >= 0) {
+                    timeval timeout{ TABLE_SEND_TIMEOUT_MS / 1000, (TABLE_SEND_TIMEOUT_MS % 1000) * 1000 };
+                    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                    Connection connection;
+                    connection.fd = fd;
+                    lobby.push_back(move(connection));
+                }
+            }
+        }
+        for (Connection& connection : lobby) close(connection.fd); // 좌석이 찬 뒤 이름을 보낸 연결
+        closeLobby();
+        return true;
+    }
+
+    bool arrange(const vector<string>& order)
+    { // 이어서 진행하는 방: 기록된 좌석 순서대로 접속을 다시 배치 (이름이 모두 맞을 때만)
+        if (order.size() != seats.size()) return false;
+        vector<size_t> from;
+        for (const string& name : order) {
+            size_t i = 0;
+            while (i < seats.size() && seats[i].name != name) i++;
+            if (i == seats.size()) return false;
+            from.push_back(i);
+        }
+        vector<Connection> arranged;
+        for (size_t i : from) arranged.push_back(move(seats[i]));
+        seats.swap(arranged);
+        return true;
+    }
+
+    vector<string> names() const
+    {
+        vector<string> result;
+        for (const Connection& connection : seats) result.push_back(connection.name);
+        return result;
+    }
+
+    bool connected(int seat) const { return seats[seat].fd >= 0; }
+
+    uint8_t connectedMask() const
+    {
+        uint8_t mask = 0;
+        for (size_t seat = 0; seat < seats.size(); seat++) {
+            if (seats[seat].fd >= 0) mask |= static_cast<uint8_t>(1u << seat);
+        }
+        return mask;
+    }
+
+    void send(int seat, const string& text)
+    { // 한 좌석에만 (보내지 못하면 연결을 끊음)
+        Connection& connection = seats[seat];
+        if (connection.fd >= 0 && !tableSendAll(connection.fd, text.data(), text.size())) drop(seat);
+    }
+
+    void announce(const string& text)
+    { // 호스트 화면과 모든 좌석에
+        console->sputn(text.data(), static_cast<streamsize>(text.size()));
+        console->pubsync();
+        for (size_t seat = 0; seat < seats.size(); seat++) send(static_cast<int>(seat), text);
+    }
+
+    void announceDrops()
+    { // 끊긴 좌석을 나머지에 알림 (보내는 중에 끊긴 좌석은 다음 차례에)
+        while (dropped) {
+            int seat = __builtin_ctz(dropped);
+            dropped &= static_cast<uint8_t>(dropped - 1);
+            announce(formatMessage(MSG_TABLE_LEFT, seats[seat].name));
+        }
+    }
+
+    void discardInput()
+    { // 단계가 바뀌기 전에 보낸 줄은 다음 단계의 답으로 쓰지 않음
+        vector<string> lines;
+        for (size_t seat = 0; seat < seats.size(); seat++) {
+            Connection& connection = seats[seat];
+            if (connection.fd < 0) continue;
+            bool open = true;
+            pollfd fd{ connection.fd, POLLIN, 0 };
+            while (open && poll(&fd, 1, 0) > 0) {
+                lines.clear();
+                open = receive(connection, lines);
+            }
+            connection.pending.clear();
+            if (!open) drop(static_cast<int>(seat));
+        }
+    }
+
+    template <class Fn>
+    uint8_t collect(uint8_t waiting, steady_clock::time_point deadline, Fn&& onLine)
+    { // waiting 좌석이 모두 답하거나 deadline까지 받은 줄을 onLine(좌석, 줄)에 넘김 (답한 좌석이면 true)
+      // 물어보지 않은 좌석의 줄도 넘김 (마피아의 대상 변경 등), 반환값은 답하지 않고 연결된 채로 남은 좌석
+        vector<pollfd> fds;
+        vector<int> owners;
+        vector<string> lines;
+        while (true) {
+            announceDrops();
+            waiting &= connectedMask();
+            if (!waiting) break;
+            auto left = duration_cast<milliseconds>(deadline - steady_clock::now()).count();
+            if (left <= 0) break;
+
+            fds.clear();
+            owners.clear();
+            for (size_t seat = 0; seat < seats.size(); seat++) {
+                if (seats[seat].fd < 0) continue;
+                fds.push_back(pollfd{ seats[seat].fd, POLLIN, 0 });
+                owners.push_back(static_cast<int>(seat));
+            }
+            if (poll(fds.data(), fds.size(), static_cast<int>(left)) <= 0) continue; // 시간 초과, EINTR은 위에서 다시 확인
+
+            for (size_t i = 0; i < fds.size(); i++) {
+                if (!fds[i].revents) continue;
+                int seat = owners[i];
+                lines.clear();
+                bool open = receive(seats[seat], lines);
+                for (const string& line : lines) {
+                    if (seats[seat].fd >= 0 && onLine(seat, line)) waiting &= static_cast<uint8_t>(~(1u << seat));
+                }
+                if (!open) drop(seat);
+            }
+        }
+        return waiting;
+    }
+};
+
+class TableEcho : public streambuf
+{ // 게임 동안 cout에 쓴 공개 발표를 줄 단위로 호스트 화면과 모든 좌석에 보냄
+private:
+    TableServer& table;
+    streambuf* saved;
+    string line;
+
+    void flushLine()
+    {
+        if (line.empty()) return;
+        table.announce(line);
+        line.clear();
+    }
+
+protected:
+    int overflow(int c) override
+    {
+        if (c == EOF) return 0;
+        {
+            ArenaBypass bypass;
+            line.push_back(static_cast<char>(c));
+        }
+        if (c == '\n') flushLine();
+        return c;
+    }
+
+    streamsize xsputn(const char* s, streamsize n) override
+    {
+        {
+            ArenaBypass bypass;
+            line.append(s, static_cast<size_t>(n));
+        }
+        if (memchr(s, '\n', static_cast<size_t>(n))) flushLine();
+        return n;
+    }
+
+    int sync() override
+    {
+        flushLine();
+        return 0;
+    }
+
+public:
+    explicit TableEcho(TableServer& table) : table(table)
+    {
+        ArenaBypass bypass;
+        line.reserve(1024);
+        saved = cout.rdbuf(this);
+    }
+
+    ~TableEcho()
+    {
+        flushLine();
+        cout.rdbuf(saved);
+    }
+
+    TableEcho(const TableEcho&) = delete;
+    TableEcho& operator=(const TableEcho&) = delete;
+};
+
+void notifyMafiaTarget(TableServer& table, const shared_ptr<Player>& chooser, const shared_ptr<Player>& target)
+{ // 마피아 대상이 정해지거나 바뀔 때마다 대상을 볼 수 있는 팀원(다른 마피아, 접선한 늑대인간)에게 알림
+    string text = formatMessage(MSG_TABLE_MAFIA_TARGET, chooser->getName(), target->getName());
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        const shared_ptr<Player>& member = players[seat];
+        if (member == chooser || !member->checkAlive()) continue;
+        RoleSight sight = member->roleInfo().sight;
+        if (sight == SIGHT_MAFIA || (sight == SIGHT_MAFIA_WHEN_TAMED && werewolfTamed)) {
+            table.send(static_cast<int>(seat), text);
+        }
+    }
+}
+
+void notifyWerewolfTarget(TableServer& table, const shared_ptr<Player>& target)
+{ // 접선한 늑대인간의 대상은 마피아에게 보임 (appendTeamBriefing과 같은 범위)
+    string text = formatMessage(MSG_WEREWOLF_TARGET, target->getName());
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        if (players[seat]->checkAlive() && players[seat]->roleInfo().sight == SIGHT_MAFIA) table.send(static_cast<int>(seat), text);
+    }
+}
+
+void sendNightResults(TableServer& table)
+{ // 살아 있는 좌석마다 본인의 밤 결과 (밤 판정 직후, 또는 그 시점에서 이어서 진행할 때)
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        const shared_ptr<Player>& player = players[seat];
+        if (!player->checkAlive()) continue;
+        string text = formatMessage(MSG_RESULTS_HEADER, player->getName());
+        appendNightResults(text, player->getName());
+        table.send(static_cast<int>(seat), text);
+    }
+}
+
+void tableNight(TableServer& table, const TableConfig& config)
+{ // 밤: 능력이 있는 생존 좌석에 동시에 묻고, 모두 답하거나 마감되면 판정 후 좌석마다 결과를 보냄
+    printMessage(MSG_NIGHT_HEADER, to_string(currentDay));
+    beginNight();
+
+    {
+        PhaseScope scope(PHASE_NIGHT_INPUT);
+        const vector<shared_ptr<Player>> targets = roster.aliveRoster();
+        string list;
+        for (size_t i = 0; i < targets.size(); i++) appendMessage(list, MSG_TARGET_ITEM, to_string(i + 1), targets[i]->getName());
+
+        table.discardInput();
+        uint8_t asked = 0;
+        for (size_t seat = 0; seat < players.size(); seat++) {
+            const shared_ptr<Player>& player = players[seat];
+            if (!player->checkAlive()) continue;
+            string text = formatMessage(MSG_YOUR_TURN, player->getName(), player->getRole());
+            if (!player->getCanUseAbility()) appendMessage(text, MSG_ABILITY_BLOCKED);
+            else if (player->roleInfo().night == NIGHT_NONE) appendMessage(text, MSG_NO_NIGHT_ROLE);
+            else {
+                text += list;
+                appendTeamBriefing(text, player);
+                appendMessage(text, MSG_TABLE_NIGHT_PROMPT, to_string(config.nightSeconds));
+                asked |= static_cast<uint8_t>(1u << seat);
+            }
+            table.send(static_cast<int>(seat), text);
+        }
+
+        // 마피아는 마감 전까지 대상을 다시 보낼 수 있음: submitNightAction이 앞선 마피아의 행동과 결과를 지우고 바꾸므로
+        // 동시에 보내도 도착 순서상 마지막 지목 하나만 남고, 바뀔 때마다 팀원에게 알림
+        uint8_t answered = 0;
+        uint8_t late = table.collect(asked, steady_clock::now() + seconds(config.nightSeconds),
+            [&](int seat, const string& line) {
+                uint8_t bit = static_cast<uint8_t>(1u << seat);
+                if (!(asked & bit)) return false;
+                const shared_ptr<Player>& player = players[seat];
+                NightKind kind = player->roleInfo().night;
+                int choice;
+                if (!parseTableChoice(line, choice) || choice > static_cast<int>(targets.size())) {
+                    table.send(seat, formatMessage(MSG_INVALID_CHOICE));
+                    return (answered & bit) != 0;
+                }
+                if ((answered & bit) && (kind != NIGHT_KILL || choice == 0)) {
+                    table.send(seat, formatMessage(MSG_TABLE_ALREADY));
+                    return true;
+                }
+                answered |= bit;
+                if (choice == 0) {
+                    table.send(seat, formatMessage(MSG_ABILITY_CANCELLED));
+                    return true;
+                }
+                const shared_ptr<Player>& target = targets[choice - 1];
+                submitNightAction(player, target);
+                table.send(seat, formatMessage(MSG_ABILITY_DONE) + formatMessage(MSG_TABLE_ACCEPTED));
+                if (kind == NIGHT_KILL) notifyMafiaTarget(table, player, target);
+                else if (kind == NIGHT_HUNT && werewolfTamed) notifyWerewolfTarget(table, target);
+                return true;
+            });
+        for (uint8_t rest = late; rest; rest &= static_cast<uint8_t>(rest - 1)) {
+            table.send(__builtin_ctz(rest), formatMessage(MSG_TABLE_TIMEOUT));
+        }
+    }
+
+    {
+        PhaseScope scope(PHASE_PROCESS_ACTIONS);
+        muteGameOutput = true; // 직업 행동이 cout에 쓰는 안내(경찰 조사 등)는 공개 발표가 아니므로 아래 좌석별 결과로만 보냄
+        nightManager.processActions();
+        muteGameOutput = false;
+    }
+    saveCheckpoint(CHECKPOINT_NIGHT_RESOLVED); // 결과를 보내기 전에 남김
+    sendNightResults(table);
+}
+
+void tableVoting(TableServer& table, const TableConfig& config)
+{ // 1차 투표와 찬반 투표를 각각 동시에 받음, 표는 좌석 순서로 반영 (감사 로그가 대화형 진행과 같은 순서)
+    PhaseScope scope(PHASE_VOTING);
+    printMessage(MSG_VOTE_HEADER);
+    beginVoting();
+
+    const vector<shared_ptr<Player>> alivePlayers = roster.aliveRoster(); // 처형 전 생존자
+    uint8_t voters = 0;
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        if (players[seat]->checkAlive() && players[seat]->getCanVote()) voters |= static_cast<uint8_t>(1u << seat);
+    }
+
+    string ballotText;
+    for (size_t i = 0; i < alivePlayers.size(); i++) appendMessage(ballotText, MSG_TARGET_ITEM, to_string(i + 1), alivePlayers[i]->getName());
+    appendMessage(ballotText, MSG_TABLE_VOTE_PROMPT, to_string(config.voteSeconds));
+    table.discardInput();
+    for (uint8_t rest = voters; rest; rest &= static_cast<uint8_t>(rest - 1)) table.send(__builtin_ctz(rest), ballotText);
+
+    int ballots[TABLE_MAX_SEATS] = {}; // 0이면 기권, 아니면 alivePlayers 번호 + 1
+    uint8_t cast = 0;
+    auto receiveBallot = [&](int maxChoice) {
+        return [&, maxChoice](int seat, const string& line) {
+            uint8_t bit = static_cast<uint8_t>(1u << seat);
+            if (!(voters & bit)) return false;
+            if (cast & bit) {
+                table.send(seat, formatMessage(MSG_TABLE_ALREADY));
+                return true;
+            }
+            int choice;
+            if (!parseTableChoice(line, choice) || choice > maxChoice || (maxChoice == 2 && choice == 0)) {
+                table.send(seat, formatMessage(MSG_INVALID_CHOICE));
+                return false;
+            }
+            ballots[seat] = choice;
+            cast |= bit;
+            table.send(seat, formatMessage(MSG_TABLE_ACCEPTED));
+            return true;
+        };
+    };
+
+    uint8_t late = table.collect(voters, steady_clock::now() + seconds(config.voteSeconds),
+        receiveBallot(static_cast<int>(alivePlayers.size())));
+    for (uint8_t rest = late; rest; rest &= static_cast<uint8_t>(rest - 1)) table.send(__builtin_ctz(rest), formatMessage(MSG_TABLE_TIMEOUT));
+
+    map<shared_ptr<Player>, int> votes;
+    for (uint8_t rest = voters; rest; rest &= static_cast<uint8_t>(rest - 1)) {
+        int seat = __builtin_ctz(rest);
+        castBallot(votes, players[seat], ballots[seat] ? alivePlayers[ballots[seat] - 1] : nullptr);
+    }
+    VoteTally tally = tallyVotes(votes);
+
+    if (tally.maxVotePlayer && !tally.isDuplicate && tally.maxVotes > 0) {
+        printMessage(MSG_FINAL_VOTE_HEADER, tally.maxVotePlayer->getName());
+        cout.flush();
+        string finalText = formatMessage(MSG_TABLE_FINAL_PROMPT, tally.maxVotePlayer->getName(), to_string(config.voteSeconds));
+        table.discardInput();
+        for (uint8_t rest = voters; rest; rest &= static_cast<uint8_t>(rest - 1)) table.send(__builtin_ctz(rest), finalText);
+
+        cast = 0;
+        late = table.collect(voters, steady_clock::now() + seconds(config.voteSeconds), receiveBallot(2));
+        for (uint8_t rest = late; rest; rest &= static_cast<uint8_t>(rest - 1)) table.send(__builtin_ctz(rest), formatMessage(MSG_TABLE_TIMEOUT));
+
+        int agree = 0, disagree = 0;
+        for (uint8_t rest = cast; rest; rest &= static_cast<uint8_t>(rest - 1)) {
+            int seat = __builtin_ctz(rest);
+            if (ballots[seat] == 1) agree++;
+            else disagree++;
+        }
+        announceFinalVote(tally.maxVotePlayer, agree, disagree);
+    }
+    else announceVoidVote(tally);
+    saveCheckpoint(CHECKPOINT_VOTED);
+}
+
+bool finishTableGame()
+{ // 승리 판정 (대화형 진행의 checkVictoryCondition에서 입력 대기만 뺀 것)
+    Winner winner;
+    {
+        PhaseScope scope(PHASE_VICTORY_CHECK);
+        winner = evaluateVictory();
+    }
+    if (winner == Winner::None) return false;
+    recordGameFinished(winner);
+    printMessage(winner == Winner::Citizen ? MSG_CITIZEN_WIN : MSG_MAFIA_WIN);
+    return true;
+}
+
+void runTableGame(TableServer& table, const TableConfig& config, const GameCheckpoint* resume = nullptr)
+{ // resume이 있으면 그 체크포인트 다음 단계부터 (좌석은 arrange로 기록된 순서에 맞춰 둠)
+    playlist = table.names(); // 좌석 번호 = 접속 순서
+    checkpointRoom = CHECKPOINT_ROOM_TABLE;
+    TraceSpan gameSpan("game", "game");
+    GameArenaScope arena;
+    TableEcho echo(table);
+    int phase = CHECKPOINT_DEALT;
+    if (resume) {
+        restoreCheckpoint(*resume);
+        phase = resume->phase;
+        printMessage(MSG_CHECKPOINT_RESUMED, to_string(resume->gameId), to_string(resume->day));
+        if (phase == CHECKPOINT_NIGHT_RESOLVED) sendNightResults(table); // 결과를 보내기 전에 멈춘 방
+    }
+    else {
+        beginGame();
+        saveCheckpoint(CHECKPOINT_DEALT);
+    }
+
+    while (true)
+    {
+        if (phase < CHECKPOINT_NIGHT_RESOLVED) tableNight(table, config);
+        if (phase < CHECKPOINT_DAY_APPLIED) {
+            if (finishTableGame()) break;
+            announceDay();
+        }
+
+        if (phase < CHECKPOINT_VOTED) {
+            printMessage(MSG_DISCUSSION, to_string(config.discussionSeconds));
+            cout.flush();
+            std::this_thread::sleep_for(seconds(config.discussionSeconds));
+            tableVoting(table, config);
+        }
+        if (finishTableGame()) break;
+
+        phase = CHECKPOINT_DEALT;
+        currentDay++;
+    }
+    cout.flush();
+}
+
+#endif // _WIN32
+
+int runTableCommand(int argc, char* argv[])
+{ // 사용법: napoly table 소켓경로 [--players N] [--night S] [--vote S] [--discussion S] [--lobby S]
+    TableConfig config;
+    if (argc > 2) config.path = argv[2];
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--players" && i + 1 < argc) config.seats = atoi(argv[++i]);
+        else if (arg == "--night" && i + 1 < argc) config.nightSeconds = atoi(argv[++i]);
+        else if (arg == "--vote" && i + 1 < argc) config.voteSeconds = atoi(argv[++i]);
+        else if (arg == "--discussion" && i + 1 < argc) config.discussionSeconds = atoi(argv[++i]);
+        else if (arg == "--lobby" && i + 1 < argc) config.lobbySeconds = atoi(argv[++i]);
+        else config.seats = 0;
+    }
+    if (config.path.empty() || config.path[0] == '-' || config.seats < 6 || config.seats > TABLE_MAX_SEATS ||
+        config.nightSeconds <= 0 || config.voteSeconds <= 0 || config.discussionSeconds < 0 || config.lobbySeconds <= 0) {
+        cout << "사용법: napoly table 소켓경로 [--players 6~8] [--night 초] [--vote 초] [--discussion 초] [--lobby 초]\n";
+        return 1;
+    }
+#ifndef _WIN32
+    TableServer table;
+    string error;
+    if (!table.open(config.path, error)) {
+        cerr << "테이블을 열 수 없습니다: " << error << "\n";
+        return 1;
+    }
+    printMessage(MSG_TABLE_LISTENING, config.path, to_string(config.seats));
+    cout.flush();
+    if (!table.gather(config.seats, config.lobbySeconds, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    // 같은 이름들이 다시 모였으면 중단된 방을 이어서 진행 (NAPOLY_CHECKPOINT_FILE)
+    const GameCheckpoint* resume = findInterruptedRoom(CHECKPOINT_ROOM_TABLE, table.names());
+    vector<string> recorded;
+    if (resume) {
+        for (int seat = 0; seat < resume->seats; seat++) {
+            recorded.push_back(string(resume->names[seat], strnlen(resume->names[seat], CHECKPOINT_NAME_BYTES)));
+        }
+    }
+    runTableGame(table, config, resume && table.arrange(recorded) ? resume : nullptr);
+    return 0;
+#else
+    cout << "이 환경에서는 소켓 테이블을 지원하지 않습니다.\n";
+    return 1;
+#endif
+}
+
+int runJoinCommand(int argc, char* argv[])
+{ // 사용법: napoly join 소켓경로 이름 (받은 글자는 그대로 화면에, 입력한 줄은 그대로 테이블에)
+    if (argc != 4) {
+        cout << "사용법: napoly join 소켓경로 이름\n";
+        return 1;
+    }
+#ifndef _WIN32
+    string socketPath = argv[2];
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "소켓 경로가 너무 깁니다\n";
+        return 1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        cerr << "테이블에 접속할 수 없습니다: " << strerror(errno) << "\n";
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    string hello = string(argv[3]) + "\n";
+    tableSendAll(fd, hello.data(), hello.size());
+
+    pollfd fds[2] = { { fd, POLLIN, 0 }, { STDIN_FILENO, POLLIN, 0 } };
+    char buffer[4096];
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents) { // 테이블이 닫으면 끝
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0 && !(n < 0 && errno == EINTR)) break;
+            if (n > 0 && write(STDOUT_FILENO, buffer, static_cast<size_t>(n)) < 0) break;
+        }
+        if (fds[1].revents) { // 입력이 끝나도 테이블이 닫을 때까지 발표는 계속 받음
+            ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (n <= 0) fds[1].fd = -1;
+            else if (!tableSendAll(fd, buffer, static_cast<size_t>(n))) break;
+        }
+    }
+    close(fd);
+    return 0;
+#else
+    cout << "이 환경에서는 소켓 테이블을 지원하지 않습니다.\n";
+    return 1;
+#endif
+}
+
+#endif // TABLE_H
@@ -0,0 +1,229 @@
+// trace.h
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "arena.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Chrome/Perfetto JSON 트레이스 (chrome://tracing, ui.perfetto.dev 에서 열 수 있음)
+// NAPOLY_DISABLE_TRACE 정의 시 TraceSpan은 빈 객체가 되어 코드가 완전히 제거됨
+
+struct TraceEvent
+{ // 완료 이벤트("ph":"X") 한 개, 이름은 정적 문자열만 사용
+    const char* name;
+    const char* category;
+    uint64_t beginNs;
+    uint64_t durationNs;
+    int32_t day;   // -1이면 생략
+    int32_t seat;  // -1이면 생략
+};
+
+class TraceRing
+{ // 스레드별 단일 생산자/단일 소비자 링 버퍼, 가득 차면 버림 (게임 스레드를 막지 않음)
+public:
+    static const size_t CAPACITY = 1 << 18;
+    static const size_t MASK = CAPACITY - 1;
+
+    explicit TraceRing(uint32_t threadId)
+        : events(new TraceEvent[CAPACITY]), head(0), tail(0), dropped(0), tid(threadId) {}
+
+    bool push(const TraceEvent& event)
+    {
+        size_t h = head.load(memory_order_relaxed);
+        if (h - tail.load(memory_order_acquire) >= CAPACITY) {
+            dropped.fetch_add(1, memory_order_relaxed);
+            return false;
+        }
+        events[h & MASK] = event;
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+
+    template <typename Fn>
+    size_t drain(Fn&& consume)
+    {
+        size_t t = tail.load(memory_order_relaxed);
+        size_t h = head.load(memory_order_acquire);
+        size_t count = h - t;
+        for (; t != h; t++) {
+            consume(events[t & MASK]);
+        }
+        tail.store(t, memory_order_release);
+        return count;
+    }
+
+    uint64_t droppedCount() const { return dropped.load(memory_order_relaxed); }
+    uint32_t threadId() const { return tid; }
+
+private:
+    unique_ptr<TraceEvent[]> events;
+    atomic<size_t> head;
+    atomic<size_t> tail;
+    atomic<uint64_t> dropped;
+    uint32_t tid;
+};
+
+class TraceSession
+{ // 링 버퍼를 주기적으로 비워 JSON 파일에 기록하는 백그라운드 스레드
+private:
+    atomic<bool> enabled;
+    mutex ringMutex;
+    vector<unique_ptr<TraceRing>> rings; // 스레드 종료 후에도 유지 (남은 이벤트 보존)
+    FILE* file;
+    bool firstEvent;
+    steady_clock::time_point origin;
+    atomic<bool> running;
+    thread flusher;
+
+    TraceRing* registerRing()
+    {
+        ArenaBypass bypass; // 게임 중 첫 기록이어도 링은 힙에
+        lock_guard<mutex> lock(ringMutex);
+        rings.push_back(unique_ptr<TraceRing>(new TraceRing(static_cast<uint32_t>(rings.size()))));
+        return rings.back().get();
+    }
+
+    void appendEvent(string& out, const TraceEvent& event, uint32_t tid)
+    { // 정수 연산만으로 마이크로초(소수점 3자리) 표기
+        char buffer[256];
+        unsigned long long ts = event.beginNs, dur = event.durationNs;
+        int length = snprintf(buffer, sizeof(buffer),
+            "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu.%03llu,\"dur\":%llu.%03llu,\"pid\":1,\"tid\":%u",
+            firstEvent ? "" : ",", event.name, event.category,
+            ts / 1000, ts % 1000, dur / 1000, dur % 1000, tid);
+        firstEvent = false;
+        out.append(buffer, static_cast<size_t>(length));
+
+        if (event.day >= 0 && event.seat >= 0)
+            length = snprintf(buffer, sizeof(buffer), ",\"args\":{\"day\":%d,\"seat\":%d}}", event.day, event.seat);
+        else if (event.day >= 0)
+            length = snprintf(buffer, sizeof(buffer), ",\"args\":{\"day\":%d}}", event.day);
+        else if (event.seat >= 0)
+            length = snprintf(buffer, sizeof(buffer), ",\"args\":{\"seat\":%d}}", event.seat);
+        else
+            length = snprintf(buffer, sizeof(buffer), "}");
+        out.append(buffer, static_cast<size_t>(length));
+    }
+
+    size_t drainAll()
+    { // 모든 링을 비워 한 번의 큰 쓰기로 기록
+        size_t total = 0;
+        string batch;
+        {
+            lock_guard<mutex> lock(ringMutex);
+            for (auto& ring : rings) {
+                uint32_t tid = ring->threadId();
+                total += ring->drain([this, &batch, tid](const TraceEvent& event) { appendEvent(batch, event, tid); });
+            }
+        }
+        if (!batch.empty()) fwrite(batch.data(), 1, batch.size(), file);
+        return total;
+    }
+
+    void run()
+    {
+        while (running.load()) {
+            if (drainAll() == 0) this_thread::sleep_for(milliseconds(5));
+        }
+    }
+
+public:
+    TraceSession() : enabled(false), file(nullptr), firstEvent(true), running(false) {}
+    ~TraceSession() { stop(); }
+
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+
+    bool start(const string& path)
+    {
+        if (running.load()) return true;
+        file = fopen(path.c_str(), "w");
+        if (!file) return false;
+
+        fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+        firstEvent = true;
+        origin = steady_clock::now();
+        running.store(true);
+        flusher = thread(&TraceSession::run, this);
+        enabled.store(true, memory_order_release);
+        return true;
+    }
+
+    void stop()
+    { // 기록 중지 후 남은 이벤트를 모두 쓰고 파일을 닫음
+        if (!running.load()) return;
+        enabled.store(false, memory_order_release);
+        running.store(false);
+        if (flusher.joinable()) flusher.join();
+        drainAll();
+
+        uint64_t dropped = 0;
+        for (auto& ring : rings) dropped += ring->droppedCount();
+        fprintf(file, "\n],\"otherData\":{\"droppedEvents\":%llu}}\n",
+            static_cast<unsigned long long>(dropped));
+        fclose(file);
+        file = nullptr;
+    }
+
+    uint64_t now() const
+    {
+        return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now() - origin).count());
+    }
+
+    TraceRing& local()
+    {
+        thread_local TraceRing* ring = nullptr;
+        if (!ring) ring = registerRing();
+        return *ring;
+    }
+};
+
+TraceSession traceSession;
+
+#ifndef NAPOLY_DISABLE_TRACE
+class TraceSpan
+{ // 생성~소멸 구간을 하나의 완료 이벤트로 기록 (비활성 시 분기 하나)
+private:
+    const char* name;
+    const char* category;
+    int32_t day;
+    int32_t seat;
+    uint64_t begin;
+    bool active;
+
+public:
+    TraceSpan(const char* n, const char* cat, int d = -1, int s = -1)
+        : name(n), category(cat), day(d), seat(s), begin(0), active(traceSession.isEnabled())
+    {
+        if (active) begin = traceSession.now();
+    }
+
+    ~TraceSpan()
+    {
+        if (active && traceSession.isEnabled()) {
+            traceSession.local().push({ name, category, begin, traceSession.now() - begin, day, seat });
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+#else
+class TraceSpan
+{
+public:
+    TraceSpan(const char*, const char*, int = -1, int = -1) {}
+};
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,317 @@
+// tuner.h
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "simulation.h"
+
+using namespace std;
+
+// 균형 조정기: 인원별로 직업 구성과 규칙 선택지를 모두 나열하고 양 팀 승률이 50%에 가장 가까운 후보를 찾음
+// 순차 표본 추출: 살아남은 후보마다 라운드 단위로 게임을 더 진행하고(라운드 크기는 매번 두 배),
+// 신뢰구간상 상위 후보보다 확실히 먼 후보는 그 자리에서 탈락시킴
+// 모든 후보가 같은 게임 번호(= 같은 배정/결정 난수 스트림)로 진행하므로 후보 간 비교의 분산이 줄어듦
+
+struct TuneConfig
+{
+    int minPlayers = 6;
+    int maxPlayers = 8;
+    uint64_t seed = 0;
+    int threads = 1;
+    uint64_t firstRound = 2000;   // 첫 라운드의 후보당 게임 수
+    uint64_t maxGames = 256000;   // 후보당 최대 게임 수
+    int top = 3;                  // 남길 후보 수
+    double confidence = 0.99;     // 후보 전체에 대한 동시 신뢰도 (본페로니 보정)
+    int maxDays = 100;
+    bool scalar = false;          // 일괄 엔진 대신 runSimulatedGame으로 진행 (비교용)
+};
+
+struct TuneCandidate
+{
+    RoleComposition roles;
+    GameRules rules;
+    uint64_t games = 0;
+    uint64_t citizenWins = 0;
+    uint64_t mafiaWins = 0;
+    uint64_t draws = 0;
+    bool active = true;
+    uint64_t droppedAt = 0;       // 탈락 시점의 게임 수 (0이면 끝까지 남음)
+
+    double citizenRate() const
+    { // 무승부는 양 팀에 절반씩
+        return games ? (citizenWins + draws * 0.5) / games : 0.5;
+    }
+
+    double distance() const { return fabs(citizenRate() - 0.5); }
+
+    double halfWidth(double z) const
+    { // 정규 근사 신뢰구간 반폭 (한쪽 팀만 이긴 경우도 폭이 0이 되지 않도록 분산 하한)
+        if (!games) return 1.0;
+        double p = citizenRate();
+        return z * sqrt(max(p * (1 - p), 1.0 / games) / games);
+    }
+
+    string describeRules() const
+    {
+        string text;
+        if (roles.counts[ROLE_SOLDIER] && roles.counts[ROLE_DOCTOR]) {
+            text += rules.doctorBeatsArmor ? "의사>방탄복" : "방탄복>의사";
+        }
+        if (roles.counts[ROLE_POLICE] && roles.counts[ROLE_WEREWOLF]) {
+            if (!text.empty()) text += ", ";
+            text += rules.policeSeesWerewolf ? "경찰이 늑대인간 감지" : "경찰이 늑대인간 못 봄";
+        }
+        return text;
+    }
+
+    bool isStandard(int players) const
+    { // 현재 assignRoles 구성 + 기본 규칙
+        const RoleComposition standard = RoleComposition::standard(players);
+        for (int role = 0; role < ROLE_TYPE_COUNT; role++) {
+            if (roles.counts[role] != standard.counts[role]) return false;
+        }
+        return !rules.doctorBeatsArmor && !rules.policeSeesWerewolf;
+    }
+};
+
+double normalQuantile(double p)
+{ // 표준정규분포의 p 분위 (이분법)
+    double lo = -10, hi = 10;
+    for (int i = 0; i < 100; i++) {
+        double mid = (lo + hi) / 2;
+        if (0.5 * erfc(-mid / sqrt(2.0)) < p) lo = mid;
+        else hi = mid;
+    }
+    return (lo + hi) / 2;
+}
+
+vector<TuneCandidate> enumerateCandidates(int players)
+{ // 마피아 1명 이상(시작부터 마피아 팀이 과반이 아닌 수), 경찰/의사/늑대인간/군인은 0~1명, 나머지 시민
+  // 규칙 선택지는 관련 직업이 모두 있을 때만 나눔
+    vector<TuneCandidate> candidates;
+    for (int mafia = 1; mafia * 2 < players; mafia++) {
+        for (int mask = 0; mask < 16; mask++) {
+            RoleComposition roles;
+            roles.counts[ROLE_MAFIA] = static_cast<uint8_t>(mafia);
+            roles.counts[ROLE_POLICE] = mask & 1;
+            roles.counts[ROLE_DOCTOR] = (mask >> 1) & 1;
+            roles.counts[ROLE_WEREWOLF] = (mask >> 2) & 1;
+            roles.counts[ROLE_SOLDIER] = (mask >> 3) & 1;
+            int special = roles.total();
+            if (special > players) continue;
+            roles.counts[ROLE_CITIZEN] = static_cast<uint8_t>(players - special);
+
+            bool armorChoice = roles.counts[ROLE_SOLDIER] && roles.counts[ROLE_DOCTOR];
+            bool policeChoice = roles.counts[ROLE_POLICE] && roles.counts[ROLE_WEREWOLF];
+            for (int armor = 0; armor <= (armorChoice ? 1 : 0); armor++) {
+                for (int police = 0; police <= (policeChoice ? 1 : 0); police++) {
+                    TuneCandidate candidate;
+                    candidate.roles = roles;
+                    candidate.rules.doctorBeatsArmor = armor != 0;
+                    candidate.rules.policeSeesWerewolf = police != 0;
+                    candidates.push_back(candidate);
+                }
+            }
+        }
+    }
+    return candidates;
+}
+
+void playCandidateGames(const TuneConfig& config, int players, TuneCandidate& candidate, uint64_t games)
+{ // 후보의 다음 게임 번호부터 games판 진행 (호출 스레드의 규칙을 잠시 바꿈)
+    SimulationConfig sim;
+    sim.games = static_cast<int>(games);
+    sim.playerCount = players;
+    sim.maxDays = config.maxDays;
+    sim.seed = config.seed;
+    sim.firstGame = candidate.games;
+    sim.roles = &candidate.roles;
+
+    gameRules = candidate.rules;
+    atomic<uint64_t> nextGame(0);
+    SimulationStats stats;
+    if (config.scalar) runSimulationWorker(sim, nextGame, stats);
+    else runBatchSimulationWorker(sim, RuntimeDeck(candidate.roles), nextGame, stats);
+    gameRules = GameRules();
+
+    candidate.games += games;
+    candidate.citizenWins += stats.citizenWins;
+    candidate.mafiaWins += stats.mafiaWins;
+    candidate.draws += stats.draws;
+}
+
+void runTuneRound(const TuneConfig& config, int players, const vector<TuneCandidate*>& jobs, uint64_t games)
+{ // 후보 단위로 스레드에 나눔
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < jobs.size(); ) {
+            playCandidateGames(config, players, *jobs[i], games);
+        }
+    };
+    int threadCount = max(1, min(config.threads, static_cast<int>(jobs.size())));
+    if (threadCount == 1) {
+        worker();
+        return;
+    }
+    vector<thread> workers;
+    for (int t = 0; t < threadCount; t++) workers.emplace_back(worker);
+    for (auto& thread : workers) thread.join();
+}
+
+int dropDistantCandidates(const vector<TuneCandidate*>& active, int top, double z)
+{ // 상위 top개의 거리 상한 중 가장 큰 값보다 거리 하한이 큰 후보를 탈락시킴, 탈락 수 반환
+    vector<double> upper;
+    for (const TuneCandidate* c : active) upper.push_back(c->distance() + c->halfWidth(z));
+    size_t keep = min(static_cast<size_t>(top), upper.size());
+    if (keep == 0) return 0;
+    nth_element(upper.begin(), upper.begin() + (keep - 1), upper.end());
+    double threshold = upper[keep - 1];
+
+    int dropped = 0;
+    for (TuneCandidate* c : active) {
+        if (c->distance() - c->halfWidth(z) > threshold) {
+            c->active = false;
+            c->droppedAt = c->games;
+            dropped++;
+        }
+    }
+    return dropped;
+}
+
+void printCandidate(const TuneCandidate& c, int players, double z)
+{
+    cout << c.roles.describe();
+    string rules = c.describeRules();
+    if (!rules.empty()) cout << " [" << rules << "]";
+    if (c.isStandard(players)) cout << " (현재 구성)";
+    cout << ": 시민 팀 " << fixed << setprecision(1) << c.citizenRate() * 100 << "% ±"
+        << c.halfWidth(z) * 100 << "%p, " << c.games << "게임";
+    if (c.droppedAt) cout << "에서 탈락";
+    cout << "\n";
+    cout.unsetf(ios::fixed);
+}
+
+void tuneLobby(const TuneConfig& config, int players)
+{
+    vector<TuneCandidate> candidates = enumerateCandidates(players);
+    double z = normalQuantile(1 - (1 - config.confidence) / (2.0 * candidates.size()));
+
+    auto begin = steady_clock::now();
+    uint64_t round = config.firstRound, played = 0;
+    int rounds = 0;
+    vector<TuneCandidate*> active;
+    for (auto& c : candidates) active.push_back(&c);
+
+    while (static_cast<int>(active.size()) > config.top) {
+        uint64_t games = min(round, config.maxGames - active.front()->games); // 남은 후보는 모두 같은 게임 수
+        if (games == 0) break;
+        runTuneRound(config, players, active, games);
+        played += games * active.size();
+        rounds++;
+        dropDistantCandidates(active, config.top, z);
+        active.erase(remove_if(active.begin(), active.end(), [](const TuneCandidate* c) { return !c->active; }), active.end());
+        round *= 2;
+    }
+    double seconds = duration<double>(steady_clock::now() - begin).count();
+
+    stable_sort(candidates.begin(), candidates.end(), [](const TuneCandidate& a, const TuneCandidate& b) {
+        if (a.active != b.active) return a.active;
+        return a.distance() < b.distance();
+    });
+
+    uint64_t droppedGames = 0, droppedCount = 0;
+    for (const auto& c : candidates) {
+        if (c.droppedAt) {
+            droppedGames += c.droppedAt;
+            droppedCount++;
+        }
+    }
+
+    cout << "=== " << players << "인: 후보 " << candidates.size() << "개, 라운드 " << rounds
+        << ", 동시 신뢰도 " << config.confidence * 100 << "% (z = " << fixed << setprecision(2) << z << ") ===\n";
+    cout.unsetf(ios::fixed);
+    int rank = 0;
+    for (const auto& c : candidates) {
+        if (!c.active) break;
+        cout << setw(3) << ++rank << ". ";
+        printCandidate(c, players, z);
+    }
+    if (static_cast<int>(active.size()) > config.top) {
+        cout << "   (최대 게임 수에 도달해 " << active.size() << "개 후보의 신뢰구간이 아직 겹침)\n";
+    }
+    for (const auto& c : candidates) {
+        if (c.isStandard(players) && !c.active) {
+            cout << "     ";
+            printCandidate(c, players, z);
+        }
+    }
+    cout << "진행 게임: " << played << " (모든 후보를 " << config.maxGames << "게임씩 진행하면 "
+        << config.maxGames * candidates.size() << ")";
+    if (droppedCount) cout << ", 탈락 후보 평균 " << droppedGames / droppedCount << "게임";
+    cout << ", " << fixed << setprecision(2) << seconds << "초\n\n";
+    cout.unsetf(ios::fixed);
+}
+
+int runTuneCommand(int argc, char* argv[])
+{ // 사용법: napoly tune [--players N] [--seed S] [--threads N] [--round N] [--max-games N] [--top K] [--confidence C] [--scalar]
+    TuneConfig config;
+    config.seed = RngService::entropySeed();
+    bool valid = true;
+
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--players" && i + 1 < argc) {
+            config.minPlayers = config.maxPlayers = atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], nullptr, 0);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+            if (config.threads == 0) config.threads = static_cast<int>(thread::hardware_concurrency());
+        }
+        else if (arg == "--round" && i + 1 < argc) {
+            config.firstRound = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--max-games" && i + 1 < argc) {
+            config.maxGames = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--top" && i + 1 < argc) {
+            config.top = atoi(argv[++i]);
+        }
+        else if (arg == "--confidence" && i + 1 < argc) {
+            config.confidence = atof(argv[++i]);
+        }
+        else if (arg == "--scalar") {
+            config.scalar = true;
+        }
+        else {
+            valid = false;
+        }
+    }
+
+    // 일괄 엔진은 좌석을 1바이트 비트마스크로 다루므로 8인까지
+    if (!valid || config.minPlayers < 4 || config.maxPlayers > 8 || config.firstRound == 0 ||
+        config.maxGames < config.firstRound || config.maxGames > 0x7FFFFFFF || config.top < 1 ||
+        config.confidence <= 0 || config.confidence >= 1) {
+        cout << "사용법: napoly tune [--players 4-8] [--seed S] [--threads N] [--round N] [--max-games N] [--top K] [--confidence 0-1] [--scalar]\n";
+        return 1;
+    }
+
+    rngService.reseed(config.seed);
+    cout << "균형 조정: 시드 " << config.seed << ", 첫 라운드 " << config.firstRound << "게임, 후보당 최대 "
+        << config.maxGames << "게임, " << (config.scalar ? "runSimulatedGame" : batchkernel::backendName())
+        << ", " << max(1, config.threads) << " 스레드\n\n";
+    for (int players = config.minPlayers; players <= config.maxPlayers; players++) {
+        tuneLobby(config, players);
+    }
+    return 0;
+}
+
+#endif // TUNER_H
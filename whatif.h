@@ -0,0 +1,397 @@
+// whatif.h
+#ifndef WHATIF_H
+#define WHATIF_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nightcheck.h"
+#include "simulation.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// 가정 분석(what-if): 밤이 시작되는 게임 상태 하나에서 마피아 대상 x 의사 치료 x 늑대인간 대상의 모든 조합(각각 사용 안 함 포함)을
+// 실제 규칙 함수(submitNightAction, processActions, resolveDay, resolveFinalVote, 승리 판정의 evaluateVictory)로 진행하고,
+// 조합마다 누가 죽는지, 낮에 누구를 처형하면(또는 처형 없이 넘어가면) 승패가 어떻게 되는지를 표로 모음
+// 경찰 조사와 사립 탐정 추적은 사망과 승패를 바꾸지 않으므로 조합에 넣지 않음
+// 조합은 스레드들이 묶음으로 나눠 맡고, 스레드마다 자기 게임 상태(thread_local)에 체크포인트를 되살려 진행
+
+const uint8_t WHATIF_NOT_CANDIDATE = 0xFF;
+
+struct WhatIfRow
+{ // 밤 행동 조합 하나의 결과 (승패: 0 진행, 1 시민 승리, 2 마피아 승리)
+    int8_t target[CHECKPOINT_MAX_SEATS];    // 좌석별 밤 대상 (-1: 사용 안 함)
+    uint8_t dies = 0;                       // 이번 밤 사망 좌석
+    uint8_t defended = 0;                   // 방탄복으로 버틴 좌석
+    bool tamed = false;                     // 밤이 끝난 뒤 접선 여부
+    uint8_t nightWinner = 0;                // 밤 직후 승리 판정 (승패가 나면 낮이 오지 않음)
+    uint8_t spared = 0;                     // 처형 없이 낮을 넘겼을 때
+    uint8_t executed[CHECKPOINT_MAX_SEATS]; // 좌석별 처형했을 때 (WHATIF_NOT_CANDIDATE: 낮에 살아있지 않음)
+};
+
+class WhatIfOracle
+{
+private:
+    GameCheckpoint base;
+    NightCase night;        // 좌석, 직업, 생사, 접선, 방탄복 (대상은 조합마다 채움)
+    vector<int> aliveSeats; // 밤 대상 후보 (좌석 순서)
+    vector<int> actors;     // 조합 축: 살아있는 마지막 마피아(팀 대표), 의사, 늑대인간
+    vector<WhatIfRow> table;
+
+    static uint8_t winnerCode(Winner winner)
+    {
+        return static_cast<uint8_t>(winner == Winner::Citizen ? 1 : winner == Winner::Mafia ? 2 : 0);
+    }
+
+    void restoreNight() const
+    { // 이 스레드의 게임 상태를 분석할 밤의 시작으로 (투표 직후 체크포인트면 다음 날 밤)
+        restoreCheckpoint(base);
+        if (base.phase == CHECKPOINT_VOTED) currentDay++;
+        beginNight();
+    }
+
+    WhatIfRow evaluate(uint64_t index) const
+    { // 조합 번호 = 행동 좌석별 선택(0: 사용 안 함, k: k번째 생존 좌석)의 혼합 기수 표기
+        WhatIfRow row;
+        fill(row.target, row.target + CHECKPOINT_MAX_SEATS, -1);
+        fill(row.executed, row.executed + CHECKPOINT_MAX_SEATS, WHATIF_NOT_CANDIDATE);
+        uint64_t radix = aliveSeats.size() + 1;
+        for (int actor : actors) {
+            uint64_t pick = index % radix;
+            index /= radix;
+            if (pick) row.target[actor] = static_cast<int8_t>(aliveSeats[pick - 1]);
+        }
+        NightCase c = night;
+        copy(row.target, row.target + CHECKPOINT_MAX_SEATS, c.target);
+        int mafiaSeat = actors.empty() || roleRegistry[c.roles[actors[0]]].night != NIGHT_KILL ? -1 : actors[0];
+        for (int seat = 0; seat < c.seats && mafiaSeat >= 0; seat++) { // 앞선 마피아는 같은 대상을 골랐다가 교체됨
+            if (seat != mafiaSeat && ((c.alive >> seat) & 1) && roleRegistry[c.roles[seat]].night == NIGHT_KILL) c.target[seat] = c.target[mafiaSeat];
+        }
+
+        GameArenaScope arena;
+        restoreNight();
+        submitNightCase(c);
+        row.dies = static_cast<uint8_t>(nightManager.pendingDeathSeats());
+        row.defended = static_cast<uint8_t>(nightManager.defendedSeatMask());
+        row.tamed = werewolfTamed;
+        row.nightWinner = row.spared = winnerCode(evaluateVictory());
+        if (row.nightWinner) return row;
+
+        resolveDay();
+        nightManager.clear();
+        row.spared = winnerCode(evaluateVictory());
+        const vector<shared_ptr<Player>> candidates = roster.aliveRoster();
+        for (const shared_ptr<Player>& candidate : candidates) {
+            resolveFinalVote(candidate, 1, 0);
+            row.executed[seatOf(candidate)] = winnerCode(evaluateVictory());
+            candidate->setAlive(true); // 다음 후보를 위해 되살림 (생존자 캐시도 같이 되돌아감)
+        }
+        return row;
+    }
+
+public:
+    bool load(const GameCheckpoint& state, string& error)
+    { // 밤이 시작되는 체크포인트(배정 직후 또는 투표 직후)만 받음
+        if (state.phase != CHECKPOINT_DEALT && state.phase != CHECKPOINT_VOTED) {
+            error = "밤이 시작되는 체크포인트(배정 직후 또는 투표 직후)가 아닙니다";
+            return false;
+        }
+        if (state.seats == 0 || state.seats > CHECKPOINT_MAX_SEATS) {
+            error = "좌석 수가 맞지 않습니다";
+            return false;
+        }
+        int werewolves = 0, mafias = 0;
+        for (int seat = 0; seat < state.seats; seat++) {
+            if (state.roles[seat] >= roleRegistry.size()) {
+                error = "알 수 없는 직업 번호가 있습니다";
+                return false;
+            }
+            RoleTeam team = roleRegistry[state.roles[seat]].team;
+            werewolves += team == TEAM_WEREWOLF;
+            mafias += team == TEAM_MAFIA;
+        }
+        if (werewolves > 1 || mafias == 0) { // 배정 규칙상 나올 수 없는 조합 (손상되었거나 다른 형식의 파일)
+            error = "직업 배정이 올바르지 않습니다";
+            return false;
+        }
+        base = state;
+        night = NightCase();
+        night.seats = state.seats;
+        copy(state.roles, state.roles + state.seats, night.roles);
+        night.alive = state.alive;
+        night.tamed = state.tamed != 0;
+        night.armor = state.armor;
+
+        aliveSeats.clear();
+        actors.clear();
+        int mafiaSeat = -1;
+        vector<int> others;
+        for (int seat = 0; seat < state.seats; seat++) {
+            if (!((state.alive >> seat) & 1)) continue;
+            aliveSeats.push_back(seat);
+            NightKind kind = roleRegistry[state.roles[seat]].night;
+            if (kind == NIGHT_KILL) mafiaSeat = seat;
+            else if (kind == NIGHT_HEAL || kind == NIGHT_HUNT) others.push_back(seat);
+        }
+        if (mafiaSeat >= 0) actors.push_back(mafiaSeat);
+        actors.insert(actors.end(), others.begin(), others.end());
+
+        bool saved = muteGameOutput;
+        muteGameOutput = true;
+        Winner winner;
+        {
+            GameArenaScope arena;
+            restoreNight();
+            winner = evaluateVictory();
+        }
+        muteGameOutput = saved;
+        if (winner != Winner::None) {
+            error = "이미 승패가 정해진 상태입니다";
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t combinations() const
+    {
+        uint64_t count = 1;
+        for (size_t i = 0; i < actors.size(); i++) count *= aliveSeats.size() + 1;
+        return count;
+    }
+
+    int run(int threads)
+    { // 조합을 16개 묶음으로 나눠 threads개 스레드에서 진행 (1이면 호출 스레드에서), 실제로 쓴 스레드 수 반환
+        const uint64_t CHUNK = 16;
+        uint64_t total = combinations();
+        table.assign(total, WhatIfRow());
+        atomic<uint64_t> next(0);
+        auto worker = [this, total, &next]() {
+            bool saved = muteGameOutput;
+            muteGameOutput = true;
+            while (true) {
+                uint64_t first = next.fetch_add(CHUNK);
+                if (first >= total) break;
+                for (uint64_t index = first; index < min(first + CHUNK, total); index++) table[index] = evaluate(index);
+            }
+            muteGameOutput = saved;
+        };
+
+        threads = static_cast<int>(min<uint64_t>(max(1, threads), (total + CHUNK - 1) / CHUNK));
+        if (threads <= 1) {
+            worker();
+            return 1;
+        }
+        vector<thread> workers;
+        for (int t = 0; t < threads; t++) workers.emplace_back(worker);
+        for (auto& t : workers) t.join();
+        return threads;
+    }
+
+    const GameCheckpoint& state() const { return base; }
+    const vector<int>& actorSeats() const { return actors; }
+    const vector<WhatIfRow>& rows() const { return table; }
+    int nightDay() const { return base.day + (base.phase == CHECKPOINT_VOTED ? 1 : 0); }
+};
+
+bool simulatedWhatIfState(uint64_t gameId, int playerCount, int day, GameCheckpoint& state)
+{ // 봇 게임(입력은 simulate와 같은 게임 번호별 난수)을 day번째 밤 직전까지 진행한 상태, 그 전에 끝나면 false
+    playlist.clear();
+    for (int i = 0; i < playerCount; i++) playlist.push_back("P" + to_string(i + 1));
+    bool saved = muteGameOutput;
+    muteGameOutput = true;
+    GameArenaScope arena;
+    beginGame(nullptr, gameId);
+    GameRng gen = rngService.stream(gameId, RNG_STREAM_DECISION);
+    CheckpointPhase phase = CHECKPOINT_DEALT;
+    bool ongoing = true;
+    while (currentDay < day) {
+        beginNight();
+        botNightInput(gen);
+        nightManager.processActions();
+        if (evaluateVictory() != Winner::None) {
+            ongoing = false;
+            break;
+        }
+        resolveDay();
+        nightManager.clear();
+        botVoting(gen);
+        if (evaluateVictory() != Winner::None) {
+            ongoing = false;
+            break;
+        }
+        if (currentDay + 1 == day) {
+            phase = CHECKPOINT_VOTED;
+            break;
+        }
+        currentDay++;
+    }
+    if (ongoing) state = captureCheckpoint(phase);
+    muteGameOutput = saved;
+    return ongoing;
+}
+
+string whatIfSeats(uint8_t mask)
+{ // 좌석 비트를 1부터 센 번호 목록으로
+    string text;
+    for (int seat = 0; seat < CHECKPOINT_MAX_SEATS; seat++) {
+        if (!((mask >> seat) & 1)) continue;
+        if (!text.empty()) text += ",";
+        text += to_string(seat + 1);
+    }
+    return text.empty() ? "-" : text;
+}
+
+string whatIfVerdicts(const WhatIfRow& row, int seats)
+{ // 처형 없음, 1번 ... seats번 처형 순서의 승패 (. 계속, C 시민 승리, M 마피아 승리, - 처형 대상 아님)
+    static const char marks[] = ".CM";
+    string text(1, marks[row.spared]);
+    for (int seat = 0; seat < seats; seat++) {
+        text += ' ';
+        text += row.executed[seat] == WHATIF_NOT_CANDIDATE ? '-' : marks[row.executed[seat]];
+    }
+    return text;
+}
+
+void printWhatIfTable(ostream& out, const WhatIfOracle& oracle, bool all)
+{ // 같은 결과(사망, 방어, 접선, 승패)끼리 묶은 표, all이면 조합마다 한 줄
+    const GameCheckpoint& state = oracle.state();
+    const vector<WhatIfRow>& rows = oracle.rows();
+    out << "좌석:";
+    for (int seat = 0; seat < state.seats; seat++) {
+        out << " " << seat + 1 << "." << state.names[seat] << "(" << roleTypeName(state.roles[seat])
+            << ((state.alive >> seat) & 1 ? "" : ", 사망") << ")";
+    }
+    out << "\n조합 축:";
+    for (int seat : oracle.actorSeats()) out << " " << roleTypeName(state.roles[seat]) << "(" << seat + 1 << "번)";
+    if (oracle.actorSeats().empty()) out << " 없음";
+    out << ", 각각 사용 안 함 포함\n";
+    out << "승패 열: 처형 없음, 1~" << int(state.seats) << "번 처형 (. 계속, C 시민 승리, M 마피아 승리, - 처형 대상 아님)\n";
+
+    auto describeChoice = [&](const WhatIfRow& row) {
+        string text;
+        for (int seat : oracle.actorSeats()) {
+            if (!text.empty()) text += " ";
+            text += roleTypeName(state.roles[seat]);
+            text += "->";
+            text += row.target[seat] < 0 ? "-" : to_string(row.target[seat] + 1);
+        }
+        return text;
+    };
+
+    if (all) {
+        for (const WhatIfRow& row : rows) {
+            out << "  " << describeChoice(row) << " | 사망 " << whatIfSeats(row.dies) << " | 방어 " << whatIfSeats(row.defended)
+                << " | 접선 " << (row.tamed ? "예" : "-") << " | 승패 " << whatIfVerdicts(row, state.seats) << "\n";
+        }
+        return;
+    }
+
+    struct Group { uint64_t count = 0; size_t first = 0; };
+    map<string, Group> groups; // 결과 바이트열 -> 조합 수와 첫 조합
+    for (size_t i = 0; i < rows.size(); i++) {
+        const WhatIfRow& row = rows[i];
+        string key = { static_cast<char>(row.dies), static_cast<char>(row.defended), static_cast<char>(row.tamed),
+            static_cast<char>(row.nightWinner), static_cast<char>(row.spared) };
+        key.append(reinterpret_cast<const char*>(row.executed), CHECKPOINT_MAX_SEATS);
+        Group& group = groups[key];
+        if (group.count++ == 0) group.first = i;
+    }
+    vector<const Group*> order;
+    for (const auto& entry : groups) order.push_back(&entry.second);
+    stable_sort(order.begin(), order.end(), [](const Group* a, const Group* b) { return a->count > b->count; });
+
+    out << "결과 유형 " << order.size() << "가지 (조합 수가 많은 순)\n";
+    out << "    조합  사망    방어    접선  승패" << string(2 * state.seats, ' ') << "예\n";
+    for (const Group* group : order) {
+        const WhatIfRow& row = rows[group->first];
+        out << "  " << setw(6) << group->count << "  " << left << setw(8) << whatIfSeats(row.dies) << setw(8)
+            << whatIfSeats(row.defended) << right << (row.tamed ? "예" : "- ") << "    " << whatIfVerdicts(row, state.seats)
+            << "  " << describeChoice(row) << "\n";
+    }
+}
+
+int runWhatIfCommand(int argc, char* argv[])
+{ // 사용법: napoly whatif 체크포인트파일 게임번호 [--threads N] [--all]
+  //        napoly whatif --seed S --game N [--day D] [--players 6~8] [--threads N] [--all]
+    string path;
+    uint64_t gameId = 0;
+    uint64_t seed = 0;
+    bool simulated = false;
+    int day = 1;
+    int playerCount = 8;
+    int threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    bool all = false;
+    bool valid = true;
+    int argi = 2;
+    if (argc > 3 && argv[2][0] != '-') {
+        path = argv[argi++];
+        gameId = strtoull(argv[argi++], nullptr, 10);
+    }
+    for (int i = argi; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+            simulated = true;
+        }
+        else if (arg == "--game" && i + 1 < argc) gameId = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--day" && i + 1 < argc) day = atoi(argv[++i]);
+        else if (arg == "--players" && i + 1 < argc) playerCount = atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (arg == "--all") all = true;
+        else valid = false;
+    }
+    if (!valid || gameId == 0 || path.empty() == !simulated || day < 1 || playerCount < 6 || playerCount > 8 || threads <= 0) {
+        cout << "사용법: napoly whatif 체크포인트파일 게임번호 [--threads N] [--all]\n";
+        cout << "        napoly whatif --seed S --game N [--day D] [--players 6~8] [--threads N] [--all]\n";
+        return 1;
+    }
+
+    GameCheckpoint state;
+    bool found = false;
+    if (simulated) {
+        rngService.reseed(seed);
+        found = simulatedWhatIfState(gameId, playerCount, day, state);
+        if (!found) {
+            cout << "게임 #" << gameId << "은 " << day << "번째 밤 전에 끝났습니다.\n";
+            return 1;
+        }
+    }
+    else {
+        CheckpointLog::readCheckpointFile(path, [&](const GameCheckpoint& record) {
+            if (record.gameId != gameId) return;
+            state = record;
+            found = true;
+        });
+        if (!found) {
+            cout << path << "에 게임 #" << gameId << "의 체크포인트가 없습니다.\n";
+            return 1;
+        }
+    }
+
+    WhatIfOracle oracle;
+    string error;
+    if (!oracle.load(state, error)) {
+        cout << "게임 #" << gameId << ": " << error << "\n";
+        return 1;
+    }
+    auto begin = steady_clock::now();
+    threads = oracle.run(threads);
+    double milliseconds = duration<double, milli>(steady_clock::now() - begin).count();
+
+    cout << "=== 가정 분석: 게임 #" << gameId << ", " << oracle.nightDay() << "번째 밤 (생존 " << __builtin_popcount(state.alive)
+        << "명, 밤 행동 조합 " << oracle.combinations() << "개, 스레드 " << threads << "개, " << fixed << setprecision(2)
+        << milliseconds << "ms) ===\n";
+    cout.unsetf(ios::fixed);
+    printWhatIfTable(cout, oracle, all);
+    releaseGameState();
+    return 0;
+}
+
+#endif // WHATIF_H